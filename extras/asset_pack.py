@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+"""Build the asset pack for the "assets" flash partition (src/asset_pack_format.h).
+
+    asset_pack.py                                  # extras/assets.json -> assets.bin
+    asset_pack.py --manifest my.json --out my.bin
+    asset_pack.py --list assets.bin                # what a pack holds, with CRC check
+    asset_pack.py --flash /dev/ttyACM0             # build, then write it with esptool
+
+Fonts come from lv_font_conv C files (optionally subset, requantized or
+compressed as in font_subset.py), images from LVGL C image arrays. The pack
+is used in place from flash, so asset changes only need this partition
+rewritten, not a firmware rebuild.
+
+Manifest: {"partitions": "partitions_16MB_assets.csv", "assets": [
+  {"name": "Euro60", "font": "src/ui_font_Euro60.c", "chars": "0123456789-", "compress": true},
+  {"name": "settings", "image": "src/ui_img_settings_png.c"}]}
+"""
+import argparse
+import csv
+import json
+import os
+import re
+import struct
+import subprocess
+import sys
+import zlib
+
+import font_subset
+
+PACK_MAGIC = 0x4B505341
+PACK_VERSION = 1
+ALIGN = 4
+NAME_LEN = 24
+PARTITION = "assets"
+
+ASSET_FONT = 1
+ASSET_IMAGE = 2
+
+HEADER = struct.Struct("<IHHII")
+ENTRY = struct.Struct("<24sB3xIII8s")
+IMAGE_PARAMS = struct.Struct("<HHHBx")
+FONT_PARAMS = struct.Struct("<HhbBBB")
+FONT_HEADER = struct.Struct("<HHHHIIIII")
+FONT_CMAP = struct.Struct("<IHHHBxII")
+GLYPH_DSC = struct.Struct("<IBBbb")
+
+CMAP_FORMAT0_TINY = 2
+CMAP_SPARSE_TINY = 3
+
+# lv_color_format_t, with NATIVE resolved for LV_COLOR_DEPTH 16
+COLOR_FORMATS = {
+    "LV_COLOR_FORMAT_L8": 0x06, "LV_COLOR_FORMAT_A8": 0x0E, "LV_COLOR_FORMAT_RGB565": 0x12,
+    "LV_COLOR_FORMAT_RGB565A8": 0x14, "LV_COLOR_FORMAT_RGB888": 0x0F,
+    "LV_COLOR_FORMAT_ARGB8888": 0x10, "LV_COLOR_FORMAT_XRGB8888": 0x11,
+    "LV_COLOR_FORMAT_NATIVE": 0x12, "LV_COLOR_FORMAT_NATIVE_WITH_ALPHA": 0x14,
+}
+
+
+class PackError(Exception):
+    pass
+
+
+def pad(data):
+    return data + b"\0" * (-len(data) % ALIGN)
+
+
+def font_blob(path, chars=None, bpp=None, compress=False, kerning=True):
+    font = font_subset.Font(path)
+    if chars is None:
+        chars = "".join(chr(cp) for cp in sorted(font.glyphs))
+    sub = font_subset.Subset(font, chars, bpp, compress, kerning)
+    if len(sub.cps) > 255 and sub.kern:
+        sub.kern = []   # uint8_t kern pair ids only
+
+    dsc = GLYPH_DSC.pack(0, 0, 0, 0, 0)
+    for index, adv, w, h, ox, oy, _ in sub.dsc:
+        if index >= 1 << 20 or adv >= 1 << 12:
+            raise PackError("%s: glyph too large for LV_FONT_FMT_TXT_LARGE 0" % font.name)
+        dsc += GLYPH_DSC.pack(index | adv << 20, w, h, ox, oy)
+
+    ulist = b""
+    start = sub.cps[0]
+    if not sub.contiguous:
+        ulist = pad(struct.pack("<%dH" % len(sub.cps), *[cp - start for cp in sub.cps]))
+    kern_ids = pad(bytes(v for l, r, _ in sub.kern for v in (l, r)))
+    kern_values = pad(struct.pack("<%db" % len(sub.kern), *[v for _, _, v in sub.kern]))
+
+    # header | glyph_dsc | cmap | unicode list | kern ids | kern values | bitmap
+    o_dsc = FONT_HEADER.size + (-FONT_HEADER.size % ALIGN)
+    o_cmap = o_dsc + len(dsc)
+    o_ulist = o_cmap + FONT_CMAP.size
+    o_kids = o_ulist + len(ulist)
+    o_kvals = o_kids + len(kern_ids)
+    o_bitmap = o_kvals + len(kern_values)
+    if sub.contiguous:
+        cmap = FONT_CMAP.pack(start, len(sub.cps), 1, 0, CMAP_FORMAT0_TINY, 0, 0)
+    else:
+        cmap = FONT_CMAP.pack(start, sub.cps[-1] - start + 1, 1, len(sub.cps), CMAP_SPARSE_TINY, o_ulist, 0)
+    header = FONT_HEADER.pack(len(sub.dsc) + 1, 1, font.kern_scale, len(sub.kern),
+                              o_dsc, o_bitmap, o_cmap,
+                              o_kids if sub.kern else 0, o_kvals if sub.kern else 0)
+    blob = pad(header) + dsc + cmap + ulist + kern_ids + kern_values + bytes(sub.bitmap)
+    params = FONT_PARAMS.pack(font.line_height, font.base_line, font.underline_position,
+                              font.underline_thickness, sub.bpp,
+                              font_subset.FMT_COMPRESSED if compress else font_subset.FMT_PLAIN)
+    return blob, params, "%s, %d glyphs, %d bpp%s" % (font.name, len(sub.cps), sub.bpp, " rle" if compress else "")
+
+
+def image_blob(path):
+    with open(path, encoding="utf-8") as f:
+        text = font_subset.strip_comments(f.read())
+    m = re.search(r"(\w+)_data\[\]\s*=\s*\{(.*?)\};", text, re.S)
+    if not m:
+        raise PackError("%s: no image data array" % path)
+    data = bytes(font_subset.int_list(m.group(2)))
+
+    def header_field(name, default=None):
+        hm = re.search(r"\.header\." + name + r"\s*=\s*(\w+)", text)
+        if not hm:
+            if default is None:
+                raise PackError("%s: no .header.%s" % (path, name))
+            return default
+        return hm.group(1)
+
+    w, h = int(header_field("w"), 0), int(header_field("h"), 0)
+    cf_name = header_field("cf")
+    if cf_name not in COLOR_FORMATS:
+        raise PackError("%s: unsupported color format %s" % (path, cf_name))
+    stride = int(header_field("stride", "0"), 0)
+    return data, IMAGE_PARAMS.pack(w, h, stride, COLOR_FORMATS[cf_name]), "%dx%d %s" % (w, h, cf_name[16:])
+
+
+def build(manifest, root):
+    blobs = []
+    for a in manifest["assets"]:
+        name = a["name"]
+        if len(name.encode()) >= NAME_LEN:
+            raise PackError("name too long: " + name)
+        if "font" in a:
+            blob, params, what = font_blob(os.path.join(root, a["font"]), a.get("chars"), a.get("bpp"),
+                                           a.get("compress", False), a.get("kerning", True))
+            blobs.append((name, ASSET_FONT, blob, params, what))
+        elif "image" in a:
+            blob, params, what = image_blob(os.path.join(root, a["image"]))
+            blobs.append((name, ASSET_IMAGE, blob, params, what))
+        else:
+            raise PackError("%s: neither font nor image" % name)
+
+    ofs = HEADER.size + ENTRY.size * len(blobs)
+    ofs += -ofs % ALIGN
+    table, body = b"", b""
+    for name, kind, blob, params, _ in blobs:
+        table += ENTRY.pack(name.encode(), kind, ofs + len(body), len(blob), zlib.crc32(blob), params)
+        body += pad(blob)
+    head_pad = b"\0" * (-(HEADER.size + len(table)) % ALIGN)
+    total = HEADER.size + len(table) + len(head_pad) + len(body)
+    pack = HEADER.pack(PACK_MAGIC, PACK_VERSION, len(blobs), total, zlib.crc32(table)) + table + head_pad + body
+    return pack, blobs
+
+
+def list_pack(data):
+    magic, version, count, total, crc = HEADER.unpack_from(data, 0)
+    if magic != PACK_MAGIC or version != PACK_VERSION:
+        raise PackError("not an asset pack (v%d)" % PACK_VERSION)
+    table = data[HEADER.size:HEADER.size + ENTRY.size * count]
+    ok = zlib.crc32(table) == crc and total <= len(data)
+    print("%d bytes, %d entries, table %s" % (total, count, "ok" if ok else "BAD"))
+    for i in range(count):
+        name, kind, ofs, size, bcrc, params = ENTRY.unpack_from(table, i * ENTRY.size)
+        good = zlib.crc32(data[ofs:ofs + size]) == bcrc
+        if kind == ASSET_IMAGE:
+            w, h, stride, cf = IMAGE_PARAMS.unpack(params)
+            what = "image %dx%d cf 0x%02x" % (w, h, cf)
+        else:
+            lh, bl, _, _, bpp, fmt = FONT_PARAMS.unpack(params)
+            what = "font line %d, %d bpp%s" % (lh, bpp, " rle" if fmt else "")
+        print("  %-24s %-28s @0x%06x %7d bytes %s" % (name.rstrip(b"\0").decode(), what, ofs, size,
+                                                       "ok" if good else "BAD CRC"))
+        ok = ok and good
+    return ok
+
+
+def partition_offset(csv_path):
+    with open(csv_path, encoding="utf-8") as f:
+        for row in csv.reader(line for line in f if not line.lstrip().startswith("#")):
+            row = [c.strip() for c in row]
+            if row and row[0] == PARTITION:
+                return int(row[3], 0), int(row[4], 0)
+    raise PackError("%s has no %s partition" % (csv_path, PARTITION))
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    root = os.path.dirname(here)
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("--manifest", default=os.path.join(here, "assets.json"))
+    ap.add_argument("--out", default=os.path.join(root, "assets.bin"))
+    ap.add_argument("--list", metavar="PACK", help="show the contents of a pack")
+    ap.add_argument("--flash", metavar="PORT", help="write the pack to the assets partition with esptool")
+    args = ap.parse_args()
+
+    try:
+        if args.list:
+            with open(args.list, "rb") as f:
+                return 0 if list_pack(f.read()) else 1
+        with open(args.manifest, encoding="utf-8") as f:
+            manifest = json.load(f)
+        pack, blobs = build(manifest, root)
+        offset, size = partition_offset(os.path.join(root, manifest.get("partitions", "partitions_16MB_assets.csv")))
+        for name, kind, blob, _, what in blobs:
+            print("  %-24s %7d bytes  %s" % (name, len(blob), what))
+        print("%s: %d bytes of the %d byte partition at 0x%x" % (args.out, len(pack), size, offset))
+        if len(pack) > size:
+            raise PackError("pack does not fit the partition")
+        with open(args.out, "wb") as f:
+            f.write(pack)
+        if args.flash:
+            return subprocess.call([sys.executable, "-m", "esptool", "--chip", "esp32s3", "--port", args.flash,
+                                    "write_flash", "0x%x" % offset, args.out])
+    except (PackError, font_subset.FontError, OSError, KeyError, ValueError) as e:
+        print("asset_pack: %s" % e, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,507 @@
+#!/usr/bin/env python3
+"""Subset the lv_font_conv fonts in src/ to the characters the UI draws.
+
+    font_subset.py                             # all fonts in extras/fonts.json
+    font_subset.py --manifest my.json --check  # report only, write nothing
+    font_subset.py --src src/ui_font_Euro60.c --chars 0123456789- --bpp 2 --out x.c
+
+Reads the C files lv_font_conv generated (plain bitmaps, kern pairs) and
+writes a font with only the manifest's characters, optionally requantized to
+fewer bpp and/or RLE-compressed the way lv_font_fmt_txt.c decodes it
+(LV_USE_FONT_COMPRESSED). Line height and baseline are kept, so labels don't
+move. Each output is guarded by the source font's UI_FONT_* macro inverted:
+build with -D UI_FONT_EURO60=0 to link the subset instead of the original
+(extras/font_subset_pio.py does that for PlatformIO builds).
+
+Manifest: {"out_dir": "src/fonts_subset", "fonts": [{"src": "src/ui_font_Euro60.c",
+"chars": "0123456789- ", "bpp": 4, "compress": true, "kerning": true}, ...]}
+"""
+import argparse
+import json
+import os
+import re
+import sys
+
+GLYPH_DSC_BYTES = 8     # lv_font_fmt_txt_glyph_dsc_t: 20 + 12 bit fields, 4 bytes
+CMAP_BYTES = 20         # lv_font_fmt_txt_cmap_t on a 32-bit target
+KERN_DSC_BYTES = 16     # lv_font_fmt_txt_kern_pair_t
+
+FMT_PLAIN = 0
+FMT_COMPRESSED = 1              # RLE, each line XORed with the one above
+FMT_COMPRESSED_NO_PREFILTER = 2
+
+GLYPH_RE = re.compile(r"\{\.bitmap_index = (\d+), \.adv_w = (\d+), \.box_w = (\d+), \.box_h = (\d+), "
+                      r"\.ofs_x = (-?\d+), \.ofs_y = (-?\d+)\}")
+
+
+class FontError(Exception):
+    pass
+
+
+def strip_comments(text):
+    return re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+
+
+def array_body(text, name):
+    m = re.search(r"\b" + name + r"\[\]\s*=\s*\{(.*?)\};", text, re.S)
+    return m.group(1) if m else None
+
+
+def int_list(body):
+    return [int(v, 0) for v in re.findall(r"-?(?:0x[0-9a-fA-F]+|\d+)", body)]
+
+
+def field(text, name, default=None):
+    m = re.search(r"\." + name + r"\s*=\s*(-?\w+)", text)
+    if not m:
+        if default is None:
+            raise FontError("no ." + name)
+        return default
+    return m.group(1)
+
+
+class Font:
+    """One lv_font_conv output file, with the glyphs keyed by code point."""
+
+    def __init__(self, path):
+        with open(path, encoding="utf-8") as f:
+            raw = f.read()
+        self.path = path
+        text = strip_comments(raw)
+
+        m = re.search(r"#ifndef (UI_FONT_\w+)", text)
+        self.guard = m.group(1) if m else None
+        m = re.search(r"lv_font_t (\w+) = \{", text)
+        if not m:
+            raise FontError("no lv_font_t definition")
+        self.name = m.group(1)
+        m = re.search(r"^ \* Size: (\d+) px", raw, re.M)
+        self.size_px = int(m.group(1)) if m else 0
+
+        self.bpp = int(field(text, "bpp"))
+        if int(field(text, "bitmap_format")) != FMT_PLAIN:
+            raise FontError("source bitmaps must be plain (--no-compress)")
+        if int(field(text, "kern_classes")) != 0:
+            raise FontError("kern classes are not supported, only kern pairs")
+        self.kern_scale = int(field(text, "kern_scale"))
+        self.line_height = int(field(text, "line_height"))
+        self.base_line = int(field(text, "base_line"))
+        self.subpx = field(text, "subpx", "LV_FONT_SUBPX_NONE")
+        self.underline_position = int(field(text, "underline_position", "0"))
+        self.underline_thickness = int(field(text, "underline_thickness", "0"))
+
+        bitmap = bytes(int_list(array_body(text, "glyph_bitmap")))
+        glyphs = [tuple(int(v) for v in g) for g in GLYPH_RE.findall(text)]
+        if len(glyphs) < 2:
+            raise FontError("no glyph descriptors")
+
+        # glyph id -> code point
+        self.cp_of = {}
+        cmaps = array_body(text, "cmaps")
+        for cm in re.findall(r"\{(.*?)\}", cmaps, re.S):
+            start = int(field(cm, "range_start"))
+            length = int(field(cm, "range_length"))
+            gid = int(field(cm, "glyph_id_start"))
+            kind = field(cm, "type")
+            if kind == "LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY":
+                for i in range(length):
+                    self.cp_of[gid + i] = start + i
+            elif kind == "LV_FONT_FMT_TXT_CMAP_SPARSE_TINY":
+                ulist = field(cm, "unicode_list")
+                for i, ofs in enumerate(int_list(array_body(text, ulist))):
+                    self.cp_of[gid + i] = start + ofs
+            else:
+                raise FontError("unsupported cmap type " + kind)
+
+        # code point -> (adv_w, box_w, box_h, ofs_x, ofs_y, unpacked pixels)
+        self.glyphs = {}
+        for gid, (index, adv, w, h, ox, oy) in enumerate(glyphs):
+            if gid == 0 or gid not in self.cp_of:
+                continue
+            nbytes = (w * h * self.bpp + 7) // 8
+            px = unpack(bitmap[index:index + nbytes], w * h, self.bpp)
+            self.glyphs[self.cp_of[gid]] = (adv, w, h, ox, oy, px)
+
+        # (left cp, right cp) -> value
+        self.kern = {}
+        ids = array_body(text, "kern_pair_glyph_ids")
+        if ids is not None:
+            ids = int_list(ids)
+            values = int_list(array_body(text, "kern_pair_values"))
+            for i, v in enumerate(values):
+                left, right = self.cp_of.get(ids[2 * i]), self.cp_of.get(ids[2 * i + 1])
+                if left is not None and right is not None:
+                    self.kern[(left, right)] = v
+
+        self.flash_bytes = (len(bitmap) + len(glyphs) * GLYPH_DSC_BYTES + CMAP_BYTES +
+                            (KERN_DSC_BYTES + 3 * len(ids) // 2 if ids else 0))
+
+
+# --- bitmaps --------------------------------------------------------------
+
+def unpack(data, count, bpp):
+    mask = (1 << bpp) - 1
+    out = []
+    for i in range(count):
+        bit = i * bpp
+        out.append((data[bit >> 3] >> (8 - bpp - (bit & 7))) & mask)
+    return out
+
+
+def pack(values, bpp):
+    out = bytearray((len(values) * bpp + 7) // 8)
+    for i, v in enumerate(values):
+        bit = i * bpp
+        out[bit >> 3] |= v << (8 - bpp - (bit & 7))
+    return bytes(out)
+
+
+def requantize(px, from_bpp, to_bpp):
+    if from_bpp == to_bpp:
+        return px
+    src_max, dst_max = (1 << from_bpp) - 1, (1 << to_bpp) - 1
+    return [(v * dst_max + src_max // 2) // src_max for v in px]
+
+
+class BitWriter:
+    def __init__(self):
+        self.bits = []
+
+    def put(self, value, length):
+        for i in range(length - 1, -1, -1):
+            self.bits.append((value >> i) & 1)
+
+    def data(self):
+        out = bytearray((len(self.bits) + 7) // 8)
+        for i, b in enumerate(self.bits):
+            out[i >> 3] |= b << (7 - (i & 7))
+        return bytes(out)
+
+
+def prefilter(px, w):
+    return px[:w] + [px[i] ^ px[i - w] for i in range(w, len(px))]
+
+
+def rle_encode(values, bpp):
+    """Encode for rle_next() in lv_font_fmt_txt.c: literals, then after two
+    equal literals a 1 bit per repeat, and after 11 repeats a 6 bit counter."""
+    bw = BitWriter()
+    n = len(values)
+    if n == 0:
+        return b""
+    bw.put(values[0], bpp)
+    prev = values[0]
+    repeated = False
+    count = 0
+    i = 1
+    while i < n:
+        v = values[i]
+        if not repeated:
+            bw.put(v, bpp)
+            if v == prev:
+                repeated = True
+                count = 0
+            prev = v
+            i += 1
+        elif v != prev:
+            bw.put(0, 1)
+            bw.put(v, bpp)
+            prev = v
+            repeated = False
+            i += 1
+        else:
+            count += 1
+            bw.put(1, 1)
+            i += 1
+            if count == 11:
+                # The counter yields c - 1 more repeats, then a literal.
+                run = 0
+                while i + run < n and values[i + run] == prev and run < 62:
+                    run += 1
+                bw.put(run + 1, 6)
+                i += run
+                if i < n:
+                    bw.put(values[i], bpp)
+                    prev = values[i]
+                    i += 1
+                repeated = False
+    return bw.data()
+
+
+def rle_decode(data, count, bpp):
+    """Python twin of rle_next(), to check every encoded glyph."""
+    pos = 0
+
+    def bits(length):
+        nonlocal pos
+        v = 0
+        for _ in range(length):
+            v = (v << 1) | ((data[pos >> 3] >> (7 - (pos & 7))) & 1 if (pos >> 3) < len(data) else 0)
+            pos += 1
+        return v
+
+    out = []
+    state, prev, cnt = "single", 0, 0
+    for k in range(count):
+        if state == "single":
+            ret = bits(bpp)
+            if k != 0 and ret == prev:
+                cnt, state = 0, "repeated"
+            prev = ret
+        elif state == "repeated":
+            cnt += 1
+            if bits(1):
+                ret = prev
+                if cnt == 11:
+                    cnt = bits(6)
+                    if cnt:
+                        state = "counter"
+                    else:
+                        ret = prev = bits(bpp)
+                        state = "single"
+            else:
+                ret = prev = bits(bpp)
+                state = "single"
+        else:
+            ret = prev
+            cnt -= 1
+            if cnt == 0:
+                ret = prev = bits(bpp)
+                state = "single"
+        out.append(ret)
+    return out
+
+
+def unfilter(px, w):
+    out = list(px[:w])
+    for i in range(w, len(px)):
+        out.append(px[i] ^ out[i - w])
+    return out
+
+
+# --- subsetting -----------------------------------------------------------
+
+class Subset:
+    def __init__(self, font, chars, bpp=None, compress=False, kerning=True):
+        self.font = font
+        self.bpp = bpp or font.bpp
+        if self.bpp not in (1, 2, 4, 8) or self.bpp > font.bpp:
+            raise FontError("bpp %d: only 1, 2, 4 or 8 and at most the source's %d" % (self.bpp, font.bpp))
+        if compress and self.bpp not in (2, 4):
+            raise FontError("compressed fonts need 2 or 4 bpp")
+        self.compress = compress
+
+        cps = sorted(set(ord(c) for c in chars))
+        missing = [cp for cp in cps if cp not in font.glyphs]
+        if missing:
+            raise FontError("not in the font: " + " ".join("U+%04X" % cp for cp in missing))
+        if not cps or cps[-1] - cps[0] > 0xFFFF:
+            raise FontError("empty manifest entry or range over 64K")
+        self.cps = cps
+
+        self.bitmap = bytearray()
+        self.dsc = []
+        for cp in cps:
+            adv, w, h, ox, oy, px = font.glyphs[cp]
+            px = requantize(px, font.bpp, self.bpp)
+            if compress and w * h:
+                data = rle_encode(prefilter(px, w), self.bpp)
+                if unfilter(rle_decode(data, w * h, self.bpp), w) != px:
+                    raise FontError("RLE round trip failed for U+%04X" % cp)
+            else:
+                data = pack(px, self.bpp)
+            self.dsc.append((len(self.bitmap), adv, w, h, ox, oy, cp))
+            self.bitmap += data
+        if compress:
+            self.bitmap += b"\0"    # get_bits() may peek one byte past the last glyph
+
+        gid = {cp: i + 1 for i, cp in enumerate(cps)}
+        self.kern = []
+        if kerning:
+            self.kern = sorted((gid[l], gid[r], v) for (l, r), v in font.kern.items() if l in gid and r in gid)
+
+        self.contiguous = cps[-1] - cps[0] + 1 == len(cps)
+        self.flash_bytes = (len(self.bitmap) + (len(cps) + 1) * GLYPH_DSC_BYTES + CMAP_BYTES +
+                            (0 if self.contiguous else 2 * len(cps)) +
+                            (KERN_DSC_BYTES + 3 * len(self.kern) if self.kern else 0))
+
+    def render(self):
+        f = self.font
+        guard = f.guard or ("UI_FONT_" + f.name.upper())
+        fmt = FMT_COMPRESSED if self.compress else FMT_PLAIN
+        chars = "".join(chr(cp) for cp in self.cps)
+        o = []
+        o.append("/*******************************************************************************\n")
+        o.append(" * Size: %d px\n" % f.size_px)
+        o.append(" * Bpp: %d%s\n" % (self.bpp, ", compressed" if self.compress else ""))
+        o.append(" * Subset of %s by extras/font_subset.py: %s\n" % (os.path.basename(f.path), c_comment(chars)))
+        o.append(" * Generated, do not edit.\n")
+        o.append(" ******************************************************************************/\n\n")
+        o.append('#include "ui.h"\n\n')
+        o.append("#ifndef %s\n#define %s 1\n#endif\n\n" % (guard, guard))
+        o.append("/*Replaces the full font when that one is switched off*/\n")
+        o.append("#if !%s\n\n" % guard)
+        if self.compress:
+            o.append("#if !LV_USE_FONT_COMPRESSED\n")
+            o.append("#error \"%s is compressed: set LV_USE_FONT_COMPRESSED 1 in lv_conf.h\"\n" % f.name)
+            o.append("#endif\n\n")
+
+        o.append("/*-----------------\n *    BITMAPS\n *----------------*/\n\n")
+        o.append("/*Store the image of the glyphs*/\n")
+        o.append("static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] = {\n")
+        for n, (index, adv, w, h, ox, oy, cp) in enumerate(self.dsc):
+            end = self.dsc[n + 1][0] if n + 1 < len(self.dsc) else len(self.bitmap)
+            o.append("    /* U+%04X \"%s\" */\n" % (cp, c_comment(chr(cp))))
+            o.extend(hex_rows(self.bitmap[index:end], last=end == len(self.bitmap)))
+            o.append("\n")
+        o.append("};\n\n\n")
+
+        o.append("/*---------------------\n *  GLYPH DESCRIPTION\n *--------------------*/\n\n")
+        o.append("static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {\n")
+        o.append("    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */")
+        for index, adv, w, h, ox, oy, cp in self.dsc:
+            o.append(",\n    {.bitmap_index = %d, .adv_w = %d, .box_w = %d, .box_h = %d, .ofs_x = %d, .ofs_y = %d}"
+                     % (index, adv, w, h, ox, oy))
+        o.append("\n};\n\n")
+
+        o.append("/*---------------------\n *  CHARACTER MAPPING\n *--------------------*/\n\n")
+        start = self.cps[0]
+        if self.contiguous:
+            cmap_type, ulist, length = "LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY", "NULL", 0
+        else:
+            o.append("static const uint16_t unicode_list_0[] = {\n    ")
+            o.append(", ".join("0x%x" % (cp - start) for cp in self.cps))
+            o.append("\n};\n\n")
+            cmap_type, ulist, length = "LV_FONT_FMT_TXT_CMAP_SPARSE_TINY", "unicode_list_0", len(self.cps)
+        o.append("/*Collect the unicode lists and glyph_id offsets*/\n")
+        o.append("static const lv_font_fmt_txt_cmap_t cmaps[] =\n{\n    {\n")
+        o.append("        .range_start = %d, .range_length = %d, .glyph_id_start = 1,\n"
+                 % (start, self.cps[-1] - start + 1))
+        o.append("        .unicode_list = %s, .glyph_id_ofs_list = NULL, .list_length = %d, .type = %s\n"
+                 % (ulist, length, cmap_type))
+        o.append("    }\n};\n\n")
+
+        if self.kern:
+            o.append("/*-----------------\n *    KERNING\n *----------------*/\n\n")
+            o.append("/*Pair left and right glyphs for kerning*/\n")
+            o.append("static const uint8_t kern_pair_glyph_ids[] =\n{\n")
+            o.append(",\n".join("    %d, %d" % (l, r) for l, r, _ in self.kern))
+            o.append("\n};\n\n")
+            o.append("/* Kerning between the respective left and right glyphs\n")
+            o.append(" * 4.4 format which needs to scaled with `kern_scale`*/\n")
+            o.append("static const int8_t kern_pair_values[] =\n{\n    ")
+            o.append(", ".join(str(v) for _, _, v in self.kern))
+            o.append("\n};\n\n")
+            o.append("/*Collect the kern pair's data in one place*/\n")
+            o.append("static const lv_font_fmt_txt_kern_pair_t kern_pairs =\n{\n")
+            o.append("    .glyph_ids = kern_pair_glyph_ids,\n    .values = kern_pair_values,\n")
+            o.append("    .pair_cnt = %d,\n    .glyph_ids_size = 0\n};\n\n" % len(self.kern))
+
+        o.append("/*--------------------\n *  ALL CUSTOM DATA\n *--------------------*/\n\n")
+        o.append("static const lv_font_fmt_txt_dsc_t font_dsc = {\n")
+        o.append("    .glyph_bitmap = glyph_bitmap,\n    .glyph_dsc = glyph_dsc,\n    .cmaps = cmaps,\n")
+        o.append("    .kern_dsc = %s,\n" % ("&kern_pairs" if self.kern else "NULL"))
+        o.append("    .kern_scale = %d,\n    .cmap_num = 1,\n    .bpp = %d,\n" % (f.kern_scale, self.bpp))
+        o.append("    .kern_classes = 0,\n    .bitmap_format = %d,\n};\n\n" % fmt)
+
+        o.append("/*-----------------\n *  PUBLIC FONT\n *----------------*/\n\n")
+        o.append("/*Initialize a public general font descriptor*/\n")
+        o.append("const lv_font_t %s = {\n" % f.name)
+        o.append("    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,    /*Function pointer to get glyph's data*/\n")
+        o.append("    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,    /*Function pointer to get glyph's bitmap*/\n")
+        o.append("    .line_height = %d,          /*The maximum line height required by the font*/\n" % f.line_height)
+        o.append("    .base_line = %d,             /*Baseline measured from the bottom of the line*/\n" % f.base_line)
+        o.append("    .subpx = %s,\n" % f.subpx)
+        o.append("    .underline_position = %d,\n" % f.underline_position)
+        o.append("    .underline_thickness = %d,\n" % f.underline_thickness)
+        o.append("    .dsc = &font_dsc,          /*The custom font data. Will be accessed by `get_glyph_bitmap/dsc` */\n")
+        o.append("    .fallback = NULL,\n    .user_data = NULL,\n};\n\n")
+        o.append("#endif /*#if !%s*/\n" % guard)
+        return "".join(o)
+
+
+def c_comment(s):
+    return s.replace("*/", "* /")
+
+
+def hex_rows(data, last):
+    rows = []
+    for i in range(0, len(data), 8):
+        chunk = data[i:i + 8]
+        tail = i + 8 >= len(data) and last
+        rows.append("    " + ", ".join("0x%x" % b for b in chunk) + ("" if tail else ",") + "\n")
+    return rows
+
+
+# --- manifest -------------------------------------------------------------
+
+def run_manifest(manifest_path, root, write=True, log=print):
+    """Subset every font in the manifest. Returns [(guard, out path)] of the
+    fonts written (or up to date), for the build to switch the originals off."""
+    with open(manifest_path, encoding="utf-8") as f:
+        manifest = json.load(f)
+    out_dir = os.path.join(root, manifest.get("out_dir", "src/fonts_subset"))
+    done = []
+    total_before = total_after = 0
+    for entry in manifest["fonts"]:
+        src = os.path.join(root, entry["src"])
+        font = Font(src)
+        sub = Subset(font, entry["chars"], entry.get("bpp"), entry.get("compress", False),
+                     entry.get("kerning", True))
+        out = os.path.join(out_dir, os.path.basename(src))
+        if write:
+            text = sub.render()
+            old = None
+            if os.path.exists(out):
+                with open(out, encoding="utf-8") as f:
+                    old = f.read()
+            if old != text:
+                os.makedirs(out_dir, exist_ok=True)
+                with open(out, "w", encoding="utf-8", newline="\n") as f:
+                    f.write(text)
+        if font.guard is None:
+            log("font_subset: %s has no UI_FONT_* guard, both versions would link" % font.name)
+        done.append((font.guard, out))
+        total_before += font.flash_bytes
+        total_after += sub.flash_bytes
+        log("font_subset: %-16s %3d -> %2d glyphs, %d bpp%s: %7.1f KB -> %6.1f KB (saves %.1f KB)" % (
+            font.name, len(font.glyphs), len(sub.cps), sub.bpp, " rle" if sub.compress else "",
+            font.flash_bytes / 1024, sub.flash_bytes / 1024, (font.flash_bytes - sub.flash_bytes) / 1024))
+    log("font_subset: total %.1f KB -> %.1f KB (saves %.1f KB of flash)" % (
+        total_before / 1024, total_after / 1024, (total_before - total_after) / 1024))
+    return done
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    root = os.path.dirname(here)
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("--manifest", default=os.path.join(here, "fonts.json"))
+    ap.add_argument("--check", action="store_true", help="report the savings, write nothing")
+    ap.add_argument("--src", help="subset one font instead of the manifest")
+    ap.add_argument("--chars", help="characters to keep (with --src)")
+    ap.add_argument("--bpp", type=int)
+    ap.add_argument("--compress", action="store_true")
+    ap.add_argument("--no-kerning", action="store_true")
+    ap.add_argument("--out", help="output file (with --src)")
+    args = ap.parse_args()
+
+    try:
+        if args.src:
+            if not args.chars or not args.out:
+                ap.error("--src needs --chars and --out")
+            font = Font(args.src)
+            sub = Subset(font, args.chars, args.bpp, args.compress, not args.no_kerning)
+            with open(args.out, "w", encoding="utf-8", newline="\n") as f:
+                f.write(sub.render())
+            print("%s: %.1f KB -> %.1f KB" % (font.name, font.flash_bytes / 1024, sub.flash_bytes / 1024))
+        else:
+            run_manifest(args.manifest, root, write=not args.check)
+    except (FontError, OSError, KeyError, ValueError) as e:
+        print("font_subset: %s" % e, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
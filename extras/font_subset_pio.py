@@ -0,0 +1,27 @@
+"""PlatformIO pre-build step: subset the fonts listed in extras/fonts.json.
+
+    [env:...]
+    extra_scripts = pre:extras/font_subset_pio.py
+
+Writes the subsets to src/fonts_subset/ (only when they change, so nothing
+rebuilds needlessly), switches the full fonts off with -D UI_FONT_*=0 and
+prints the flash saved per font. Set FONT_SUBSET=0 in the environment to
+build with the full fonts.
+"""
+import os
+import sys
+
+Import("env")  # noqa: F821 (SCons)
+
+project_dir = env.subst("$PROJECT_DIR")  # noqa: F821
+sys.path.insert(0, os.path.join(project_dir, "extras"))
+sys.dont_write_bytecode = True  # no extras/__pycache__ in the source tree
+import font_subset  # noqa: E402
+
+if os.environ.get("FONT_SUBSET", "1") != "0":
+    try:
+        fonts = font_subset.run_manifest(os.path.join(project_dir, "extras", "fonts.json"), project_dir)
+    except (font_subset.FontError, OSError, KeyError, ValueError) as e:
+        sys.stderr.write("font_subset: %s\n" % e)
+        env.Exit(1)  # noqa: F821
+    env.Append(CPPDEFINES=[(guard, 0) for guard, _ in fonts if guard])  # noqa: F821
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Read ride logs written by src/ride_log.cpp (format: src/ride_log_format.h).
+
+    ride_log.py 0003.rlg                      # summary
+    ride_log.py 0003.rlg --csv out            # out_bms.csv, out_vesc.csv
+    ride_log.py 0003.rlg --columns out.json   # {"vesc": {"t_ms": [...], ...}, ...}
+    ride_log.py 0003.rlg --from 60000 --to 120000 --csv out
+
+Blocks failing their CRC (e.g. torn by power loss) end the readable log.
+"""
+import argparse
+import csv
+import json
+import struct
+import sys
+import zlib
+
+FILE_HDR = struct.Struct("<IHHII")
+BLOCK_HDR = struct.Struct("<IIIIHHI")
+REC_HDR = struct.Struct("<BBH")
+BMS = struct.Struct("<iiiHhhhB")
+VESC = struct.Struct("<iiihhhhIB")
+
+RIDE_LOG_MAGIC = 0x474F4C52
+BLOCK_MAGIC = 0x4B4C4252
+REC_BMS = 1
+REC_VESC = 2
+
+BMS_FIELDS = ["t_ms", "pack_mv", "current_ma", "power_w", "soc_dpct",
+              "temp1_dc", "temp2_dc", "temp_mos_dc", "cell_count"]
+VESC_FIELDS = ["t_ms", "speed_dkmh", "power_w", "current_in_ca", "v_in_dv",
+               "temp_motor_dc", "temp_fet_dc", "duty_pm", "odometer_m", "fault"]
+
+
+class RideLog:
+    def __init__(self, data):
+        if len(data) < FILE_HDR.size:
+            raise ValueError("file too short")
+        magic, self.version, self.block_bytes, self.boot_ms, _ = FILE_HDR.unpack_from(data, 0)
+        if magic != RIDE_LOG_MAGIC:
+            raise ValueError("not a ride log")
+        self.data = data
+        self.block_count = (len(data) - FILE_HDR.size) // self.block_bytes
+        self.bad_blocks = 0
+
+    def _block(self, n):
+        off = FILE_HDR.size + n * self.block_bytes
+        hdr = BLOCK_HDR.unpack_from(self.data, off)
+        magic, seq, t0, t1, count, payload, crc = hdr
+        if magic != BLOCK_MAGIC or BLOCK_HDR.size + payload > self.block_bytes:
+            return None
+        raw = bytearray(self.data[off:off + BLOCK_HDR.size + payload])
+        raw[BLOCK_HDR.size - 4:BLOCK_HDR.size] = b"\0\0\0\0"
+        if zlib.crc32(raw) != crc:
+            return None
+        return t0, t1, count, self.data[off + BLOCK_HDR.size:off + BLOCK_HDR.size + payload]
+
+    def valid_blocks(self):
+        """Number of leading blocks that pass their CRC."""
+        for n in range(self.block_count):
+            if self._block(n) is None:
+                return n
+        return self.block_count
+
+    def seek(self, t_ms, nblocks):
+        """First block whose range may contain t_ms (binary search on headers)."""
+        lo, hi = 0, nblocks
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if self._block(mid)[1] < t_ms:
+                lo = mid + 1
+            else:
+                hi = mid
+        return lo
+
+    def records(self, t_from=0, t_to=None):
+        n = self.valid_blocks()
+        self.bad_blocks = self.block_count - n
+        for b in range(self.seek(t_from, n), n):
+            t0, t1, count, payload = self._block(b)
+            if t_to is not None and t0 > t_to:
+                return
+            pos = 0
+            for _ in range(count):
+                rtype, rlen, dt = REC_HDR.unpack_from(payload, pos)
+                pos += REC_HDR.size
+                body = payload[pos:pos + rlen]
+                pos += rlen
+                t = t0 + dt
+                if t < t_from or (t_to is not None and t > t_to):
+                    continue
+                if rtype == REC_BMS:
+                    fields = BMS.unpack_from(body, 0)
+                    cells = struct.unpack_from("<%dH" % fields[-1], body, BMS.size)
+                    yield "bms", (t,) + fields, cells
+                elif rtype == REC_VESC:
+                    yield "vesc", (t,) + VESC.unpack_from(body, 0), ()
+
+
+def to_columns(log, t_from, t_to):
+    cols = {"bms": {k: [] for k in BMS_FIELDS}, "vesc": {k: [] for k in VESC_FIELDS}}
+    cols["bms"]["cells_mv"] = []
+    for kind, row, cells in log.records(t_from, t_to):
+        names = BMS_FIELDS if kind == "bms" else VESC_FIELDS
+        for k, v in zip(names, row):
+            cols[kind][k].append(v)
+        if kind == "bms":
+            cols["bms"]["cells_mv"].append(list(cells))
+    return cols
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("log")
+    ap.add_argument("--csv", metavar="PREFIX")
+    ap.add_argument("--columns", metavar="JSON")
+    ap.add_argument("--from", dest="t_from", type=int, default=0, help="ms since boot")
+    ap.add_argument("--to", dest="t_to", type=int, default=None, help="ms since boot")
+    args = ap.parse_args()
+
+    with open(args.log, "rb") as f:
+        log = RideLog(f.read())
+
+    if args.csv:
+        with open(args.csv + "_bms.csv", "w", newline="") as fb, open(args.csv + "_vesc.csv", "w", newline="") as fv:
+            wb, wv = csv.writer(fb), csv.writer(fv)
+            wb.writerow(BMS_FIELDS + ["cell%02d_mv" % i for i in range(32)])
+            wv.writerow(VESC_FIELDS)
+            for kind, row, cells in log.records(args.t_from, args.t_to):
+                if kind == "bms":
+                    wb.writerow(list(row) + list(cells))
+                else:
+                    wv.writerow(row)
+    if args.columns:
+        with open(args.columns, "w") as f:
+            json.dump(to_columns(log, args.t_from, args.t_to), f)
+
+    counts = {"bms": 0, "vesc": 0}
+    span = [None, None]
+    for kind, row, _ in log.records(args.t_from, args.t_to):
+        counts[kind] += 1
+        span[0] = row[0] if span[0] is None else span[0]
+        span[1] = row[0]
+    print("%s: v%d, %d blocks (%d unreadable), %d bms / %d vesc records, t=%s..%s ms"
+          % (args.log, log.version, log.block_count, log.bad_blocks, counts["bms"], counts["vesc"], span[0], span[1]),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
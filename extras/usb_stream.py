@@ -0,0 +1,291 @@
+#!/usr/bin/env python3
+"""Decode the binary USB stream written by src/usb_stream.cpp.
+
+    usb_stream.py --port /dev/ttyACM0                  # print samples, logs and traces
+    usb_stream.py --port /dev/ttyACM0 --save cap.bin   # also keep the raw bytes
+    usb_stream.py --file cap.bin --csv out             # out_vesc.csv, out_bms.csv, ...
+    usb_stream.py --file cap.bin --trace trace.json    # profiler events for Perfetto / chrome://tracing
+
+Frames are COBS-encoded, 0x00-delimited: type:u8 seq:u8 payload crc16:u16le
+(CRC-16/CCITT-FALSE). Sample layouts come from the device's type descriptors,
+which it sends right after the host opens the stream with 'B'.
+"""
+import argparse
+import binascii
+import csv
+import json
+import re
+import struct
+import sys
+
+FT_TYPE_DESC = 0x01
+FT_TRACE_NAME = 0x02
+FT_TRACE = 0x03
+FT_STATS = 0x04
+FT_LOG_SITE = 0x05
+FT_LOG = 0x06
+
+# usb_field_kind_t -> struct code
+FIELD_KINDS = ["B", "b", "H", "h", "I", "i", "f", "?"]
+TRACE = struct.Struct("<HBBII")
+STATS = struct.Struct("<6I")
+STATS_FIELDS = ["frames", "bytes", "backpressure", "trace_dropped", "hub_missed", "crc_errors"]
+LOG_LEVELS = "EWID"
+LOG_ARGS = {"i": "<i", "u": "<I", "q": "<q", "Q": "<Q", "f": "<f"}
+# C conversion -> Python %-format: length modifiers dropped, %p as hex.
+C_SPEC = re.compile(r"%([-+ #0-9.]*)[hlzjtL]*([diouxXcfFeEgGsp%])")
+
+
+def c_format(fmt, args):
+    it = iter(args)
+
+    def conv(m):
+        flags, c = m.groups()
+        if c == "%":
+            return "%"
+        v = next(it, "?")
+        if c == "p":
+            flags, c = flags + "#", "x"
+        if isinstance(v, str) and c != "s":
+            return v
+        try:
+            return ("%" + flags + c) % v
+        except (TypeError, ValueError):
+            return str(v)
+    return C_SPEC.sub(conv, fmt)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("bad COBS block")
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class FrameType:
+    def __init__(self, type_id, name, size, fields):
+        self.type_id = type_id
+        self.name = name
+        self.size = size
+        self.fields = fields     # [(name, code, count, offset)]
+
+    def columns(self):
+        cols = []
+        for name, _, count, _ in self.fields:
+            cols += [name] if count == 1 else ["%s_%d" % (name, i) for i in range(count)]
+        return cols
+
+    def decode(self, payload):
+        row = {}
+        for name, code, count, off in self.fields:
+            vals = struct.unpack_from("<%d%s" % (count, code), payload, off)
+            if count == 1:
+                row[name] = vals[0]
+            else:
+                for i, v in enumerate(vals):
+                    row["%s_%d" % (name, i)] = v
+        return row
+
+
+class Decoder:
+    """Feed raw bytes, get ("sample", type, row), ("trace", name, core, start_us, dur_us),
+    ("log", level, t_us, "file:line", text), ("stats", row) and ("frame", type, payload)
+    for types without a handler."""
+
+    def __init__(self):
+        self.types = {}
+        self.trace_names = {}
+        self.log_sites = {}
+        self.crc_errors = 0
+        self.lost = 0
+        self.last_seq = None
+        self._buf = bytearray()
+        self.handlers = {
+            FT_TYPE_DESC: self._type_desc,
+            FT_TRACE_NAME: self._trace_name,
+            FT_TRACE: self._trace,
+            FT_STATS: self._stats,
+            FT_LOG_SITE: self._log_site,
+            FT_LOG: self._log,
+        }
+
+    def feed(self, data):
+        self._buf += data
+        while True:
+            end = self._buf.find(b"\0")
+            if end < 0:
+                return
+            raw = bytes(self._buf[:end])
+            del self._buf[:end + 1]
+            if raw:
+                yield from self._frame(raw)
+
+    def _frame(self, raw):
+        try:
+            frame = cobs_decode(raw)
+        except ValueError:
+            frame = b""
+        if len(frame) < 4 or binascii.crc_hqx(frame[:-2], 0xFFFF) != struct.unpack_from("<H", frame, len(frame) - 2)[0]:
+            # Usually text printed while the stream is open.
+            self.crc_errors += 1
+            return
+        ftype, seq = frame[0], frame[1]
+        if self.last_seq is not None:
+            self.lost += (seq - self.last_seq - 1) & 0xFF
+        self.last_seq = seq
+        payload = frame[2:-2]
+        handler = self.handlers.get(ftype)
+        if handler:
+            yield from handler(payload)
+        elif ftype in self.types:
+            yield "sample", self.types[ftype], self.types[ftype].decode(payload)
+        else:
+            yield "frame", ftype, payload
+
+    @staticmethod
+    def _str(payload, pos):
+        n = payload[pos]
+        return payload[pos + 1:pos + 1 + n].decode("ascii", "replace"), pos + 1 + n
+
+    def _type_desc(self, payload):
+        type_id, size = struct.unpack_from("<BH", payload, 0)
+        name, pos = self._str(payload, 3)
+        nfields = payload[pos]
+        pos += 1
+        fields = []
+        for _ in range(nfields):
+            kind, count, off = struct.unpack_from("<BBH", payload, pos)
+            fname, pos = self._str(payload, pos + 4)
+            fields.append((fname.rsplit(".", 1)[-1], FIELD_KINDS[kind], count, off))
+        self.types[type_id] = FrameType(type_id, name, size, fields)
+        return iter(())
+
+    def _trace_name(self, payload):
+        tid = struct.unpack_from("<H", payload, 0)[0]
+        self.trace_names[tid] = self._str(payload, 2)[0]
+        return iter(())
+
+    def _trace(self, payload):
+        for off in range(0, len(payload) - TRACE.size + 1, TRACE.size):
+            tid, core, _, start, dur = TRACE.unpack_from(payload, off)
+            yield "trace", self.trace_names.get(tid, "trace%d" % tid), core, start, dur
+
+    def _log_site(self, payload):
+        sid, level, line = struct.unpack_from("<HBH", payload, 0)
+        fname, pos = self._str(payload, 5)
+        fmt, _ = self._str(payload, pos)
+        self.log_sites[sid] = (level, "%s:%d" % (fname, line) if line else "", fmt)
+        return iter(())
+
+    def _log(self, payload):
+        sid, suppressed, t_us, nargs = struct.unpack_from("<HHIB", payload, 0)
+        pos = 9
+        args = []
+        for _ in range(nargs):
+            tag = chr(payload[pos])
+            pos += 1
+            if tag == "s":
+                v, pos = self._str(payload, pos)
+            else:
+                v = struct.unpack_from(LOG_ARGS[tag], payload, pos)[0]
+                pos += struct.calcsize(LOG_ARGS[tag])
+            args.append(v)
+        level, where, fmt = self.log_sites.get(sid, (2, "", "site%d" % sid + " %s" * nargs))
+        text = c_format(fmt, args)
+        if suppressed:
+            text += " (+%d suppressed)" % suppressed
+        yield "log", LOG_LEVELS[level & 3], t_us, where, text
+
+    def _stats(self, payload):
+        row = dict(zip(STATS_FIELDS, STATS.unpack_from(payload, 0)))
+        row["crc_errors"] = self.crc_errors
+        row["lost_frames"] = self.lost
+        yield "stats", row
+
+
+def read_chunks(args):
+    if args.file:
+        with open(args.file, "rb") as f:
+            while True:
+                chunk = f.read(4096)
+                if not chunk:
+                    return
+                yield chunk
+        return
+    import serial  # pyserial
+    port = serial.Serial(args.port, 115200, timeout=0.1)
+    port.write(b"B")
+    try:
+        while True:
+            chunk = port.read(4096)
+            if chunk:
+                yield chunk
+    except KeyboardInterrupt:
+        pass
+    finally:
+        port.write(b"T")
+        port.close()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port")
+    src.add_argument("--file", help="raw capture from --save")
+    ap.add_argument("--save", metavar="BIN", help="write the raw bytes to BIN")
+    ap.add_argument("--csv", metavar="PREFIX", help="one PREFIX_<type>.csv per sample type")
+    ap.add_argument("--trace", metavar="JSON", help="profiler events in Chrome trace format")
+    ap.add_argument("-q", "--quiet", action="store_true")
+    args = ap.parse_args()
+
+    dec = Decoder()
+    save = open(args.save, "wb") if args.save else None
+    writers, files, events = {}, [], []
+    try:
+        for chunk in read_chunks(args):
+            if save:
+                save.write(chunk)
+            for ev in dec.feed(chunk):
+                kind = ev[0]
+                if kind == "sample" and args.csv:
+                    ftype, row = ev[1], ev[2]
+                    if ftype.name not in writers:
+                        f = open("%s_%s.csv" % (args.csv, ftype.name), "w", newline="")
+                        files.append(f)
+                        writers[ftype.name] = csv.DictWriter(f, ftype.columns())
+                        writers[ftype.name].writeheader()
+                    writers[ftype.name].writerow(row)
+                elif kind == "trace" and args.trace:
+                    _, name, core, start, dur = ev
+                    events.append({"name": name, "ph": "X", "pid": 0, "tid": core, "ts": start, "dur": dur})
+                if not args.quiet:
+                    if kind == "sample":
+                        print(ev[1].name, ev[2])
+                    elif kind == "trace":
+                        print("trace %-16s core%d %10d us  %6d us" % ev[1:])
+                    elif kind == "log":
+                        print("%s %d.%06d %s %s" % (ev[1], ev[2] // 1000000, ev[2] % 1000000, ev[3], ev[4]))
+                    elif kind == "stats":
+                        print("stats", ev[1], file=sys.stderr)
+                    elif kind == "frame":
+                        print("frame 0x%02x %s" % (ev[1], ev[2].hex()))
+    finally:
+        for f in files:
+            f.close()
+        if save:
+            save.close()
+    if args.trace:
+        with open(args.trace, "w") as f:
+            json.dump({"traceEvents": events}, f)
+    print("%d bad frames, %d lost" % (dec.crc_errors, dec.lost), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
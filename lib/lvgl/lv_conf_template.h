@@ -131,6 +131,11 @@
 /** Align start address of draw_buf addresses to this bytes*/
 #define LV_DRAW_BUF_ALIGN                       4
 
+/** In direct render mode move the already rendered pixels of a scrolled object
+ *  and redraw only the newly exposed parts, if it has only its children over a plain color background.
+ *  Otherwise (overlays, non-opaque backgrounds) the object is redrawn as usual. */
+#define LV_REFR_SCROLL_BLIT                     0
+
 /** Using matrix for transformations.
  * Requirements:
  * - `LV_USE_MATRIX = 1`.
@@ -216,6 +221,14 @@
          *  `radius * 4` bytes are used per circle (the most often used radiuses are saved).
          *  - 0: disables caching */
         #define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
+
+        /** Draw solid arcs with per-row analytic coverage instead of the angle/radius masks.
+         *  Arcs with an image source keep the mask path. */
+        #define LV_DRAW_SW_ARC_ANALYTIC 0
+
+        /** Keep pre-blended RGB565 tiles of glyphs drawn over one-color backgrounds.
+         *  Fonts and tile memory are set with `lv_draw_sw_glyph_atlas_*()`. */
+        #define LV_DRAW_SW_GLYPH_ATLAS 0
     #endif
 
     #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_NONE
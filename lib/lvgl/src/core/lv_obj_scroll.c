@@ -12,7 +12,12 @@
 #include "../indev/lv_indev.h"
 #include "../indev/lv_indev_scroll.h"
 #include "../display/lv_display.h"
-#include "../misc/lv_area.h"
+#include "../misc/lv_area_private.h"
+#include "lv_obj_event_private.h"
+#include "lv_obj_draw_private.h"
+#include "lv_refr_private.h"
+#include "../display/lv_display_private.h"
+#include "../widgets/tabview/lv_tabview.h"
 
 /*********************
  *      DEFINES
@@ -38,6 +43,10 @@ static void scroll_y_anim(void * obj, int32_t v);
 static void scroll_end_cb(lv_anim_t * a);
 static void scroll_area_into_view(const lv_area_t * area, lv_obj_t * child, lv_point_t * scroll_value,
                                   lv_anim_enable_t anim_en);
+#if LV_REFR_SCROLL_BLIT
+    static bool scroll_blit_possible(lv_obj_t * obj);
+    static bool scroll_blit(lv_obj_t * obj, int32_t x, int32_t y, const lv_area_t * sb_hor, const lv_area_t * sb_ver);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -416,12 +425,23 @@ lv_result_t lv_obj_scroll_by_raw(lv_obj_t * obj, int32_t x, int32_t y)
 
     lv_obj_allocate_spec_attr(obj);
 
+#if LV_REFR_SCROLL_BLIT
+    /*The scrollbars before scrolling, in case the rendered pixels are moved instead of redrawn*/
+    lv_area_t sb_hor;
+    lv_area_t sb_ver;
+    bool blit = scroll_blit_possible(obj);
+    if(blit) lv_obj_get_scrollbar_area(obj, &sb_hor, &sb_ver);
+#endif
+
     obj->spec_attr->scroll.x += x;
     obj->spec_attr->scroll.y += y;
 
     lv_obj_move_children_by(obj, x, y, true);
     lv_result_t res = lv_obj_send_event(obj, LV_EVENT_SCROLL, NULL);
     if(res != LV_RESULT_OK) return res;
+#if LV_REFR_SCROLL_BLIT
+    if(blit && scroll_blit(obj, x, y, &sb_hor, &sb_ver)) return LV_RESULT_OK;
+#endif
     lv_obj_invalidate(obj);
     return LV_RESULT_OK;
 }
@@ -811,3 +831,208 @@ static void scroll_area_into_view(const lv_area_t * area, lv_obj_t * child, lv_p
     scroll_value->y += anim_en ? y_scroll : 0;
     lv_obj_scroll_by(parent, x_scroll, y_scroll, anim_en);
 }
+
+#if LV_REFR_SCROLL_BLIT
+
+static bool scroll_blit_possible(lv_obj_t * obj)
+{
+    lv_display_t * disp = lv_obj_get_display(obj);
+    if(disp == NULL || disp->render_mode != LV_DISPLAY_RENDER_MODE_DIRECT) return false;
+    if(disp->prev_scr || lv_obj_get_screen(obj) != disp->act_scr) return false;
+    return true;
+}
+
+/**
+ * Classes which draw nothing under or over their children other than the
+ * background, border and scrollbars of `lv_obj`
+ */
+static bool scroll_blit_plain_class(const lv_obj_t * obj)
+{
+    if(obj->class_p == &lv_obj_class) return true;
+#if LV_USE_TABVIEW
+    if(obj->class_p == &lv_tabview_class) return true;
+#endif
+    return false;
+}
+
+static bool scroll_blit_obj_is_on(lv_obj_t * obj, const lv_area_t * area)
+{
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return false;
+    /*Can draw anywhere*/
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) return true;
+    if(lv_obj_get_layer_type(obj) == LV_LAYER_TYPE_TRANSFORM) return true;
+
+    lv_area_t coords = obj->coords;
+    int32_t ext_size = lv_obj_get_ext_draw_size(obj);
+    lv_area_increase(&coords, ext_size, ext_size);
+    return lv_area_is_on(&coords, area);
+}
+
+/**
+ * Check the siblings drawn before (below) or after (above) an object
+ */
+static bool scroll_blit_siblings_are_on(lv_obj_t * obj, const lv_area_t * area, bool above)
+{
+    lv_obj_t * parent = lv_obj_get_parent(obj);
+    if(parent == NULL) return false;
+
+    int32_t idx = lv_obj_get_index(obj);
+    int32_t start = above ? idx + 1 : 0;
+    int32_t end = above ? (int32_t)lv_obj_get_child_count(parent) : idx;
+    int32_t i;
+    for(i = start; i < end; i++) {
+        if(scroll_blit_obj_is_on(lv_obj_get_child(parent, i), area)) return true;
+    }
+    return false;
+}
+
+static bool scroll_blit_layer_is_on(lv_obj_t * layer, const lv_area_t * area)
+{
+    if(layer == NULL) return false;
+    if(lv_obj_get_style_bg_opa(layer, LV_PART_MAIN) > LV_OPA_MIN) return true;
+
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_count(layer);
+    for(i = 0; i < child_cnt; i++) {
+        if(scroll_blit_obj_is_on(lv_obj_get_child(layer, i), area)) return true;
+    }
+    return false;
+}
+
+/**
+ * Check if the background of an object is a single color everywhere on an area
+ */
+static bool scroll_blit_bg_covers(lv_obj_t * obj, const lv_area_t * area)
+{
+    if(lv_obj_get_style_bg_grad_dir(obj, LV_PART_MAIN) != LV_GRAD_DIR_NONE) return false;
+    if(lv_obj_get_style_bg_grad(obj, LV_PART_MAIN) != NULL) return false;
+    if(lv_obj_get_style_bg_image_src(obj, LV_PART_MAIN) != NULL) return false;
+
+    lv_cover_check_info_t info;
+    info.res = LV_COVER_RES_COVER;
+    info.area = area;
+    lv_obj_send_event(obj, LV_EVENT_COVER_CHECK, &info);
+    return info.res == LV_COVER_RES_COVER;
+}
+
+/**
+ * Find the part of a scrolled object which shows only its children over a plain color background.
+ * There the rendered pixels can be moved with the children.
+ * @param obj       the scrolled object
+ * @param area      the visible area of `obj`, changed to the result
+ * @return          false if there is no such part
+ */
+static bool scroll_blit_get_area(lv_obj_t * obj, lv_area_t * area)
+{
+    bool on_bg = false;
+    lv_obj_t * o;
+    for(o = obj; o; o = lv_obj_get_parent(o)) {
+        if(!scroll_blit_plain_class(o)) return false;
+        if(lv_obj_has_flag(o, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) return false;
+        if(lv_obj_get_layer_type(o) != LV_LAYER_TYPE_NONE) return false;
+        if(lv_obj_get_style_opa(o, LV_PART_MAIN) < LV_OPA_MAX) return false;
+        if(lv_obj_get_style_clip_corner(o, LV_PART_MAIN)) return false;
+
+        bool outline = lv_obj_get_style_outline_width(o, LV_PART_MAIN) > 0 &&
+                       lv_obj_get_style_outline_opa(o, LV_PART_MAIN) > LV_OPA_MIN;
+        if(outline && lv_obj_get_style_outline_pad(o, LV_PART_MAIN) < 0) return false;
+
+        /*Leave out the border and the rounded corners.
+         *Above the background only a border drawn over the children matters.*/
+        bool bg = lv_obj_get_style_bg_opa(o, LV_PART_MAIN) > LV_OPA_MIN;
+        bool border = lv_obj_get_style_border_width(o, LV_PART_MAIN) > 0 &&
+                      lv_obj_get_style_border_opa(o, LV_PART_MAIN) > LV_OPA_MIN &&
+                      lv_obj_get_style_border_side(o, LV_PART_MAIN) != LV_BORDER_SIDE_NONE;
+        if(on_bg && !lv_obj_get_style_border_post(o, LV_PART_MAIN)) border = false;
+        int32_t inset = border ? lv_obj_get_style_border_width(o, LV_PART_MAIN) : 0;
+        if(border || (bg && !on_bg)) inset = LV_MAX(inset, lv_obj_get_style_radius(o, LV_PART_MAIN));
+        if(inset > 0) {
+            lv_area_t inner = o->coords;
+            lv_area_increase(&inner, -inset, -inset);
+            if(!lv_area_intersect(area, area, &inner)) return false;
+        }
+
+        if(!on_bg) {
+            if(scroll_blit_bg_covers(o, area)) on_bg = true;
+            else if(bg || lv_obj_get_style_bg_image_src(o, LV_PART_MAIN) != NULL) return false;
+            /*Nothing below may show through*/
+            else if(scroll_blit_siblings_are_on(o, area, false)) return false;
+        }
+
+        /*Nothing may be drawn over it*/
+        if(scroll_blit_siblings_are_on(o, area, true)) return false;
+    }
+    if(!on_bg) return false;
+
+    lv_display_t * disp = lv_obj_get_display(obj);
+    if(scroll_blit_layer_is_on(disp->top_layer, area)) return false;
+    if(scroll_blit_layer_is_on(disp->sys_layer, area)) return false;
+
+    /*Floating children are not scrolled*/
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_count(obj);
+    for(i = 0; i < child_cnt; i++) {
+        lv_obj_t * child = obj->spec_attr->children[i];
+        if(lv_obj_has_flag(child, LV_OBJ_FLAG_FLOATING) && scroll_blit_obj_is_on(child, area)) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Redraw something drawn over the moved pixels but not moving with them:
+ * where it is and where its old pixels were moved to.
+ */
+static void scroll_blit_inv_overlay(lv_display_t * disp, const lv_area_t * overlay, const lv_area_t * blit_area,
+                                    int32_t x, int32_t y)
+{
+    lv_area_t a;
+    if(lv_area_intersect(&a, overlay, blit_area)) lv_inv_area(disp, &a);
+
+    a = *overlay;
+    lv_area_move(&a, x, y);
+    if(lv_area_intersect(&a, &a, blit_area)) lv_inv_area(disp, &a);
+}
+
+/**
+ * Move the rendered pixels of a scrolled object in the next refresh and redraw only
+ * what can't be moved, e.g. the newly exposed strip.
+ * @return          false if not possible, the object needs to be redrawn as usual
+ */
+static bool scroll_blit(lv_obj_t * obj, int32_t x, int32_t y, const lv_area_t * sb_hor, const lv_area_t * sb_ver)
+{
+    lv_area_t vis = obj->coords;
+    if(!lv_obj_area_is_visible(obj, &vis)) return false;
+
+    lv_area_t area = vis;
+    if(!scroll_blit_get_area(obj, &area)) return false;
+
+    lv_display_t * disp = lv_obj_get_display(obj);
+    if(!lv_refr_scroll_blit(disp, &area, x, y)) return false;
+
+    /*Redraw the rest of the object*/
+    lv_area_t rest[4];
+    int8_t rest_cnt = lv_area_diff(rest, &vis, &area);
+    int8_t i;
+    for(i = 0; i < rest_cnt; i++) {
+        lv_inv_area(disp, &rest[i]);
+    }
+
+    /*And the scrollbars which are drawn over the children*/
+    scroll_blit_inv_overlay(disp, sb_hor, &area, x, y);
+    scroll_blit_inv_overlay(disp, sb_ver, &area, x, y);
+    lv_obj_scrollbar_invalidate(obj);
+
+    lv_obj_t * parent;
+    for(parent = lv_obj_get_parent(obj); parent; parent = lv_obj_get_parent(parent)) {
+        lv_area_t hor_area;
+        lv_area_t ver_area;
+        lv_obj_get_scrollbar_area(parent, &hor_area, &ver_area);
+        scroll_blit_inv_overlay(disp, &hor_area, &area, x, y);
+        scroll_blit_inv_overlay(disp, &ver_area, &area, x, y);
+    }
+
+    return true;
+}
+
+#endif /*LV_REFR_SCROLL_BLIT*/
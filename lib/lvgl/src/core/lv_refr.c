@@ -52,6 +52,10 @@ static void wait_for_flushing(lv_display_t * disp);
 static lv_result_t layer_get_area(lv_layer_t * layer, lv_obj_t * obj, lv_layer_type_t layer_type,
                                   lv_area_t * layer_area_out, lv_area_t * obj_draw_size_out);
 static bool alpha_test_area_on_obj(lv_obj_t * obj, const lv_area_t * area);
+#if LV_REFR_SCROLL_BLIT
+    static void refr_scroll_blit_prepare(void);
+    static void refr_scroll_blit(void);
+#endif
 #if LV_DRAW_TRANSFORM_USE_MATRIX
     static bool refr_check_obj_clip_overflow(lv_layer_t * layer, lv_obj_t * obj);
     static void refr_obj_matrix(lv_layer_t * layer, lv_obj_t * obj);
@@ -284,6 +288,9 @@ void lv_inv_area(lv_display_t * disp, const lv_area_t * area_p)
     /*Clear the invalidate buffer if the parameter is NULL*/
     if(area_p == NULL) {
         disp->inv_p = 0;
+#if LV_REFR_SCROLL_BLIT
+        disp->blit_pending = 0;
+#endif
         return;
     }
 
@@ -335,6 +342,36 @@ void lv_inv_area(lv_display_t * disp, const lv_area_t * area_p)
     lv_display_send_event(disp, LV_EVENT_REFR_REQUEST, NULL);
 }
 
+#if LV_REFR_SCROLL_BLIT
+bool lv_refr_scroll_blit(lv_display_t * disp, lv_area_t * area, int32_t dx, int32_t dy)
+{
+    /*A second scroll before the next refresh: give up the first blit and redraw its area instead*/
+    if(disp->blit_pending) {
+        disp->blit_pending = 0;
+        lv_inv_area(disp, &disp->blit_area);
+        return false;
+    }
+
+    /*In full mode every refresh renders the whole screen anyway*/
+    if(disp->render_mode != LV_DISPLAY_RENDER_MODE_DIRECT) return false;
+    if(disp->rotation != LV_DISPLAY_ROTATION_0 || disp->matrix_rotation) return false;
+    if(disp->buf_3 || lv_color_format_get_bpp(disp->color_format) < 8) return false;
+    if(!lv_display_is_invalidation_enabled(disp) || disp->rendering_in_progress) return false;
+
+    lv_area_t dest = *area;
+    lv_area_move(&dest, dx, dy);
+    if(!lv_area_intersect(&dest, &dest, area)) return false;
+
+    *area = dest;
+    disp->blit_area = dest;
+    disp->blit_dx = dx;
+    disp->blit_dy = dy;
+    disp->blit_inv_p = disp->inv_p;
+    disp->blit_pending = 1;
+    return true;
+}
+#endif
+
 /**
  * Get the display which is being refreshed
  * @return the display being refreshed
@@ -408,8 +445,14 @@ void lv_display_refr_timer(lv_timer_t * tmr)
         goto refr_finish;
     }
 
+#if LV_REFR_SCROLL_BLIT
+    refr_scroll_blit_prepare();
+#endif
     lv_refr_join_area();
     refr_sync_areas();
+#if LV_REFR_SCROLL_BLIT
+    refr_scroll_blit();
+#endif
     refr_invalid_areas();
 
     if(disp_refr->inv_p == 0) goto refr_finish;
@@ -424,6 +467,12 @@ void lv_display_refr_timer(lv_timer_t * tmr)
             lv_area_t * sync_area = lv_ll_ins_tail(&disp_refr->sync_areas);
             *sync_area = disp_refr->inv_areas[i];
         }
+#if LV_REFR_SCROLL_BLIT
+        if(disp_refr->blit_done) {
+            lv_area_t * sync_area = lv_ll_ins_tail(&disp_refr->sync_areas);
+            *sync_area = disp_refr->blit_area;
+        }
+#endif
     }
 
     lv_memzero(disp_refr->inv_areas, sizeof(disp_refr->inv_areas));
@@ -432,6 +481,11 @@ void lv_display_refr_timer(lv_timer_t * tmr)
 
 refr_finish:
 
+#if LV_REFR_SCROLL_BLIT
+    disp_refr->blit_pending = 0;
+    disp_refr->blit_done = 0;
+#endif
+
 #if LV_DRAW_SW_COMPLEX == 1
     lv_draw_sw_mask_cleanup();
 #endif
@@ -743,6 +797,89 @@ static void refr_sync_areas(void)
     LV_PROFILER_REFR_END;
 }
 
+#if LV_REFR_SCROLL_BLIT
+/**
+ * Translate the areas invalidated before the scroll into the moved region:
+ * their old content would be moved along with the rest.
+ * Drop the blit if the moved region is redrawn anyway.
+ */
+static void refr_scroll_blit_prepare(void)
+{
+    if(!disp_refr->blit_pending) return;
+
+    uint32_t i;
+    for(i = 0; i < disp_refr->blit_inv_p && i < disp_refr->inv_p; i++) {
+        lv_area_t a = disp_refr->inv_areas[i];
+        lv_area_move(&a, disp_refr->blit_dx, disp_refr->blit_dy);
+        if(lv_area_intersect(&a, &a, &disp_refr->blit_area)) lv_inv_area(disp_refr, &a);
+    }
+
+    for(i = 0; i < disp_refr->inv_p; i++) {
+        if(lv_area_is_in(&disp_refr->blit_area, &disp_refr->inv_areas[i], 0)) {
+            disp_refr->blit_pending = 0;
+            return;
+        }
+    }
+}
+
+/**
+ * Move the pixels of the scrolled region to their new place in the buffer being rendered.
+ * The source is the last frame: the other buffer when double buffered, else the same buffer.
+ */
+static void refr_scroll_blit(void)
+{
+    if(!disp_refr->blit_pending) return;
+    disp_refr->blit_pending = 0;
+
+    LV_PROFILER_REFR_BEGIN;
+    wait_for_flushing(disp_refr);
+
+    lv_draw_buf_t * dest_buf = disp_refr->buf_act;
+    lv_draw_buf_t * src_buf = dest_buf;
+    if(lv_display_is_double_buffered(disp_refr)) {
+        src_buf = dest_buf == disp_refr->buf_1 ? disp_refr->buf_2 : disp_refr->buf_1;
+    }
+
+    const lv_area_t * a = &disp_refr->blit_area;
+    uint32_t stride = dest_buf->header.stride;
+    uint32_t px_size = lv_color_format_get_size(disp_refr->color_format);
+    uint32_t line_size = lv_area_get_width(a) * px_size;
+    uint8_t * dest = dest_buf->data + a->y1 * stride + a->x1 * px_size;
+    const uint8_t * src = src_buf->data + (a->y1 - disp_refr->blit_dy) * stride +
+                          (a->x1 - disp_refr->blit_dx) * px_size;
+    int32_t h = lv_area_get_height(a);
+    int32_t y;
+
+    if(src_buf != dest_buf) {
+        for(y = 0; y < h; y++) {
+            lv_memcpy(dest, src, line_size);
+            dest += stride;
+            src += stride;
+        }
+    }
+    else if(disp_refr->blit_dy > 0) {
+        /*Moving down in place: go bottom up to not overwrite the rows still to be moved*/
+        dest += (h - 1) * stride;
+        src += (h - 1) * stride;
+        for(y = 0; y < h; y++) {
+            lv_memmove(dest, src, line_size);
+            dest -= stride;
+            src -= stride;
+        }
+    }
+    else {
+        for(y = 0; y < h; y++) {
+            lv_memmove(dest, src, line_size);
+            dest += stride;
+            src += stride;
+        }
+    }
+
+    disp_refr->blit_done = 1;
+    LV_PROFILER_REFR_END;
+}
+#endif
+
 /**
  * Refresh the joined areas
  */
@@ -768,6 +905,16 @@ static void refr_invalid_areas(void)
     disp_refr->last_part = 0;
     disp_refr->rendering_in_progress = true;
 
+#if LV_REFR_SCROLL_BLIT
+    /*Send the moved pixels to the display like any other updated area*/
+    if(disp_refr->blit_done) {
+        disp_refr->layer_head->draw_buf = disp_refr->buf_act;
+        disp_refr->refreshed_area = disp_refr->blit_area;
+        disp_refr->last_part = 1;
+        draw_buf_flush(disp_refr);
+    }
+#endif
+
     for(i = 0; i < (int32_t)disp_refr->inv_p; i++) {
         /*Refresh the unjoined areas*/
         if(disp_refr->inv_area_joined[i]) continue;
@@ -46,6 +46,22 @@ void lv_refr_deinit(void);
  */
 void lv_inv_area(lv_display_t * disp, const lv_area_t * area_p);
 
+#if LV_REFR_SCROLL_BLIT
+/**
+ * Request to move the already rendered pixels of a scrolled region instead of redrawing them.
+ * Only possible in direct render mode. The caller still needs to invalidate everything
+ * that changed other than by moving, e.g. the newly exposed parts.
+ * @param disp      pointer to the display
+ * @param area      the region whose content moves by (dx, dy). On success it's changed to
+ *                  the part which will be moved (the region moved and clipped to itself).
+ * @param dx        horizontal movement
+ * @param dy        vertical movement
+ * @return          true: the pixels will be moved in the next refresh;
+ *                  false: not possible, the region needs to be invalidated as usual
+ */
+bool lv_refr_scroll_blit(lv_display_t * disp, lv_area_t * area, int32_t dx, int32_t dy);
+#endif
+
 /**
  * Get the display which is being refreshed
  * @return the display being refreshed
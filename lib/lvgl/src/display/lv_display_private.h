@@ -110,6 +110,16 @@ struct _lv_display_t {
     /** Double buffer sync areas (redrawn during last refresh) */
     lv_ll_t sync_areas;
 
+#if LV_REFR_SCROLL_BLIT
+    /** Scrolled region to move in the next refresh (see `lv_refr_scroll_blit`)*/
+    lv_area_t blit_area;
+    int32_t blit_dx;
+    int32_t blit_dy;
+    uint32_t blit_inv_p;    /**< Areas invalidated before the scroll*/
+    uint8_t blit_pending : 1;
+    uint8_t blit_done : 1;
+#endif
+
     lv_draw_buf_t _static_buf1; /**< Used when user pass in a raw buffer as display draw buffer */
     lv_draw_buf_t _static_buf2;
     /*---------------------
@@ -20,20 +20,66 @@
 #include "../../stdlib/lv_string.h"
 #include "../lv_draw_private.h"
 
+#if LV_DRAW_SW_ARC_ANALYTIC
+    #include <math.h>
+    #ifndef M_PI
+        #define M_PI 3.14159265358979323846
+    #endif
+#endif
+
 static void add_circle(const lv_opa_t * circle_mask, const lv_area_t * blend_area, const lv_area_t * circle_area,
                        lv_opa_t * mask_buf,  int32_t width);
 static void get_rounded_area(int16_t angle, int32_t radius, uint8_t thickness, lv_area_t * res_area);
+#if LV_DRAW_SW_ARC_ANALYTIC
+    static void draw_arc_analytic(lv_draw_task_t * t, const lv_draw_arc_dsc_t * dsc, int32_t width,
+                                  int32_t start_angle, int32_t end_angle, const lv_area_t * clipped_area);
+#endif
 
 /*********************
  *      DEFINES
  *********************/
 #define SPLIT_RADIUS_LIMIT 10  /*With radius greater than this the arc will drawn in quarters. A quarter is drawn only if there is arc in it*/
 #define SPLIT_ANGLE_GAP_LIMIT 60  /*With small gaps in the arc don't bother with splitting because there is nothing to skip.*/
+#define ANALYTIC_MAX_EDGES    10  /*Edge zones per row: 2 radii and 2 cap circles on both sides, plus the 2 angle edges*/
+#define ANALYTIC_ZERO_GAP     8   /*Transparent runs at least this long split the row into separate blends*/
+#define SEG_MIXED             (-1)
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+#if LV_DRAW_SW_ARC_ANALYTIC
+/*Arc geometry relative to its center, in pixels. Pixel (x, y) is sampled at its
+ *middle, i.e. at (x + 0.5 - center.x, y + 0.5 - center.y).*/
+typedef struct {
+    float r_out;
+    float r_in;         /*<= 0: no hole*/
+    float r_out2, r_out_inv2;   /*r^2 and 1 / 2r*/
+    float r_in2, r_in_inv2;
+    float n1x, n1y;     /*Normal of the start edge, pointing into the arc*/
+    float n2x, n2y;     /*Normal of the end edge, pointing into the arc*/
+    bool wide;          /*Over 180 degrees: the arc is the union of the two half planes, not the intersection*/
+    bool rounded;
+    float cap_r;
+    float cap_r2, cap_r_inv2;
+    float cap1x, cap1y;
+    float cap2x, cap2y;
+} arc_geom_t;
+
+typedef struct {
+    int32_t x1;
+    int32_t x2;
+    bool radial;        /*Comes from the inner or outer radius*/
+} edge_zone_t;
+
+/*A piece of a row with either one coverage value or per pixel values (SEG_MIXED)*/
+typedef struct {
+    int32_t x1;
+    int32_t x2;
+    int16_t opa;
+} row_seg_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -90,6 +136,13 @@ void lv_draw_sw_arc(lv_draw_task_t * t, const lv_draw_arc_dsc_t * dsc, const lv_
     while(start_angle >= 360) start_angle -= 360;
     while(end_angle >= 360) end_angle -= 360;
 
+#if LV_DRAW_SW_ARC_ANALYTIC
+    if(dsc->img_src == NULL) {
+        draw_arc_analytic(t, dsc, width, start_angle, end_angle, &clipped_area);
+        return;
+    }
+#endif
+
     void * mask_list[4] = {0};
     /*Create an angle mask*/
     lv_draw_sw_mask_angle_param_t mask_angle_param;
@@ -249,6 +302,350 @@ void lv_draw_sw_arc(lv_draw_task_t * t, const lv_draw_arc_dsc_t * dsc, const lv_
  *   STATIC FUNCTIONS
  **********************/
 
+#if LV_DRAW_SW_ARC_ANALYTIC
+
+static inline float cov_clamp(float v)
+{
+    return v <= 0.0f ? 0.0f : (v >= 1.0f ? 1.0f : v);
+}
+
+static inline lv_opa_t cov_to_opa(float cov)
+{
+    return (lv_opa_t)(cov * 255.0f + 0.5f);
+}
+
+/*
+ * Coverage is built from 1 px wide linear ramps across each edge, combined as
+ * max(min(radial, angle), cap1, cap2). Near a circle of radius r the signed
+ * distance r - d is taken as (r^2 - d^2) / 2r, which needs no square root and
+ * is off by a fraction of a level at the edge.
+ */
+
+static inline float cov_radial(const arc_geom_t * g, float px, float py)
+{
+    float d2 = px * px + py * py;
+    float cov = cov_clamp((g->r_out2 - d2) * g->r_out_inv2 + 0.5f);
+    if(g->r_in > 0.0f) cov = LV_MIN(cov, cov_clamp((d2 - g->r_in2) * g->r_in_inv2 + 0.5f));
+    return cov;
+}
+
+static inline float cov_angle(const arc_geom_t * g, float px, float py)
+{
+    float a1 = cov_clamp(g->n1x * px + g->n1y * py + 0.5f);
+    float a2 = cov_clamp(g->n2x * px + g->n2y * py + 0.5f);
+    return g->wide ? LV_MAX(a1, a2) : LV_MIN(a1, a2);
+}
+
+static inline float cov_caps(const arc_geom_t * g, float px, float py)
+{
+    if(!g->rounded) return 0.0f;
+    float dx = px - g->cap1x;
+    float dy = py - g->cap1y;
+    float c1 = cov_clamp((g->cap_r2 - dx * dx - dy * dy) * g->cap_r_inv2 + 0.5f);
+    dx = px - g->cap2x;
+    dy = py - g->cap2y;
+    float c2 = cov_clamp((g->cap_r2 - dx * dx - dy * dy) * g->cap_r_inv2 + 0.5f);
+    return LV_MAX(c1, c2);
+}
+
+static lv_opa_t arc_coverage(const arc_geom_t * g, float px, float py)
+{
+    float cov = LV_MIN(cov_radial(g, px, py), cov_angle(g, px, py));
+    if(cov < 1.0f) cov = LV_MAX(cov, cov_caps(g, px, py));
+    return cov_to_opa(cov);
+}
+
+/**
+ * Add the pixels whose sample point is in (lo, hi) (relative to the center) to the edge zones.
+ */
+static void add_zone(edge_zone_t * zones, int32_t * cnt, float lo, float hi, float cx, bool radial)
+{
+    if(*cnt >= ANALYTIC_MAX_EDGES || hi < lo) return;
+    zones[*cnt].x1 = (int32_t)floorf(lo + cx - 0.5f);
+    zones[*cnt].x2 = (int32_t)ceilf(hi + cx - 0.5f);
+    zones[*cnt].radial = radial;
+    (*cnt)++;
+}
+
+/**
+ * Zones on a row where the distance from a circle center crosses `r` within half a pixel.
+ * `dy` is the row's vertical distance from the circle center, `ox` its horizontal offset.
+ */
+static void add_circle_zones(edge_zone_t * zones, int32_t * cnt, float r, float dy, float ox, float cx, bool radial)
+{
+    float hi2 = (r + 0.5f) * (r + 0.5f) - dy * dy;
+    if(hi2 <= 0.0f) return;
+    float hi = sqrtf(hi2);
+    float lo2 = (r - 0.5f) * (r - 0.5f) - dy * dy;
+    float lo = lo2 > 0.0f ? sqrtf(lo2) : 0.0f;
+    add_zone(zones, cnt, ox - hi, ox - lo, cx, radial);
+    add_zone(zones, cnt, ox + lo, ox + hi, cx, radial);
+}
+
+/**
+ * Zone on a row where the start or end edge is within half a pixel. Only the part of
+ * the edge line between the radii (`box`) is considered: elsewhere the radial term
+ * or the other edge keeps the coverage constant.
+ */
+static void add_edge_zone(edge_zone_t * zones, int32_t * cnt, float nx_inv, float ny, const lv_area_t * box,
+                          float py, float cx)
+{
+    if(py < box->y1 || py > box->y2) return;
+    float lo = (float)box->x1;
+    float hi = (float)box->x2;
+    if(nx_inv != 0.0f) {
+        float c = ny * py;
+        float a = (-0.5f - c) * nx_inv;
+        float b = (0.5f - c) * nx_inv;
+        lo = LV_MAX(lo, LV_MIN(a, b));
+        hi = LV_MIN(hi, LV_MAX(a, b));
+    }
+    add_zone(zones, cnt, lo, hi, cx, false);
+}
+
+/**
+ * Bounding box (relative to the center, 1 px margin) of an edge at `angle` between the radii.
+ */
+static void edge_box(const arc_geom_t * g, float angle, lv_area_t * box)
+{
+    float dx = cosf(angle);
+    float dy = sinf(angle);
+    float t1 = LV_MAX(g->r_in - 1.0f, 0.0f);
+    float t2 = g->r_out + 1.0f;
+    box->x1 = (int32_t)floorf(LV_MIN(dx * t1, dx * t2)) - 1;
+    box->x2 = (int32_t)ceilf(LV_MAX(dx * t1, dx * t2)) + 1;
+    box->y1 = (int32_t)floorf(LV_MIN(dy * t1, dy * t2)) - 1;
+    box->y2 = (int32_t)ceilf(LV_MAX(dy * t1, dy * t2)) + 1;
+}
+
+/**
+ * Draw a solid arc row by row. Each row is split at the edge zones (the only places
+ * where coverage is partial); between them the coverage is constant, so it is
+ * evaluated once and filled. Zones crossing only the radii evaluate just the radial
+ * ramps, and are skipped when they lie outside the angles. Opaque runs are blended
+ * without a mask.
+ */
+static void draw_arc_analytic(lv_draw_task_t * t, const lv_draw_arc_dsc_t * dsc, int32_t width,
+                              int32_t start_angle, int32_t end_angle, const lv_area_t * clipped_area)
+{
+    arc_geom_t g;
+    g.r_out = (float)dsc->radius;
+    g.r_in = (float)(dsc->radius - width);
+    g.r_out2 = g.r_out * g.r_out;
+    g.r_out_inv2 = 0.5f / g.r_out;
+    g.r_in2 = g.r_in * g.r_in;
+    g.r_in_inv2 = g.r_in > 0.0f ? 0.5f / g.r_in : 0.0f;
+
+    float sa = (float)start_angle * ((float)M_PI / 180.0f);
+    float ea = (float)end_angle * ((float)M_PI / 180.0f);
+    g.n1x = -sinf(sa);
+    g.n1y = cosf(sa);
+    g.n2x = sinf(ea);
+    g.n2y = -cosf(ea);
+    int32_t span = end_angle - start_angle;
+    if(span < 0) span += 360;
+    g.wide = span > 180;
+
+    g.rounded = dsc->rounded;
+    g.cap_r = (float)width / 2.0f;
+    g.cap_r2 = g.cap_r * g.cap_r;
+    g.cap_r_inv2 = 0.5f / g.cap_r;
+    /*Put the caps where the mask path puts its cap circles: into the pixel aligned
+     *areas of get_rounded_area(), centered in them*/
+    lv_area_t cap_area;
+    get_rounded_area(start_angle, dsc->radius, width, &cap_area);
+    g.cap1x = (float)(cap_area.x1 + cap_area.x2 + 1) * 0.5f;
+    g.cap1y = (float)(cap_area.y1 + cap_area.y2 + 1) * 0.5f;
+    get_rounded_area(end_angle, dsc->radius, width, &cap_area);
+    g.cap2x = (float)(cap_area.x1 + cap_area.x2 + 1) * 0.5f;
+    g.cap2y = (float)(cap_area.y1 + cap_area.y2 + 1) * 0.5f;
+
+    lv_area_t box1;
+    lv_area_t box2;
+    edge_box(&g, sa, &box1);
+    edge_box(&g, ea, &box2);
+    float n1x_inv = LV_ABS(g.n1x) >= 1e-4f ? 1.0f / g.n1x : 0.0f;   /*0: horizontal edge*/
+    float n2x_inv = LV_ABS(g.n2x) >= 1e-4f ? 1.0f / g.n2x : 0.0f;
+
+    float cx = (float)dsc->center.x;
+    float cy = (float)dsc->center.y;
+    int32_t blend_w = lv_area_get_width(clipped_area);
+    lv_opa_t * mask_buf = lv_malloc(blend_w);
+    LV_ASSERT_MALLOC(mask_buf);
+    if(mask_buf == NULL) return;
+
+    lv_area_t blend_area;
+    lv_draw_sw_blend_dsc_t blend_dsc = {0};
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+    blend_dsc.blend_area = &blend_area;
+    blend_dsc.mask_area = &blend_area;
+
+    int32_t y;
+    for(y = clipped_area->y1; y <= clipped_area->y2; y++) {
+        float py = (float)y + 0.5f - cy;
+        float ext2 = (g.r_out + 0.5f) * (g.r_out + 0.5f) - py * py;
+        if(ext2 <= 0.0f) continue;
+        float ext = sqrtf(ext2);
+
+        int32_t win_x1 = LV_MAX(clipped_area->x1, (int32_t)floorf(cx - ext - 0.5f));
+        int32_t win_x2 = LV_MIN(clipped_area->x2, (int32_t)ceilf(cx + ext - 0.5f));
+        if(win_x1 > win_x2) continue;
+
+        edge_zone_t zones[ANALYTIC_MAX_EDGES];
+        int32_t zone_cnt = 0;
+        add_circle_zones(zones, &zone_cnt, g.r_out, py, 0.0f, cx, true);
+        if(g.r_in > 0.0f) add_circle_zones(zones, &zone_cnt, g.r_in, py, 0.0f, cx, true);
+        add_edge_zone(zones, &zone_cnt, n1x_inv, g.n1y, &box1, py, cx);
+        add_edge_zone(zones, &zone_cnt, n2x_inv, g.n2y, &box2, py, cx);
+        if(g.rounded) {
+            add_circle_zones(zones, &zone_cnt, g.cap_r, py - g.cap1y, g.cap1x, cx, false);
+            add_circle_zones(zones, &zone_cnt, g.cap_r, py - g.cap2y, g.cap2x, cx, false);
+        }
+
+        /*Sort by start (few zones, insertion sort)*/
+        int32_t i, j;
+        for(i = 1; i < zone_cnt; i++) {
+            edge_zone_t z = zones[i];
+            for(j = i; j > 0 && zones[j - 1].x1 > z.x1; j--) zones[j] = zones[j - 1];
+            zones[j] = z;
+        }
+
+        /*Fill the row's coverage: constant between zones, per pixel inside them*/
+        lv_opa_t * row = mask_buf + (win_x1 - clipped_area->x1);
+        row_seg_t segs[ANALYTIC_MAX_EDGES * 4 + 1];
+        int32_t seg_cnt = 0;
+        int32_t x = win_x1;
+        i = 0;
+        while(x <= win_x2) {
+            while(i < zone_cnt && zones[i].x2 < x) i++;
+            int32_t next = (i < zone_cnt) ? LV_MAX(zones[i].x1, x) : win_x2 + 1;
+            if(next > win_x2 + 1) next = win_x2 + 1;
+            row_seg_t * seg = &segs[seg_cnt++];
+            seg->x1 = x;
+            if(next > x) {
+                seg->x2 = next - 1;
+                seg->opa = arc_coverage(&g, (float)x + 0.5f - cx, py);
+                /*Long transparent gaps are never blended, so they don't need to be filled*/
+                if(seg->opa != LV_OPA_TRANSP || next - x < ANALYTIC_ZERO_GAP) {
+                    lv_memset(row + (x - win_x1), seg->opa, next - x);
+                }
+                x = next;
+                continue;
+            }
+
+            /*Inside a zone: extend over overlapping zones*/
+            int32_t zone_end = zones[i].x2;
+            bool radial = zones[i].radial;
+            while(i + 1 < zone_cnt && zones[i + 1].x1 <= zone_end + 1) {
+                i++;
+                zone_end = LV_MAX(zone_end, zones[i].x2);
+                radial = radial && zones[i].radial;
+            }
+            zone_end = LV_MIN(zone_end, win_x2);
+            i++;
+
+            int32_t first = -1;
+            int32_t last = -1;
+            float px = (float)x + 0.5f - cx;
+            if(radial) {
+                /*The angle and cap terms are constant here*/
+                float ang = cov_angle(&g, px, py);
+                float cap = cov_caps(&g, px, py);
+                if(cap >= 1.0f || ang <= 0.0f) {
+                    seg->x2 = zone_end;
+                    seg->opa = cap >= 1.0f ? LV_OPA_COVER : (cap > 0.0f ? cov_to_opa(cap) : LV_OPA_TRANSP);
+                    lv_memset(row + (x - win_x1), seg->opa, zone_end - x + 1);
+                    x = zone_end + 1;
+                    continue;
+                }
+                /*So only the radii matter. Step d^2 incrementally: (px + 1)^2 = px^2 + 2px + 1*/
+                float d2 = px * px + py * py;
+                float dd2 = 2.0f * px + 1.0f;
+                float r_in2 = g.r_in > 0.0f ? g.r_in2 : -1e9f;   /*No hole: keep the inner term above 1*/
+                float r_in_inv2 = g.r_in > 0.0f ? g.r_in_inv2 : 1.0f;
+                for(; x <= zone_end; x++) {
+                    float c_out = (g.r_out2 - d2) * g.r_out_inv2;
+                    float c_in = (d2 - r_in2) * r_in_inv2;
+                    lv_opa_t v = cov_to_opa(cov_clamp(LV_MIN(c_out, c_in) + 0.5f));
+                    row[x - win_x1] = v;
+                    if(v != LV_OPA_TRANSP) {
+                        if(first < 0) first = x;
+                        last = x;
+                    }
+                    d2 += dd2;
+                    dd2 += 2.0f;
+                }
+            }
+            else {
+                for(; x <= zone_end; x++, px += 1.0f) {
+                    lv_opa_t v = arc_coverage(&g, px, py);
+                    row[x - win_x1] = v;
+                    if(v != LV_OPA_TRANSP) {
+                        if(first < 0) first = x;
+                        last = x;
+                    }
+                }
+            }
+
+            /*Zones often reach outside the arc (e.g. the angle edges through the hole): keep the transparent ends apart*/
+            if(first < 0) {
+                seg->x2 = zone_end;
+                seg->opa = LV_OPA_TRANSP;
+                continue;
+            }
+            if(first > seg->x1) {
+                seg->x2 = first - 1;
+                seg->opa = LV_OPA_TRANSP;
+                seg = &segs[seg_cnt++];
+                seg->x1 = first;
+            }
+            seg->x2 = last;
+            seg->opa = SEG_MIXED;
+            if(last < zone_end) {
+                seg = &segs[seg_cnt++];
+                seg->x1 = last + 1;
+                seg->x2 = zone_end;
+                seg->opa = LV_OPA_TRANSP;
+            }
+        }
+
+        /*Blend runs of segments; long transparent gaps (the hole, outside the angles) are skipped*/
+        blend_area.y1 = y;
+        blend_area.y2 = y;
+        int32_t run_x1 = 0;
+        bool run_open = false;
+        bool run_opaque = true;
+        for(i = 0; i <= seg_cnt; i++) {
+            const row_seg_t * seg = i < seg_cnt ? &segs[i] : NULL;
+            if(seg && seg->opa != LV_OPA_TRANSP) {
+                if(!run_open) {
+                    run_open = true;
+                    run_opaque = true;
+                    run_x1 = seg->x1;
+                }
+                if(seg->opa != LV_OPA_COVER) run_opaque = false;
+                blend_area.x2 = seg->x2;
+                continue;
+            }
+            if(!run_open) continue;
+            if(seg && seg->x2 - seg->x1 + 1 < ANALYTIC_ZERO_GAP && i + 1 < seg_cnt) {
+                run_opaque = false;
+                continue;
+            }
+            blend_area.x1 = run_x1;
+            blend_dsc.mask_buf = row + (run_x1 - win_x1);
+            blend_dsc.mask_res = run_opaque ? LV_DRAW_SW_MASK_RES_FULL_COVER : LV_DRAW_SW_MASK_RES_CHANGED;
+            lv_draw_sw_blend(t, &blend_dsc);
+            run_open = false;
+        }
+    }
+
+    lv_free(mask_buf);
+}
+
+#endif /*LV_DRAW_SW_ARC_ANALYTIC*/
+
 static void add_circle(const lv_opa_t * circle_mask, const lv_area_t * blend_area, const lv_area_t * circle_area,
                        lv_opa_t * mask_buf,  int32_t width)
 {
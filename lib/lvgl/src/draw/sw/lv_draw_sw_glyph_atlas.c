@@ -0,0 +1,270 @@
+/**
+ * @file lv_draw_sw_glyph_atlas.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_glyph_atlas.h"
+#if LV_USE_DRAW_SW && LV_DRAW_SW_GLYPH_ATLAS
+
+#include "../lv_draw_private.h"
+#include "../lv_draw_label_private.h"
+#include "../lv_draw_buf_private.h"
+#include "../../misc/lv_area_private.h"
+#include "../../misc/lv_color.h"
+#include "../../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ATLAS_ENTRIES   128     /*Power of 2*/
+#define ATLAS_PROBES    8       /*Slots tried per lookup before the table counts as full*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    const lv_font_t * font;
+    uint32_t glyph;         /*Glyph index in the font*/
+    uint16_t color;
+    uint16_t bg;
+    lv_opa_t opa;
+    uint16_t w;
+    uint16_t h;
+    uint32_t ofs;           /*First pixel in the tile memory*/
+    uint32_t gen;           /*Valid only if it matches the atlas' generation*/
+} atlas_entry_t;
+
+typedef struct {
+    uint16_t * px;
+    uint32_t size_px;
+    uint32_t used_px;
+    uint32_t gen;
+    const lv_font_t * fonts[LV_DRAW_SW_GLYPH_ATLAS_FONTS];
+    atlas_entry_t entries[ATLAS_ENTRIES];
+    lv_draw_sw_glyph_atlas_stats_t stats;
+} atlas_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static bool font_added(const lv_font_t * font);
+static atlas_entry_t * find_slot(const lv_font_t * font, uint32_t glyph, uint16_t color, uint16_t bg, lv_opa_t opa,
+                                 bool * found);
+static bool build_tile(atlas_entry_t * e, lv_draw_glyph_dsc_t * dsc);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static atlas_t atlas;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_draw_sw_glyph_atlas_init(void * buf, uint32_t buf_size)
+{
+    atlas.px = buf;
+    atlas.size_px = buf ? buf_size / 2 : 0;
+    lv_memzero(&atlas.stats, sizeof(atlas.stats));
+    atlas.stats.size_bytes = atlas.size_px * 2;
+    lv_draw_sw_glyph_atlas_clear();
+}
+
+lv_result_t lv_draw_sw_glyph_atlas_add_font(const lv_font_t * font)
+{
+    if(font == NULL) return LV_RESULT_INVALID;
+    if(font_added(font)) return LV_RESULT_OK;
+
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_SW_GLYPH_ATLAS_FONTS; i++) {
+        if(atlas.fonts[i] == NULL) {
+            atlas.fonts[i] = font;
+            return LV_RESULT_OK;
+        }
+    }
+    return LV_RESULT_INVALID;
+}
+
+void lv_draw_sw_glyph_atlas_clear(void)
+{
+    /*Bumping the generation invalidates every entry at once*/
+    atlas.gen++;
+    if(atlas.gen == 0) {
+        lv_memzero(atlas.entries, sizeof(atlas.entries));
+        atlas.gen = 1;
+    }
+    atlas.used_px = 0;
+    atlas.stats.used_bytes = 0;
+}
+
+void lv_draw_sw_glyph_atlas_get_stats(lv_draw_sw_glyph_atlas_stats_t * stats)
+{
+    *stats = atlas.stats;
+}
+
+bool lv_draw_sw_glyph_atlas_draw(lv_draw_task_t * t, lv_draw_glyph_dsc_t * dsc)
+{
+    if(atlas.px == NULL) return false;
+
+    lv_font_glyph_dsc_t * g = dsc->g;
+    if(!font_added(g->resolved_font)) return false;
+
+    lv_layer_t * layer = t->target_layer;
+    lv_draw_buf_t * buf = layer->draw_buf;
+    if(buf == NULL || buf->header.cf != LV_COLOR_FORMAT_RGB565) return false;
+
+    const lv_area_t * letter = dsc->letter_coords;
+    lv_area_t clipped;
+    if(!lv_area_intersect(&clipped, letter, &t->clip_area)) return true;
+
+    /*Everything under the visible part of the glyph must have one color*/
+    int32_t w = lv_area_get_width(&clipped);
+    int32_t h = lv_area_get_height(&clipped);
+    uint32_t dest_stride = buf->header.stride / 2;
+    uint16_t * dest = lv_draw_buf_goto_xy(buf, clipped.x1 - layer->buf_area.x1, clipped.y1 - layer->buf_area.y1);
+    uint16_t bg = dest[0];
+    int32_t x, y;
+    uint16_t * row = dest;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x < w; x++) {
+            if(row[x] != bg) {
+                atlas.stats.fallbacks++;
+                return false;
+            }
+        }
+        row += dest_stride;
+    }
+
+    uint16_t color = lv_color_to_u16(dsc->color);
+    bool found;
+    atlas_entry_t * e = find_slot(g->resolved_font, g->gid.index, color, bg, dsc->opa, &found);
+    if(e == NULL) {
+        lv_draw_sw_glyph_atlas_clear();
+        atlas.stats.resets++;
+        e = find_slot(g->resolved_font, g->gid.index, color, bg, dsc->opa, &found);
+    }
+
+    if(found) {
+        atlas.stats.hits++;
+    }
+    else {
+        e->font = g->resolved_font;
+        e->glyph = g->gid.index;
+        e->color = color;
+        e->bg = bg;
+        e->opa = dsc->opa;
+        if(!build_tile(e, dsc)) return false;
+        atlas.stats.misses++;
+    }
+
+    const uint16_t * tile = atlas.px + e->ofs + (clipped.y1 - letter->y1) * e->w + (clipped.x1 - letter->x1);
+    for(y = 0; y < h; y++) {
+        lv_memcpy(dest, tile, w * 2);
+        dest += dest_stride;
+        tile += e->w;
+    }
+    return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static bool font_added(const lv_font_t * font)
+{
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_SW_GLYPH_ATLAS_FONTS; i++) {
+        if(atlas.fonts[i] == font) return font != NULL;
+    }
+    return false;
+}
+
+/**
+ * Find the entry of a tile or a free slot for it (`found` tells which).
+ * @return      NULL if the probed slots are all taken
+ */
+static atlas_entry_t * find_slot(const lv_font_t * font, uint32_t glyph, uint16_t color, uint16_t bg, lv_opa_t opa,
+                                 bool * found)
+{
+    uint32_t h = (uint32_t)(lv_uintptr_t)font ^ (glyph * 2654435761u) ^ color ^ ((uint32_t)bg << 16) ^ opa;
+    h ^= h >> 15;
+
+    uint32_t i;
+    for(i = 0; i < ATLAS_PROBES; i++) {
+        atlas_entry_t * e = &atlas.entries[(h + i) & (ATLAS_ENTRIES - 1)];
+        if(e->gen != atlas.gen) {
+            *found = false;
+            return e;
+        }
+        if(e->font == font && e->glyph == glyph && e->color == color && e->bg == bg && e->opa == opa) {
+            *found = true;
+            return e;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Blend the glyph's whole box onto `e->bg` into the tile memory, the same way
+ * the RGB565 color blend does it with a mask.
+ */
+static bool build_tile(atlas_entry_t * e, lv_draw_glyph_dsc_t * dsc)
+{
+    lv_font_glyph_dsc_t * g = dsc->g;
+    uint32_t w = lv_area_get_width(dsc->letter_coords);
+    uint32_t h = lv_area_get_height(dsc->letter_coords);
+    uint32_t size = w * h;
+    if(size == 0 || size > atlas.size_px / 4) return false;   /*Keep room for the other glyphs*/
+
+    if(atlas.used_px + size > atlas.size_px) {
+        lv_draw_sw_glyph_atlas_clear();
+        atlas.stats.resets++;
+    }
+
+    const uint8_t * mask;
+    uint32_t mask_stride;
+    if(lv_font_has_static_bitmap(g->resolved_font) && g->format == LV_FONT_GLYPH_FORMAT_A8) {
+        g->req_raw_bitmap = 1;
+        mask = lv_font_get_glyph_static_bitmap(g);
+        mask_stride = g->stride ? g->stride : w;
+    }
+    else {
+        dsc->glyph_data = lv_font_get_glyph_bitmap(g, dsc->_draw_buf);
+        if(dsc->glyph_data == NULL) return false;
+        const lv_draw_buf_t * draw_buf = dsc->glyph_data;
+        mask = draw_buf->data;
+        mask_stride = draw_buf->header.stride;
+    }
+    if(mask == NULL) return false;
+
+    e->w = (uint16_t)w;
+    e->h = (uint16_t)h;
+    e->ofs = atlas.used_px;
+    e->gen = atlas.gen;
+    atlas.used_px += size;
+    atlas.stats.used_bytes = atlas.used_px * 2;
+
+    uint16_t * tile = atlas.px + e->ofs;
+    uint32_t x, y;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x < w; x++) {
+            lv_opa_t mix = e->opa >= LV_OPA_MAX ? mask[x] : LV_OPA_MIX2(mask[x], e->opa);
+            tile[x] = lv_color_16_16_mix(e->color, e->bg, mix);
+        }
+        tile += w;
+        mask += mask_stride;
+    }
+    return true;
+}
+
+#endif /*LV_USE_DRAW_SW && LV_DRAW_SW_GLYPH_ATLAS*/
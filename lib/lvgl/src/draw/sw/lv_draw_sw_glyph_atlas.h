@@ -0,0 +1,93 @@
+/**
+ * @file lv_draw_sw_glyph_atlas.h
+ *
+ * Cache of pre-blended RGB565 glyph tiles. For registered fonts, a glyph
+ * drawn over a single-color background is blended once per
+ * (font, glyph, color, background, opacity) and then copied row by row.
+ * Glyphs over anything else (gradients, images, other glyphs) are blended
+ * normally.
+ */
+
+#ifndef LV_DRAW_SW_GLYPH_ATLAS_H
+#define LV_DRAW_SW_GLYPH_ATLAS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lv_conf_internal.h"
+#if LV_USE_DRAW_SW && LV_DRAW_SW_GLYPH_ATLAS
+
+#include "../../misc/lv_types.h"
+#include "../../font/lv_font.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*Fonts that can be registered*/
+#define LV_DRAW_SW_GLYPH_ATLAS_FONTS    4
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;        /**< Tiles blended and stored*/
+    uint32_t fallbacks;     /**< Non-uniform background: drawn normally*/
+    uint32_t resets;        /**< The tile memory or the table was full and got cleared*/
+    uint32_t used_bytes;
+    uint32_t size_bytes;
+} lv_draw_sw_glyph_atlas_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Give the atlas its tile memory (e.g. a PSRAM block) and clear it.
+ * @param buf       memory for the tiles, at least 2 byte aligned. NULL disables the atlas.
+ * @param buf_size  size of `buf` in bytes
+ */
+void lv_draw_sw_glyph_atlas_init(void * buf, uint32_t buf_size);
+
+/**
+ * Cache the glyphs of a font. Only the fonts added here use the atlas.
+ * @param font      the font (the one where the glyph is found, not a fallback chain's first font)
+ * @return          LV_RESULT_INVALID if LV_DRAW_SW_GLYPH_ATLAS_FONTS fonts are already added
+ */
+lv_result_t lv_draw_sw_glyph_atlas_add_font(const lv_font_t * font);
+
+/**
+ * Drop all tiles, e.g. after the theme's colors changed.
+ */
+void lv_draw_sw_glyph_atlas_clear(void);
+
+/**
+ * @param stats     receives the counters since the last init
+ */
+void lv_draw_sw_glyph_atlas_get_stats(lv_draw_sw_glyph_atlas_stats_t * stats);
+
+/**
+ * Draw a glyph from the atlas (used by the software letter renderer).
+ * @param t         the draw task
+ * @param dsc       the glyph to draw, unrotated A1..A8 format
+ * @return          false if the glyph can't be drawn from the atlas and has to be blended normally
+ */
+bool lv_draw_sw_glyph_atlas_draw(lv_draw_task_t * t, lv_draw_glyph_dsc_t * dsc);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_DRAW_SW && LV_DRAW_SW_GLYPH_ATLAS*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_GLYPH_ATLAS_H*/
@@ -10,6 +10,7 @@
 #include "../lv_draw_label_private.h"
 #include "../../draw/lv_draw_private.h"
 #include "lv_draw_sw.h"
+#include "lv_draw_sw_glyph_atlas.h"
 
 #if LV_USE_FREETYPE && LV_USE_VECTOR_GRAPHIC && LV_USE_THORVG
 
@@ -151,6 +152,9 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_cb(lv_draw_task_t * t, lv_draw_gly
             case LV_FONT_GLYPH_FORMAT_A8:
             case LV_FONT_GLYPH_FORMAT_IMAGE: {
                     if(glyph_draw_dsc->rotation % 3600 == 0 && glyph_draw_dsc->format != LV_FONT_GLYPH_FORMAT_IMAGE) {
+#if LV_DRAW_SW_GLYPH_ATLAS
+                        if(lv_draw_sw_glyph_atlas_draw(t, glyph_draw_dsc)) break;
+#endif
                         lv_area_t mask_area = *glyph_draw_dsc->letter_coords;
 
                         if(lv_font_has_static_bitmap(glyph_draw_dsc->g->resolved_font) &&
@@ -328,6 +328,17 @@
     #endif
 #endif
 
+/** In direct render mode move the already rendered pixels of a scrolled object
+ *  and redraw only the newly exposed parts, if it has only its children over a plain color background.
+ *  Otherwise (overlays, non-opaque backgrounds) the object is redrawn as usual. */
+#ifndef LV_REFR_SCROLL_BLIT
+    #ifdef CONFIG_LV_REFR_SCROLL_BLIT
+        #define LV_REFR_SCROLL_BLIT CONFIG_LV_REFR_SCROLL_BLIT
+    #else
+        #define LV_REFR_SCROLL_BLIT                     0
+    #endif
+#endif
+
 /** Using matrix for transformations.
  * Requirements:
  * - `LV_USE_MATRIX = 1`.
@@ -613,6 +624,26 @@
                 #define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
             #endif
         #endif
+
+        /** Draw solid arcs with per-row analytic coverage instead of the angle/radius masks.
+         *  Arcs with an image source keep the mask path. */
+        #ifndef LV_DRAW_SW_ARC_ANALYTIC
+            #ifdef CONFIG_LV_DRAW_SW_ARC_ANALYTIC
+                #define LV_DRAW_SW_ARC_ANALYTIC CONFIG_LV_DRAW_SW_ARC_ANALYTIC
+            #else
+                #define LV_DRAW_SW_ARC_ANALYTIC 0
+            #endif
+        #endif
+
+        /** Keep pre-blended RGB565 tiles of glyphs drawn over one-color backgrounds.
+         *  Fonts and tile memory are set with `lv_draw_sw_glyph_atlas_*()`. */
+        #ifndef LV_DRAW_SW_GLYPH_ATLAS
+            #ifdef CONFIG_LV_DRAW_SW_GLYPH_ATLAS
+                #define LV_DRAW_SW_GLYPH_ATLAS CONFIG_LV_DRAW_SW_GLYPH_ATLAS
+            #else
+                #define LV_DRAW_SW_GLYPH_ATLAS 0
+            #endif
+        #endif
     #endif
 
     #ifndef LV_USE_DRAW_SW_ASM
@@ -43,6 +43,9 @@ static void lv_arc_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
 static void lv_arc_draw(lv_event_t * e);
 static void lv_arc_event(const lv_obj_class_t * class_p, lv_event_t * e);
 static void inv_arc_area(lv_obj_t * arc, lv_value_precise_t start_angle, lv_value_precise_t end_angle, lv_part_t part);
+static void inv_sector_part(lv_obj_t * obj, const lv_point_t * c, int32_t rin, int32_t rout,
+                            int32_t start, int32_t end);
+static void inv_arc_cap(lv_obj_t * obj, const lv_point_t * c, int32_t r_mid, int32_t cap_r, int32_t angle);
 static void inv_knob_area(lv_obj_t * obj);
 static void get_center(const lv_obj_t * obj, lv_point_t * center, int32_t * arc_r);
 static lv_value_precise_t get_angle(const lv_obj_t * obj);
@@ -102,6 +105,7 @@ void lv_arc_set_start_angle(lv_obj_t * obj, lv_value_precise_t start)
     lv_arc_t * arc = (lv_arc_t *)obj;
 
     if(start > 360) start -= 360;
+    if(start == arc->indic_angle_start) return;
 
     lv_value_precise_t old_delta = arc->indic_angle_end - arc->indic_angle_start;
     lv_value_precise_t new_delta = arc->indic_angle_end - start;
@@ -109,8 +113,7 @@ void lv_arc_set_start_angle(lv_obj_t * obj, lv_value_precise_t start)
     if(old_delta < 0) old_delta = 360 + old_delta;
     if(new_delta < 0) new_delta = 360 + new_delta;
 
-    if(LV_ABS(new_delta - old_delta) > 180)  lv_obj_invalidate(obj);
-    else if(new_delta < old_delta) inv_arc_area(obj, arc->indic_angle_start, start, LV_PART_INDICATOR);
+    if(new_delta < old_delta) inv_arc_area(obj, arc->indic_angle_start, start, LV_PART_INDICATOR);
     else if(old_delta < new_delta) inv_arc_area(obj, start, arc->indic_angle_start, LV_PART_INDICATOR);
 
     inv_knob_area(obj);
@@ -125,6 +128,7 @@ void lv_arc_set_end_angle(lv_obj_t * obj, lv_value_precise_t end)
     LV_ASSERT_OBJ(obj, MY_CLASS);
     lv_arc_t * arc = (lv_arc_t *)obj;
     if(end > 360) end -= 360;
+    if(end == arc->indic_angle_end) return;
 
     lv_value_precise_t old_delta = arc->indic_angle_end - arc->indic_angle_start;
     lv_value_precise_t new_delta = end - arc->indic_angle_start;
@@ -132,8 +136,7 @@ void lv_arc_set_end_angle(lv_obj_t * obj, lv_value_precise_t end)
     if(old_delta < 0) old_delta = 360 + old_delta;
     if(new_delta < 0) new_delta = 360 + new_delta;
 
-    if(LV_ABS(new_delta - old_delta) > 180)  lv_obj_invalidate(obj);
-    else if(new_delta < old_delta) inv_arc_area(obj, end, arc->indic_angle_end, LV_PART_INDICATOR);
+    if(new_delta < old_delta) inv_arc_area(obj, end, arc->indic_angle_end, LV_PART_INDICATOR);
     else if(old_delta < new_delta) inv_arc_area(obj, arc->indic_angle_end, end, LV_PART_INDICATOR);
 
     inv_knob_area(obj);
@@ -162,8 +165,7 @@ void lv_arc_set_bg_start_angle(lv_obj_t * obj, lv_value_precise_t start)
     if(old_delta < 0) old_delta = 360 + old_delta;
     if(new_delta < 0) new_delta = 360 + new_delta;
 
-    if(LV_ABS(new_delta - old_delta) > 180)  lv_obj_invalidate(obj);
-    else if(new_delta < old_delta) inv_arc_area(obj, arc->bg_angle_start, start, LV_PART_MAIN);
+    if(new_delta < old_delta) inv_arc_area(obj, arc->bg_angle_start, start, LV_PART_MAIN);
     else if(old_delta < new_delta) inv_arc_area(obj, start, arc->bg_angle_start, LV_PART_MAIN);
 
     arc->bg_angle_start = start;
@@ -184,8 +186,7 @@ void lv_arc_set_bg_end_angle(lv_obj_t * obj, lv_value_precise_t end)
     if(old_delta < 0) old_delta = 360 + old_delta;
     if(new_delta < 0) new_delta = 360 + new_delta;
 
-    if(LV_ABS(new_delta - old_delta) > 180)  lv_obj_invalidate(obj);
-    else if(new_delta < old_delta) inv_arc_area(obj, end, arc->bg_angle_end, LV_PART_MAIN);
+    if(new_delta < old_delta) inv_arc_area(obj, end, arc->bg_angle_end, LV_PART_MAIN);
     else if(old_delta < new_delta) inv_arc_area(obj, arc->bg_angle_end, end, LV_PART_MAIN);
 
     arc->bg_angle_end = end;
@@ -807,26 +808,88 @@ static void inv_arc_area(lv_obj_t * obj, lv_value_precise_t start_angle, lv_valu
 
     if(start_angle == end_angle) return;
 
-    if(start_angle > 360) start_angle -= 360;
-    if(end_angle > 360) end_angle -= 360;
-
-    start_angle += arc->rotation;
-    end_angle += arc->rotation;
-
-    if(start_angle > 360) start_angle -= 360;
-    if(end_angle > 360) end_angle -= 360;
-
     int32_t r;
     lv_point_t c;
     get_center(obj, &c, &r);
 
     int32_t w = lv_obj_get_style_arc_width(obj, part);
-    int32_t rounded = lv_obj_get_style_arc_rounded(obj, part);
+    bool rounded = lv_obj_get_style_arc_rounded(obj, part);
+    int32_t rin = LV_MAX(r - w, 0);
+
+    /*Whole degrees covering the changed sector, counter-clockwise from start to end*/
+    int32_t start = (int32_t)start_angle + (int32_t)arc->rotation;
+    int32_t end = (int32_t)end_angle + (int32_t)arc->rotation;
+    if(end_angle > (int32_t)end_angle) end++;
+    while(start >= 360) start -= 360;
+    while(start < 0) start += 360;
+    while(end < start) end += 360;
+    while(end - start > 360) end -= 360;
+
+    if(end - start >= 360) {
+        lv_area_t inv_area;
+        lv_area_set(&inv_area, c.x - r, c.y - r, c.x + r, c.y + r);
+        lv_obj_invalidate_area(obj, &inv_area);
+        return;
+    }
+
+    /*Within one quadrant the extremes of the annular sector are its four corners,
+     *so invalidate the sector quadrant by quadrant instead of one box around all of it*/
+    int32_t a = start;
+    while(a < end) {
+        int32_t b = LV_MIN((a / 90 + 1) * 90, end);
+        inv_sector_part(obj, &c, rin, r, a, b);
+        a = b;
+    }
+
+    /*The round caps stick out of the sector at both ends*/
+    if(rounded && w > 1) {
+        inv_arc_cap(obj, &c, r - w / 2, w / 2, start);
+        inv_arc_cap(obj, &c, r - w / 2, w / 2, end);
+    }
+}
+
+/**
+ * Invalidate the bounding box of the annular sector between `start` and `end`
+ * which must be within the same quadrant.
+ */
+static void inv_sector_part(lv_obj_t * obj, const lv_point_t * c, int32_t rin, int32_t rout,
+                            int32_t start, int32_t end)
+{
+    int32_t cos_s = lv_trigo_cos(start);
+    int32_t sin_s = lv_trigo_sin(start);
+    int32_t cos_e = lv_trigo_cos(end);
+    int32_t sin_e = lv_trigo_sin(end);
+
+    int32_t xs[4] = {cos_s * rin, cos_s * rout, cos_e * rin, cos_e * rout};
+    int32_t ys[4] = {sin_s * rin, sin_s * rout, sin_e * rin, sin_e * rout};
+
+    lv_area_t a;
+    a.x1 = a.x2 = xs[0];
+    a.y1 = a.y2 = ys[0];
+    for(int32_t i = 1; i < 4; i++) {
+        a.x1 = LV_MIN(a.x1, xs[i]);
+        a.x2 = LV_MAX(a.x2, xs[i]);
+        a.y1 = LV_MIN(a.y1, ys[i]);
+        a.y2 = LV_MAX(a.y2, ys[i]);
+    }
+
+    /*One extra pixel on each side for anti-aliasing and the truncated trigonometry*/
+    a.x1 = c->x + (a.x1 >> LV_TRIGO_SHIFT) - 1;
+    a.x2 = c->x + (a.x2 >> LV_TRIGO_SHIFT) + 1;
+    a.y1 = c->y + (a.y1 >> LV_TRIGO_SHIFT) - 1;
+    a.y2 = c->y + (a.y2 >> LV_TRIGO_SHIFT) + 1;
 
-    lv_area_t inv_area;
-    lv_draw_arc_get_area(c.x, c.y, r, start_angle, end_angle, w, rounded, &inv_area);
+    lv_obj_invalidate_area(obj, &a);
+}
+
+static void inv_arc_cap(lv_obj_t * obj, const lv_point_t * c, int32_t r_mid, int32_t cap_r, int32_t angle)
+{
+    int32_t x = c->x + ((lv_trigo_cos(angle) * r_mid) >> LV_TRIGO_SHIFT);
+    int32_t y = c->y + ((lv_trigo_sin(angle) * r_mid) >> LV_TRIGO_SHIFT);
 
-    lv_obj_invalidate_area(obj, &inv_area);
+    lv_area_t a;
+    lv_area_set(&a, x - cap_r - 1, y - cap_r - 1, x + cap_r + 1, y + cap_r + 1);
+    lv_obj_invalidate_area(obj, &a);
 }
 
 static void inv_knob_area(lv_obj_t * obj)
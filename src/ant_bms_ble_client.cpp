@@ -1,11 +1,11 @@
 #include "ant_bms_ble_client.h"
+#include "ble_links.h"
+#include "ant_bms_ble_module.h"
+#include "telemetry_hub.h"
+#include "dlog.h"
 
 namespace ant_bms_ble {
 
-namespace {
-AntBmsBleClient *g_instance = nullptr;
-}
-
 static const char *variant_name(AntVariant v) {
   switch (v) {
     case AntVariant::V2_7E: return "V2(7E)";
@@ -40,7 +40,6 @@ uint16_t AntBmsBleClient::chksum_v1_(const uint8_t *data, size_t len) {
 
 bool AntBmsBleClient::begin(const NimBLEAddress &addr) {
   addr_ = addr;
-  g_instance = this;
   return connect_();
 }
 
@@ -50,7 +49,7 @@ bool AntBmsBleClient::connect_() {
   client_ = NimBLEDevice::createClient();
   if (!client_) return false;
 
-  if (!client_->connect(addr_)) {
+  if (!ble_link_connect(BLE_LINK_BMS, client_, addr_)) {
     disconnect_();
     return false;
   }
@@ -74,6 +73,7 @@ void AntBmsBleClient::disconnect_() {
   variant_ = AntVariant::UNKNOWN;
   state_ = DetectState::DISCONNECTED;
   if (client_) {
+    ble_link_disconnected(BLE_LINK_BMS);
     if (client_->isConnected()) client_->disconnect();
     NimBLEDevice::deleteClient(client_);
     client_ = nullptr;
@@ -90,7 +90,9 @@ bool AntBmsBleClient::ensure_characteristic_() {
   if (!chr_) return false;
 
   if (chr_->canNotify()) {
-    if (!chr_->subscribe(true, notify_cb_)) {
+    // Route notifications to this instance; other clients share the host.
+    auto cb = [this](NimBLERemoteCharacteristic *, uint8_t *data, size_t len, bool) { on_notify_(data, len); };
+    if (!chr_->subscribe(true, cb)) {
       chr_ = nullptr;
       return false;
     }
@@ -106,12 +108,8 @@ bool AntBmsBleClient::ensure_characteristic_() {
   return true;
 }
 
-void AntBmsBleClient::notify_cb_(NimBLERemoteCharacteristic *chr, uint8_t *data, size_t len, bool) {
-  (void)chr;
-  if (g_instance) g_instance->on_notify_(data, len);
-}
-
 void AntBmsBleClient::on_notify_(const uint8_t *data, size_t len) {
+  ble_link_note_rx(BLE_LINK_BMS, len);
   assemble_and_detect_(data, len);
 }
 
@@ -131,16 +129,21 @@ bool AntBmsBleClient::send_frame_(uint8_t function, uint16_t address, uint8_t va
   frame[8] = kEnd1;
   frame[9] = kEnd2;
 
-  return chr_->writeValue(frame, sizeof(frame), false);
+  bool ok = chr_->writeValue(frame, sizeof(frame), false);
+  ble_link_note_tx(BLE_LINK_BMS, ok);
+  return ok;
 }
 
 bool AntBmsBleClient::send_raw_(const uint8_t *data, size_t len) {
   if (!connected_ || !chr_ || !client_ || !client_->isConnected()) return false;
   if (!data || len == 0) return false;
-  return chr_->writeValue(data, len, false);
+  bool ok = chr_->writeValue(data, len, false);
+  ble_link_note_tx(BLE_LINK_BMS, ok);
+  return ok;
 }
 
 bool AntBmsBleClient::request_status() {
+  status_req_us_ = micros();
   return send_frame_(kCmdStatus, 0x0000, 0xBE);
 }
 
@@ -196,7 +199,7 @@ bool AntBmsBleClient::detect_from_buffer_() {
 
     variant_ = v;
     state_ = DetectState::ACTIVE_LOCKED;
-    Serial.printf("[ANT] Detected variant: %s\n", variant_name(variant_));
+    DLOG_I("[ANT] Detected variant: %s", variant_name(variant_));
     parse_frame_(variant_, rx_buf_.data() + start, flen);
     rx_buf_.erase(rx_buf_.begin(), rx_buf_.begin() + start + flen);
     return true;
@@ -360,6 +363,7 @@ bool AntBmsBleClient::parse_frame_(AntVariant v, const uint8_t *data, size_t len
     status_.balancing_mask = (uint64_t)get32(132);
     status_.warning_mask = (uint64_t)get16(136);
     status_.protection_mask = 0;
+    bump_status_seq_();
     return true;
   }
   return false;
@@ -435,10 +439,63 @@ void AntBmsBleClient::parse_status_(const uint8_t *data, size_t len) {
   status_.avg_cell_v = get16(84 + offset) * 0.001f;
 
   status_.valid = true;
+  bump_status_seq_();
+}
+
+// Non-finite readings publish ANT_BMS_UNKNOWN rather than a plausible 0.
+static int32_t fixed(float v, float scale) {
+  const float x = v * scale;
+  if (!isfinite(x)) return ANT_BMS_UNKNOWN;
+  if (x >= 2147483520.0f) return INT32_MAX;
+  if (x <= -2147483520.0f) return INT32_MIN + 1;
+  return (int32_t)lroundf(x);
+}
+
+// The 16-bit fields have no spare value; a parsed frame always carries
+// them, so an unknown one only clamps to 0.
+static uint16_t fixed_u16(float v, float scale) {
+  const int32_t x = fixed(v, scale);
+  if (x == ANT_BMS_UNKNOWN || x < 0) return 0;
+  return x > UINT16_MAX ? UINT16_MAX : (uint16_t)x;
+}
+
+// Runs on the NimBLE host task right after a parse; the hub hands the copy
+// to the other core without locks.
+void AntBmsBleClient::publish_sample_() {
+  const AntStatusSummary &st = status_;
+  ant_bms_sample_t s = {};
+  s.pack_mv = fixed(st.total_voltage_v, 1000.0f);
+  s.current_ma = fixed(st.current_a, 1000.0f);
+  s.power_w = fixed(st.power_w, 1.0f);
+  s.soc_dpct = fixed_u16(st.soc_pct, 10.0f);
+  s.cell_count = st.cell_count > ANT_BMS_MAX_CELLS ? ANT_BMS_MAX_CELLS : st.cell_count;
+  s.temp_count = st.temp_sensor_count;
+  s.charge_on = st.charge_mosfet_status == 0x01;
+  s.discharge_on = st.discharge_mosfet_status == 0x01;
+  s.min_cell_idx = st.min_cell_idx;
+  s.max_cell_idx = st.max_cell_idx;
+  s.min_cell_mv = fixed_u16(st.min_cell_v, 1000.0f);
+  s.max_cell_mv = fixed_u16(st.max_cell_v, 1000.0f);
+  s.delta_cell_mv = fixed_u16(st.delta_cell_v, 1000.0f);
+  for (int i = 0; i < ANT_BMS_MAX_TEMPS; i++) {
+    s.temp_dc[i] = !isfinite(st.temp_c[i]) ? ANT_BMS_TEMP_UNKNOWN : (int16_t)fixed(st.temp_c[i], 10.0f);
+  }
+  for (int i = 0; i < s.cell_count; i++) s.cell_mv[i] = fixed_u16(st.cell_v[i], 1000.0f);
+  hub_publish(HUB_CH_BMS, &s, millis());
+}
+
+void AntBmsBleClient::bump_status_seq_() {
+  status_seq_ = status_seq_ + 1;
+  publish_sample_();
+  if (status_req_us_ != 0) {
+    ble_link_note_rtt(BLE_LINK_BMS, micros() - status_req_us_);
+    status_req_us_ = 0;
+  }
 }
 
 void AntBmsBleClient::tick(uint32_t now_ms) {
   if (!client_ || !client_->isConnected()) {
+    if (connected_) ble_link_disconnected(BLE_LINK_BMS);
     connected_ = false;
     return;
   }
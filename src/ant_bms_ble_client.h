@@ -78,6 +78,8 @@ class AntBmsBleClient {
   AntVariant variant() const { return variant_; }
   DetectState state() const { return state_; }
   uint32_t last_rx_ms() const { return last_rx_ms_; }
+  // Bumped every time a status frame has been parsed.
+  uint32_t status_seq() const { return status_seq_; }
 
   bool request_status();
   bool request_device_info();
@@ -93,6 +95,8 @@ class AntBmsBleClient {
   uint32_t last_status_req_ms_ = 0;
   uint32_t last_devinfo_req_ms_ = 0;
   uint32_t last_rx_ms_ = 0;
+  volatile uint32_t status_seq_ = 0;
+  uint32_t status_req_us_ = 0;
   uint32_t detect_start_ms_ = 0;
   uint32_t last_probe_ms_ = 0;
   uint8_t probe_stage_ = 0;
@@ -101,8 +105,9 @@ class AntBmsBleClient {
   AntVariant variant_ = AntVariant::UNKNOWN;
   DetectState state_ = DetectState::DISCONNECTED;
 
-  static void notify_cb_(NimBLERemoteCharacteristic *chr, uint8_t *data, size_t len, bool is_notify);
   void on_notify_(const uint8_t *data, size_t len);
+  void bump_status_seq_();
+  void publish_sample_();
 
   bool connect_();
   void disconnect_();
@@ -1,12 +1,18 @@
 #include "ant_bms_ble_module.h"
 #include "ant_bms_ble_client.h"
 #include "ui_battery_bridge.h"
+#include "ui_msg_queue.h"
+#include "telemetry_model.h"
+#include "ui_update_sched.h"
+#include "telemetry_hub.h"
 
 #include <Arduino.h>
 #include <NimBLEDevice.h>
+#include <Preferences.h>
 #include <lvgl.h>
 #include <string.h>
 #include <math.h>
+#include <atomic>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
@@ -18,26 +24,27 @@ static bool s_connect_requested = false;
 static bool s_scanning = false;
 static TaskHandle_t s_scan_task = nullptr;
 static bool s_battery_was_active = false;
-
-// UI throttling / change detection
-static uint32_t s_last_pack_ms = 0;
-static uint32_t s_last_temps_ms = 0;
-static uint32_t s_last_cells_ms = 0;
-static float s_last_pack_v = -9999.0f;
-static float s_last_pack_a = -9999.0f;
-static bool s_last_chg_on = false;
-static bool s_last_dsg_on = false;
-static float s_last_t1 = -9999.0f;
-static float s_last_t2 = -9999.0f;
-static float s_last_tmos = -9999.0f;
-static float s_last_delta = -9999.0f;
-static float s_last_low_v = -9999.0f;
-static float s_last_high_v = -9999.0f;
-static int s_last_low_i = -1;
-static int s_last_high_i = -1;
-static int s_last_cell_count = -1;
-static float s_last_cell_v[32];
-static float s_last_soc = -9999.0f;
+static int s_ui_conn_state = -1;     // last state pushed by tick, -1 = unknown
+
+// Frame-aligned UI update channels (see ui_update_sched)
+static int s_ch_pack = -1;
+static int s_ch_temps = -1;
+static int s_ch_cell_summary = -1;
+static int s_ch_cells = -1;
+
+// Background discovery of known packs (accept-list filtered passive scan)
+static constexpr int kMaxKnown = 4;
+static constexpr uint32_t kBgRetryMs = 2000;
+static char s_known_macs[kMaxKnown][24];
+static int s_known_count = 0;
+static bool s_autoconnect = true;
+static bool s_autoconnect_suspended = false;
+static bool s_bg_scanning = false;
+static uint16_t s_bg_interval_ms = 160;
+static uint16_t s_bg_window_ms = 48;
+static uint32_t s_bg_retry_ms = 0;
+static std::atomic<bool> s_bg_match{false};
+static char s_bg_match_mac[24] = {0};
 
 static bool battery_screen_active()
 {
@@ -56,36 +63,110 @@ class AntScanCB : public NimBLEAdvertisedDeviceCallbacks {
         if (!d) return;
         if (!looks_like_ant(*d)) return;
         // Defer UI updates to LVGL thread.
-        struct ScanItem {
-            char name[32];
-            char mac[24];
-            int rssi;
-        };
-        ScanItem *item = (ScanItem *)lv_malloc(sizeof(ScanItem));
-        if (!item) return;
-        strncpy(item->name, d->getName().c_str(), sizeof(item->name) - 1);
-        item->name[sizeof(item->name) - 1] = '\0';
-        strncpy(item->mac, d->getAddress().toString().c_str(), sizeof(item->mac) - 1);
-        item->mac[sizeof(item->mac) - 1] = '\0';
-        item->rssi = d->getRSSI();
-        lv_async_call([](void *p) {
-            ScanItem *it = (ScanItem *)p;
-            if (battery_screen_active()) {
-                ui_battery_scanlist_add(it->name, it->mac, it->rssi);
-            }
-            lv_free(it);
-        }, item);
+        (void)ui_msg_post_scan_result(d->getName().c_str(), d->getAddress().toString().c_str(), d->getRSSI());
     }
 };
 
 static AntScanCB s_scan_cb;
 
-static bool is_battery_scrolling()
+class AntBgScanCB : public NimBLEAdvertisedDeviceCallbacks {
+    void onResult(NimBLEAdvertisedDevice *d) override {
+        if (!d || s_bg_match.load()) return;
+        // The controller already filtered on the accept list: any result is a known pack.
+        NimBLEDevice::getScan()->stop();
+        strncpy(s_bg_match_mac, d->getAddress().toString().c_str(), sizeof(s_bg_match_mac) - 1);
+        s_bg_match_mac[sizeof(s_bg_match_mac) - 1] = '\0';
+        s_bg_match.store(true);
+    }
+};
+
+static AntBgScanCB s_bg_scan_cb;
+
+static void load_known()
 {
-    if (!battery_screen_active()) return false;
-    lv_indev_t *indev = lv_indev_get_act();
-    if (!indev) return false;
-    return lv_indev_get_scroll_obj(indev) != NULL;
+    Preferences prefs;
+    if (!prefs.begin("antbms", true)) return;
+    s_known_count = 0;
+    int n = prefs.getInt("known_n", 0);
+    for (int i = 0; i < n && i < kMaxKnown; i++) {
+        char key[8];
+        snprintf(key, sizeof(key), "known%d", i);
+        size_t len = prefs.getString(key, s_known_macs[s_known_count], sizeof(s_known_macs[0]));
+        if (len > 0) s_known_count++;
+    }
+    prefs.end();
+}
+
+static void save_known()
+{
+    Preferences prefs;
+    if (!prefs.begin("antbms", false)) return;
+    prefs.putInt("known_n", s_known_count);
+    for (int i = 0; i < s_known_count; i++) {
+        char key[8];
+        snprintf(key, sizeof(key), "known%d", i);
+        prefs.putString(key, s_known_macs[i]);
+    }
+    prefs.end();
+}
+
+// Most recently connected pack goes first; the oldest falls off when full.
+static void remember_known(const char *mac)
+{
+    if (!mac || !mac[0]) return;
+    int found = -1;
+    for (int i = 0; i < s_known_count; i++) {
+        if (strcasecmp(s_known_macs[i], mac) == 0) {
+            found = i;
+            break;
+        }
+    }
+    if (found == 0) return;
+    int last = found;
+    if (last < 0) {
+        last = (s_known_count < kMaxKnown) ? s_known_count : (kMaxKnown - 1);
+        if (s_known_count < kMaxKnown) s_known_count++;
+    }
+    for (int i = last; i > 0; i--) {
+        memcpy(s_known_macs[i], s_known_macs[i - 1], sizeof(s_known_macs[0]));
+    }
+    strncpy(s_known_macs[0], mac, sizeof(s_known_macs[0]) - 1);
+    s_known_macs[0][sizeof(s_known_macs[0]) - 1] = '\0';
+    save_known();
+}
+
+// Accept list can only be changed while the controller is not scanning/connecting.
+static void sync_accept_list()
+{
+    for (int i = 0; i < s_known_count; i++) {
+        NimBLEAddress addr(s_known_macs[i]);
+        if (!NimBLEDevice::onWhiteList(addr)) {
+            (void)NimBLEDevice::whiteListAdd(addr);
+        }
+    }
+}
+
+static void bg_scan_start(uint32_t now_ms)
+{
+    NimBLEScan *scan = NimBLEDevice::getScan();
+    s_bg_retry_ms = now_ms;
+    if (scan->isScanning()) return;
+    sync_accept_list();
+    scan->setAdvertisedDeviceCallbacks(&s_bg_scan_cb, false);
+    scan->setFilterPolicy(BLE_HCI_SCAN_FILT_USE_WL);
+    scan->setActiveScan(false);
+    scan->setInterval(s_bg_interval_ms);
+    scan->setWindow(s_bg_window_ms);
+    scan->setMaxResults(0);
+    scan->clearResults();
+    s_bg_scanning = scan->start(0, nullptr, false);
+}
+
+static void bg_scan_stop()
+{
+    if (!s_bg_scanning) return;
+    NimBLEDevice::getScan()->stop();
+    s_bg_scanning = false;
 }
 
 static void scan_task(void *arg)
@@ -93,16 +174,13 @@ static void scan_task(void *arg)
     (void)arg;
     NimBLEScan *scan = NimBLEDevice::getScan();
     scan->setAdvertisedDeviceCallbacks(&s_scan_cb, false);
+    scan->setFilterPolicy(BLE_HCI_SCAN_FILT_NO_WL);
+    scan->setMaxResults(0xFF);
     scan->setInterval(45);
     scan->setWindow(15);
     scan->setActiveScan(true);
 
-    lv_async_call([](void *) {
-        if (!battery_screen_active()) return;
-        ui_battery_scanlist_clear();
-        ui_battery_set_connection_state(UI_BATT_SCANNING, NULL, NULL);
-        ui_battery_set_scan_progress("Scanning...");
-    }, nullptr);
+    ui_msg_post_conn_state(UI_BATT_SCANNING, UI_SCAN_EVT_STARTED);
 
     // Non-blocking start (runs in BLE stack task)
     scan->start(0, false);
@@ -112,22 +190,119 @@ static void scan_task(void *arg)
     scan->stop();
 
     s_scanning = false;
-    lv_async_call([](void *) {
-        if (!battery_screen_active()) return;
-        ui_battery_set_scan_progress("Idle");
-        if (!s_bms.is_connected()) {
-            ui_battery_set_connection_state(UI_BATT_DISCONNECTED, NULL, NULL);
-        }
-    }, nullptr);
+    ui_msg_post_conn_state(UI_BATT_DISCONNECTED, UI_SCAN_EVT_FINISHED);
 
     s_scan_task = nullptr;
     vTaskDelete(NULL);
 }
 
+// Quantize into telemetry subjects; bound widgets only hear about changes.
+// These run from the scheduler's REFR_START pass on the LVGL thread, marked
+// whenever the client publishes a status sample on HUB_CH_BMS.
+static ant_bms_sample_t s_sample;
+static uint32_t s_sample_seq = 0;
+
+static const ant_bms_sample_t &latest_sample()
+{
+    uint32_t seq = hub_seq(HUB_CH_BMS);
+    if (seq != s_sample_seq && hub_peek(HUB_CH_BMS, &s_sample, nullptr)) s_sample_seq = seq;
+    return s_sample;
+}
+
+static int32_t temp_c(int16_t dc)
+{
+    return (dc == ANT_BMS_TEMP_UNKNOWN) ? TELEM_UNKNOWN : (int32_t)lroundf(dc / 10.0f);
+}
+
+static_assert(ANT_BMS_UNKNOWN == TELEM_UNKNOWN, "unknown BMS values publish as-is");
+
+static int32_t scale_down(int32_t v, int32_t div)
+{
+    return (v == ANT_BMS_UNKNOWN) ? TELEM_UNKNOWN : (int32_t)lroundf((float)v / div);
+}
+
+static void apply_pack(void *)
+{
+    const ant_bms_sample_t &s = latest_sample();
+    telem_publish_int(TELEM_PACK_V_DV, scale_down(s.pack_mv, 100));
+    telem_publish_int(TELEM_PACK_A_DA, scale_down(s.current_ma, 100));
+    telem_publish_int(TELEM_CHG_ON, s.charge_on);
+    telem_publish_int(TELEM_DSG_ON, s.discharge_on);
+    telem_publish_int(TELEM_SOC_PCT, (s.soc_dpct + 5) / 10);
+}
+
+static void apply_temps(void *)
+{
+    const ant_bms_sample_t &s = latest_sample();
+    telem_publish_int(TELEM_TEMP1_C, temp_c(s.temp_dc[0]));
+    telem_publish_int(TELEM_TEMP2_C, temp_c(s.temp_dc[1]));
+    telem_publish_int(TELEM_TEMP_MOS_C, temp_c(s.temp_dc[6]));
+}
+
+static void apply_cell_summary(void *)
+{
+    const ant_bms_sample_t &s = latest_sample();
+    telem_publish_int(TELEM_CELL_DELTA_MV, s.delta_cell_mv);
+    telem_publish_int(TELEM_CELL_LOW_IDX, s.min_cell_idx > 0 ? (s.min_cell_idx - 1) : 0);
+    telem_publish_int(TELEM_CELL_LOW_MV, s.min_cell_mv);
+    telem_publish_int(TELEM_CELL_HIGH_IDX, s.max_cell_idx > 0 ? (s.max_cell_idx - 1) : 0);
+    telem_publish_int(TELEM_CELL_HIGH_MV, s.max_cell_mv);
+}
+
+// Expensive: a count change rebuilds the whole cell list.
+static void apply_cells(void *)
+{
+    const ant_bms_sample_t &s = latest_sample();
+    int n = (s.cell_count > TELEM_MAX_CELLS) ? TELEM_MAX_CELLS : s.cell_count;
+    telem_publish_int(TELEM_CELL_COUNT, n);
+    for (int i = 0; i < n; i++) {
+        telem_publish_cell_mv(i, s.cell_mv[i]);
+    }
+}
+
+// Runs on the LVGL thread from the per-frame queue drain.
+static void on_scan_result_msg(const ui_msg_t *msg)
+{
+    if (!battery_screen_active()) return;
+    ui_battery_scanlist_add(msg->u.scan.name, msg->u.scan.mac, msg->u.scan.rssi);
+}
+
+static void on_conn_state_msg(const ui_msg_t *msg)
+{
+    if (!battery_screen_active()) return;
+    const ui_msg_conn_state_t &c = msg->u.conn;
+    if (c.scan_event == UI_SCAN_EVT_STARTED) {
+        ui_battery_scanlist_clear();
+        ui_battery_set_connection_state(UI_BATT_SCANNING, NULL, NULL);
+        ui_battery_set_scan_progress("Scanning...");
+        return;
+    }
+    if (c.scan_event == UI_SCAN_EVT_FINISHED) {
+        ui_battery_set_scan_progress("Idle");
+        if (s_bms.is_connected()) return;
+    }
+    const char *mac = (c.state == UI_BATT_DISCONNECTED && c.scan_event != UI_SCAN_EVT_NONE) ? NULL : s_target_mac;
+    ui_battery_set_connection_state((ui_battery_conn_state_t)c.state, NULL, mac);
+}
+
 void ant_bms_ble_module_init()
 {
     if (s_inited) return;
     s_inited = true;
+    telem_init();
+    load_known();
+    ui_msg_queue_set_handler(UI_MSG_SCAN_RESULT, on_scan_result_msg);
+    ui_msg_queue_set_handler(UI_MSG_CONN_STATE, on_conn_state_msg);
+
+    s_ch_pack = ui_sched_add_channel("bms_pack", apply_pack, nullptr, 4, UI_SCHED_CHEAP);
+    s_ch_temps = ui_sched_add_channel("bms_temps", apply_temps, nullptr, 2, UI_SCHED_CHEAP);
+    s_ch_cell_summary = ui_sched_add_channel("bms_cell_sum", apply_cell_summary, nullptr, 2, UI_SCHED_CHEAP);
+    s_ch_cells = ui_sched_add_channel("bms_cells", apply_cells, nullptr, 1, UI_SCHED_EXPENSIVE);
+    ui_sched_set_channel_sources(s_ch_pack, UI_TELEM_SRC_BMS);
+    ui_sched_set_channel_sources(s_ch_temps, UI_TELEM_SRC_BMS);
+    ui_sched_set_channel_sources(s_ch_cell_summary, UI_TELEM_SRC_BMS);
+    ui_sched_set_channel_sources(s_ch_cells, UI_TELEM_SRC_BMS);
+    hub_channel_init(HUB_CH_BMS, sizeof(ant_bms_sample_t), 8, UI_TELEM_SRC_BMS);
 }
 
 void ant_bms_ble_module_set_target(const char *mac)
@@ -154,6 +329,7 @@ bool ant_bms_ble_module_connect_target()
 {
     if (s_target_mac[0] == '\0') return false;
     s_connect_requested = true;
+    s_autoconnect_suspended = false;
     return true;
 }
 
@@ -161,6 +337,9 @@ void ant_bms_ble_module_disconnect()
 {
     // recreate client by forcing begin with invalid addr
     s_connect_requested = false;
+    // Explicit disconnect: don't immediately auto-connect to the same pack again.
+    s_autoconnect_suspended = true;
+    bg_scan_stop();
     ant_bms_ble_module_set_target(NULL);
 }
 
@@ -175,25 +354,15 @@ void ant_bms_ble_module_flush_ui()
     ui_battery_set_connection_state(UI_BATT_DISCONNECTED, NULL, NULL);
     ui_battery_scanlist_clear();
     ui_battery_set_scan_progress("Idle");
-    ui_battery_set_pack_values(0.0f, 0.0f, false, false);
-    ui_battery_set_soc(-1.0f);
-    float zeros[6] = {0};
-    ui_battery_set_temps_all(zeros, 0, 0.0f, false);
-    ui_battery_set_cell_summary(0.0f, 0, 0.0f, 0, 0.0f);
-    ui_battery_cells_set_count(0);
-
-    // Reset UI caches so next entry repopulates cells immediately.
-    s_last_cells_ms = 0;
-    s_last_cell_count = -1;
-    for (int i = 0; i < 32; i++) {
-        s_last_cell_v[i] = -9999.0f;
-    }
+    telem_reset_bms();
 }
 
 void ant_bms_ble_module_scan_start()
 {
     if (s_scanning) return;
+    bg_scan_stop();
     s_scanning = true;
+    s_ui_conn_state = -1;
     if (s_scan_task == nullptr) {
         xTaskCreatePinnedToCore(scan_task, "ant_bms_scan", 4096, nullptr, 1, &s_scan_task, 0);
     }
@@ -205,13 +374,40 @@ void ant_bms_ble_module_scan_stop()
     NimBLEScan *scan = NimBLEDevice::getScan();
     scan->stop();
     s_scanning = false;
-    lv_async_call([](void *) {
-        if (!battery_screen_active()) return;
-        ui_battery_set_scan_progress("Idle");
-        if (!s_bms.is_connected()) {
-            ui_battery_set_connection_state(UI_BATT_DISCONNECTED, NULL, NULL);
-        }
-    }, nullptr);
+    ui_msg_post_conn_state(UI_BATT_DISCONNECTED, UI_SCAN_EVT_FINISHED);
+}
+
+void ant_bms_ble_module_set_autoconnect(bool enable)
+{
+    s_autoconnect = enable;
+    if (!enable) bg_scan_stop();
+}
+
+void ant_bms_ble_module_set_bg_scan_duty(uint16_t interval_ms, uint16_t window_ms)
+{
+    if (interval_ms < 3) interval_ms = 3;
+    if (window_ms < 3) window_ms = 3;
+    if (window_ms > interval_ms) window_ms = interval_ms;
+    s_bg_interval_ms = interval_ms;
+    s_bg_window_ms = window_ms;
+    // Restart with the new parameters on the next tick.
+    bg_scan_stop();
+}
+
+void ant_bms_ble_module_forget_known()
+{
+    bg_scan_stop();
+    for (int i = 0; i < s_known_count; i++) {
+        (void)NimBLEDevice::whiteListRemove(NimBLEAddress(s_known_macs[i]));
+        s_known_macs[i][0] = '\0';
+    }
+    s_known_count = 0;
+    save_known();
+}
+
+int ant_bms_ble_module_known_count()
+{
+    return s_known_count;
 }
 
 void ant_bms_ble_module_tick(uint32_t now_ms)
@@ -220,113 +416,53 @@ void ant_bms_ble_module_tick(uint32_t now_ms)
 
     bool battery_active = battery_screen_active();
     if (battery_active && !s_battery_was_active) {
-        // Screen just became active: force refresh on next update.
-        s_last_pack_ms = 0;
-        s_last_temps_ms = 0;
-        s_last_cells_ms = 0;
-        s_last_pack_v = -9999.0f;
-        s_last_pack_a = -9999.0f;
-        s_last_t1 = -9999.0f;
-        s_last_t2 = -9999.0f;
-        s_last_tmos = -9999.0f;
-        s_last_delta = -9999.0f;
-        s_last_low_v = -9999.0f;
-        s_last_high_v = -9999.0f;
-        s_last_low_i = -1;
-        s_last_high_i = -1;
-        s_last_cell_count = -1;
-        s_last_soc = -9999.0f;
-        for (int i = 0; i < 32; i++) s_last_cell_v[i] = -9999.0f;
-
-        lv_async_call([](void *) {
-            if (!battery_screen_active()) return;
-            ui_battery_set_connection_state(s_bms.is_connected() ? UI_BATT_CONNECTED : UI_BATT_DISCONNECTED,
-                                            NULL, s_target_mac);
-        }, nullptr);
+        // Bound widgets catch up by themselves; only the connection row is pushed.
+        ui_msg_post_conn_state(s_bms.is_connected() ? UI_BATT_CONNECTED : UI_BATT_DISCONNECTED,
+                               UI_SCAN_EVT_NONE);
+        s_ui_conn_state = -1;
     }
     if (!battery_active && s_battery_was_active) {
         ant_bms_ble_module_scan_stop();
     }
     s_battery_was_active = battery_active;
 
+    if (s_bg_match.load()) {
+        // Scan already stopped in the callback; connect right away.
+        s_bg_scanning = false;
+        ant_bms_ble_module_set_target(s_bg_match_mac);
+        s_bg_match.store(false);
+        s_connect_requested = true;
+    }
+
     if (s_connect_requested && s_target_mac[0] != '\0' && !s_bms.is_connected()) {
+        bg_scan_stop();
         NimBLEAddress addr(s_target_mac);
-        (void)s_bms.begin(addr);
+        if (s_bms.begin(addr)) {
+            remember_known(s_target_mac);
+        } else {
+            s_bg_retry_ms = now_ms;
+        }
         s_connect_requested = false;
         if (battery_active) {
             ui_battery_set_connection_state(UI_BATT_CONNECTING, NULL, s_target_mac);
+            s_ui_conn_state = UI_BATT_CONNECTING;
         }
     }
 
+    if (s_autoconnect && !s_autoconnect_suspended && s_known_count > 0 &&
+        !s_bms.is_connected() && !s_connect_requested && !s_scanning && !s_bg_scanning &&
+        (now_ms - s_bg_retry_ms) >= kBgRetryMs) {
+        bg_scan_start(now_ms);
+    }
+
     s_bms.tick(now_ms);
 
-    if (s_bms.is_connected()) {
-        if (battery_active && !is_battery_scrolling()) {
-            ui_battery_set_connection_state(UI_BATT_CONNECTED, NULL, s_target_mac);
-        }
-        if (battery_active && !is_battery_scrolling() && s_bms.has_status()) {
-            const auto &st = s_bms.status();
-            // Pack values: ~4 Hz or on change
-            if ((now_ms - s_last_pack_ms) >= 250 ||
-                st.total_voltage_v != s_last_pack_v ||
-                st.current_a != s_last_pack_a ||
-                (st.charge_mosfet_status == 0x01) != s_last_chg_on ||
-                (st.discharge_mosfet_status == 0x01) != s_last_dsg_on) {
-                s_last_pack_ms = now_ms;
-                s_last_pack_v = st.total_voltage_v;
-                s_last_pack_a = st.current_a;
-                s_last_chg_on = (st.charge_mosfet_status == 0x01);
-                s_last_dsg_on = (st.discharge_mosfet_status == 0x01);
-                ui_battery_set_pack_values(st.total_voltage_v, st.current_a, s_last_chg_on, s_last_dsg_on);
-            }
-            if (!isnan(st.soc_pct) && st.soc_pct != s_last_soc) {
-                s_last_soc = st.soc_pct;
-                ui_battery_set_soc(st.soc_pct);
-            }
-
-            // Temps: ~2 Hz or on change
-            if ((now_ms - s_last_temps_ms) >= 500 ||
-                st.temp_c[0] != s_last_t1 ||
-                st.temp_c[1] != s_last_t2 ||
-                st.temp_c[6] != s_last_tmos) {
-                s_last_temps_ms = now_ms;
-                s_last_t1 = st.temp_c[0];
-                s_last_t2 = st.temp_c[1];
-                s_last_tmos = st.temp_c[6];
-                ui_battery_set_temps_all(st.temp_c, st.temp_sensor_count, st.temp_c[6], true);
-            }
-
-            // Cell summary: ~1 Hz or on change
-            int low_i = (int)(st.min_cell_idx > 0 ? (st.min_cell_idx - 1) : 0);
-            int high_i = (int)(st.max_cell_idx > 0 ? (st.max_cell_idx - 1) : 0);
-            if ((now_ms - s_last_cells_ms) >= 1000 ||
-                st.delta_cell_v != s_last_delta ||
-                st.min_cell_v != s_last_low_v ||
-                st.max_cell_v != s_last_high_v ||
-                low_i != s_last_low_i ||
-                high_i != s_last_high_i) {
-                s_last_cells_ms = now_ms;
-                s_last_delta = st.delta_cell_v;
-                s_last_low_v = st.min_cell_v;
-                s_last_high_v = st.max_cell_v;
-                s_last_low_i = low_i;
-                s_last_high_i = high_i;
-                ui_battery_set_cell_summary(st.delta_cell_v, low_i, st.min_cell_v, high_i, st.max_cell_v);
-            }
-
-            // Cell list: ~1 Hz or on change count/values
-            if ((now_ms - s_last_cells_ms) >= 1000 || st.cell_count != s_last_cell_count) {
-                s_last_cell_count = st.cell_count;
-                ui_battery_cells_set_count(st.cell_count);
-                for (int i = 0; i < st.cell_count && i < 32; i++) {
-                    if (st.cell_v[i] != s_last_cell_v[i]) {
-                        s_last_cell_v[i] = st.cell_v[i];
-                        ui_battery_cells_set_value(i, st.cell_v[i]);
-                    }
-                }
-            }
-        }
-    } else if (!s_scanning && battery_active && !is_battery_scrolling()) {
-        ui_battery_set_connection_state(UI_BATT_DISCONNECTED, NULL, NULL);
+    // Connection row only changes on edges; re-setting identical text would
+    // still invalidate the labels every loop.
+    int conn_state = s_bms.is_connected() ? UI_BATT_CONNECTED : (s_scanning ? -1 : UI_BATT_DISCONNECTED);
+    if (battery_active && conn_state >= 0 && conn_state != s_ui_conn_state) {
+        ui_battery_set_connection_state((ui_battery_conn_state_t)conn_state, NULL,
+                                        conn_state == UI_BATT_CONNECTED ? s_target_mac : NULL);
+        s_ui_conn_state = conn_state;
     }
 }
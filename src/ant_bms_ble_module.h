@@ -7,6 +7,31 @@
 extern "C" {
 #endif
 
+#define ANT_BMS_MAX_CELLS 32
+#define ANT_BMS_MAX_TEMPS 8
+#define ANT_BMS_TEMP_UNKNOWN INT16_MIN
+#define ANT_BMS_UNKNOWN INT32_MIN     // pack_mv/current_ma/power_w not reported (== TELEM_UNKNOWN)
+
+// One parsed status frame, published on HUB_CH_BMS. Fixed point so it can be
+// copied between cores and logged as-is.
+typedef struct {
+    int32_t pack_mv;
+    int32_t current_ma;
+    int32_t power_w;
+    uint16_t soc_dpct;            // 0.1 %
+    uint8_t cell_count;
+    uint8_t temp_count;
+    uint8_t charge_on;
+    uint8_t discharge_on;
+    uint8_t min_cell_idx;         // 1-based, as reported
+    uint8_t max_cell_idx;
+    uint16_t min_cell_mv;
+    uint16_t max_cell_mv;
+    uint16_t delta_cell_mv;
+    int16_t temp_dc[ANT_BMS_MAX_TEMPS];   // 0.1 degC, sensors + MOSFET + balancer
+    uint16_t cell_mv[ANT_BMS_MAX_CELLS];
+} ant_bms_sample_t;
+
 // Init ANT BMS BLE client module (requires NimBLEDevice already initialized).
 void ant_bms_ble_module_init();
 
@@ -31,6 +56,13 @@ void ant_bms_ble_module_flush_ui();
 void ant_bms_ble_module_scan_start();
 void ant_bms_ble_module_scan_stop();
 
+// Background discovery: passive scan filtered by the controller's accept list
+// (packs we connected to before) and auto-connect on the first advert seen.
+void ant_bms_ble_module_set_autoconnect(bool enable);
+void ant_bms_ble_module_set_bg_scan_duty(uint16_t interval_ms, uint16_t window_ms);
+void ant_bms_ble_module_forget_known();
+int ant_bms_ble_module_known_count();
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
@@ -0,0 +1,247 @@
+#include "asset_pack.h"
+#include "asset_pack_format.h"
+
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "esp_partition.h"
+#include "esp_timer.h"
+#endif
+
+static_assert(sizeof(lv_font_fmt_txt_glyph_dsc_t) == 8, "asset packs store glyph descriptors for LV_FONT_FMT_TXT_LARGE 0");
+
+enum : uint8_t {
+    ENTRY_UNCHECKED = 0,
+    ENTRY_CHECKED,   // blob passed its checks, no descriptor yet
+    ENTRY_OK,        // descriptor built, s_slot[] is valid
+    ENTRY_BAD,
+};
+
+struct PackFont {
+    lv_font_t font;
+    lv_font_fmt_txt_dsc_t dsc;
+    lv_font_fmt_txt_kern_pair_t kern;
+};
+
+static const uint8_t *s_base;
+static const asset_pack_entry_t *s_entries;
+static asset_pack_stats_t s_stats;
+
+static uint8_t s_state[ASSET_PACK_MAX_ENTRIES];
+static uint8_t s_slot[ASSET_PACK_MAX_ENTRIES];   // index into the font or image pool
+static PackFont s_fonts[ASSET_PACK_MAX_FONTS];
+static lv_image_dsc_t s_images[ASSET_PACK_MAX_IMAGES];
+static lv_font_fmt_txt_cmap_t s_cmaps[ASSET_PACK_MAX_CMAPS];
+static uint16_t s_cmaps_used;
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+static uint32_t now_us(void)
+{
+#if defined(ESP_PLATFORM)
+    return (uint32_t)esp_timer_get_time();
+#else
+    return 0;
+#endif
+}
+
+// [ofs, ofs + len) inside a blob of `size` bytes.
+static bool in_blob(uint32_t ofs, uint32_t len, uint32_t size)
+{
+    return ofs <= size && len <= size - ofs;
+}
+
+bool asset_pack_open(const void *base, size_t size)
+{
+    s_base = nullptr;
+    s_entries = nullptr;
+    memset(&s_stats, 0, sizeof(s_stats));
+    memset(s_state, ENTRY_UNCHECKED, sizeof(s_state));
+    s_cmaps_used = 0;
+
+    const uint32_t t0 = now_us();
+    if (!base || ((uintptr_t)base & (ASSET_PACK_ALIGN - 1)) || size < sizeof(asset_pack_header_t)) return false;
+    const asset_pack_header_t *h = (const asset_pack_header_t *)base;
+    if (h->magic != ASSET_PACK_MAGIC || h->version != ASSET_PACK_VERSION) return false;
+    if (h->count > ASSET_PACK_MAX_ENTRIES || h->total_bytes > size) return false;
+    const uint32_t table_bytes = (uint32_t)h->count * sizeof(asset_pack_entry_t);
+    if (!in_blob(sizeof(*h), table_bytes, h->total_bytes)) return false;
+    const uint8_t *table = (const uint8_t *)base + sizeof(*h);
+    if (crc32_update(0, table, table_bytes) != h->crc32) return false;
+
+    s_base = (const uint8_t *)base;
+    s_entries = (const asset_pack_entry_t *)table;
+    s_stats.pack_bytes = h->total_bytes;
+    s_stats.entries = h->count;
+    s_stats.map_us = now_us() - t0;
+    return true;
+}
+
+bool asset_pack_mount(void)
+{
+#if defined(ESP_PLATFORM)
+    static esp_partition_mmap_handle_t s_map;
+    static const void *s_map_base;
+    const uint32_t t0 = now_us();
+    if (!s_map_base) {
+        const esp_partition_t *part =
+            esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, ASSET_PACK_PARTITION);
+        if (!part) return false;
+        asset_pack_header_t h;
+        if (esp_partition_read(part, 0, &h, sizeof(h)) != ESP_OK) return false;
+        if (h.magic != ASSET_PACK_MAGIC || h.total_bytes < sizeof(h) || h.total_bytes > part->size) return false;
+        // Map only the pack, not the whole partition: MMU pages are scarce.
+        if (esp_partition_mmap(part, 0, h.total_bytes, ESP_PARTITION_MMAP_DATA, &s_map_base, &s_map) != ESP_OK) {
+            s_map_base = nullptr;
+            return false;
+        }
+    }
+    const asset_pack_header_t *h = (const asset_pack_header_t *)s_map_base;
+    if (!asset_pack_open(s_map_base, h->total_bytes)) return false;
+    s_stats.map_us = now_us() - t0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+static int find_entry(const char *name, uint8_t type)
+{
+    if (!s_entries || !name) return -1;
+    for (int i = 0; i < s_stats.entries; i++) {
+        const asset_pack_entry_t *e = &s_entries[i];
+        if (e->type == type && strncmp(e->name, name, ASSET_PACK_NAME_LEN) == 0) return i;
+    }
+    return -1;
+}
+
+// Bounds and CRC of a blob, once per entry.
+static bool check_entry(int i)
+{
+    if (s_state[i] != ENTRY_UNCHECKED) return s_state[i] != ENTRY_BAD;
+    const asset_pack_entry_t *e = &s_entries[i];
+    bool ok = (e->offset & (ASSET_PACK_ALIGN - 1)) == 0 && in_blob(e->offset, e->size, s_stats.pack_bytes) &&
+              crc32_update(0, s_base + e->offset, e->size) == e->crc32;
+    s_state[i] = ok ? ENTRY_CHECKED : ENTRY_BAD;
+    if (!ok) s_stats.bad++;
+    return ok;
+}
+
+static bool build_font(const asset_pack_entry_t *e, PackFont *pf)
+{
+    const uint8_t *blob = s_base + e->offset;
+    if (e->size < sizeof(asset_font_header_t)) return false;
+    const asset_font_header_t *fh = (const asset_font_header_t *)blob;
+    if (fh->cmap_num == 0 || fh->cmap_num > ASSET_PACK_MAX_CMAPS - s_cmaps_used) return false;
+    if (!in_blob(fh->glyph_dsc_ofs, fh->glyph_count * 8u, e->size) || (fh->glyph_dsc_ofs & 3)) return false;
+    if (!in_blob(fh->cmaps_ofs, fh->cmap_num * (uint32_t)sizeof(asset_font_cmap_t), e->size)) return false;
+    if (!in_blob(fh->bitmap_ofs, 0, e->size)) return false;
+    if (fh->kern_pair_cnt && (!in_blob(fh->kern_ids_ofs, fh->kern_pair_cnt * 2u, e->size) ||
+                              !in_blob(fh->kern_values_ofs, fh->kern_pair_cnt, e->size))) {
+        return false;
+    }
+
+    lv_font_fmt_txt_cmap_t *cmaps = &s_cmaps[s_cmaps_used];
+    const asset_font_cmap_t *src = (const asset_font_cmap_t *)(blob + fh->cmaps_ofs);
+    for (int i = 0; i < fh->cmap_num; i++) {
+        lv_font_fmt_txt_cmap_t *c = &cmaps[i];
+        memset(c, 0, sizeof(*c));
+        c->range_start = src[i].range_start;
+        c->range_length = src[i].range_length;
+        c->glyph_id_start = src[i].glyph_id_start;
+        c->list_length = src[i].list_length;
+        c->type = (lv_font_fmt_txt_cmap_type_t)src[i].type;
+        if (src[i].unicode_list_ofs) {
+            if (!in_blob(src[i].unicode_list_ofs, src[i].list_length * 2u, e->size)) return false;
+            c->unicode_list = (const uint16_t *)(blob + src[i].unicode_list_ofs);
+        }
+        if (src[i].glyph_id_ofs_ofs) {
+            if (!in_blob(src[i].glyph_id_ofs_ofs, 0, e->size)) return false;
+            c->glyph_id_ofs_list = blob + src[i].glyph_id_ofs_ofs;
+        }
+    }
+    s_cmaps_used += fh->cmap_num;
+
+    memset(pf, 0, sizeof(*pf));
+    lv_font_fmt_txt_dsc_t *d = &pf->dsc;
+    d->glyph_bitmap = blob + fh->bitmap_ofs;
+    d->glyph_dsc = (const lv_font_fmt_txt_glyph_dsc_t *)(blob + fh->glyph_dsc_ofs);
+    d->cmaps = cmaps;
+    d->cmap_num = fh->cmap_num;
+    d->kern_scale = fh->kern_scale;
+    d->bpp = e->u.font.bpp;
+    d->bitmap_format = e->u.font.bitmap_format;
+    if (fh->kern_pair_cnt) {
+        pf->kern.glyph_ids = blob + fh->kern_ids_ofs;
+        pf->kern.values = (const int8_t *)(blob + fh->kern_values_ofs);
+        pf->kern.pair_cnt = fh->kern_pair_cnt;
+        d->kern_dsc = &pf->kern;
+    }
+
+    lv_font_t *f = &pf->font;
+    f->get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+    f->get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+    f->line_height = e->u.font.line_height;
+    f->base_line = e->u.font.base_line;
+    f->subpx = LV_FONT_SUBPX_NONE;
+    f->underline_position = e->u.font.underline_position;
+    f->underline_thickness = (int8_t)e->u.font.underline_thickness;
+    f->dsc = d;
+    return true;
+}
+
+const lv_font_t *asset_pack_font(const char *name)
+{
+    const int i = find_entry(name, ASSET_FONT);
+    if (i < 0) return NULL;
+    if (s_state[i] == ENTRY_OK) return &s_fonts[s_slot[i]].font;
+    if (!check_entry(i) || s_stats.fonts >= ASSET_PACK_MAX_FONTS) return NULL;
+
+    const asset_pack_entry_t *e = &s_entries[i];
+    const uint8_t bpp = e->u.font.bpp;
+    if ((bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8) ||
+        (e->u.font.bitmap_format != LV_FONT_FMT_TXT_PLAIN && !LV_USE_FONT_COMPRESSED) ||
+        !build_font(e, &s_fonts[s_stats.fonts])) {
+        s_state[i] = ENTRY_BAD;
+        s_stats.bad++;
+        return NULL;
+    }
+    s_slot[i] = (uint8_t)s_stats.fonts++;
+    s_state[i] = ENTRY_OK;
+    return &s_fonts[s_slot[i]].font;
+}
+
+const lv_image_dsc_t *asset_pack_image(const char *name)
+{
+    const int i = find_entry(name, ASSET_IMAGE);
+    if (i < 0) return NULL;
+    if (s_state[i] == ENTRY_OK) return &s_images[s_slot[i]];
+    if (!check_entry(i) || s_stats.images >= ASSET_PACK_MAX_IMAGES) return NULL;
+
+    const asset_pack_entry_t *e = &s_entries[i];
+    lv_image_dsc_t *img = &s_images[s_stats.images];
+    memset(img, 0, sizeof(*img));
+    img->header.magic = LV_IMAGE_HEADER_MAGIC;
+    img->header.cf = e->u.image.cf;
+    img->header.w = e->u.image.w;
+    img->header.h = e->u.image.h;
+    img->header.stride = e->u.image.stride;
+    img->data_size = e->size;
+    img->data = s_base + e->offset;
+    s_slot[i] = (uint8_t)s_stats.images++;
+    s_state[i] = ENTRY_OK;
+    return img;
+}
+
+void asset_pack_get_stats(asset_pack_stats_t *out)
+{
+    *out = s_stats;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fonts and images from an asset pack (format in asset_pack_format.h,
+// built by extras/asset_pack.py) in the "assets" flash partition. The
+// partition is memory-mapped once and the assets are used in place: a lookup
+// returns an lv_font_t / lv_image_dsc_t from a static pool that points into
+// the mapping, so no asset bytes are copied and nothing comes from the heap.
+// A pack can be flashed on its own (extras/asset_pack.py --flash) without
+// rebuilding the firmware.
+
+#define ASSET_PACK_PARTITION "assets"
+#define ASSET_PACK_MAX_ENTRIES 64
+#define ASSET_PACK_MAX_FONTS 8
+#define ASSET_PACK_MAX_IMAGES 32
+#define ASSET_PACK_MAX_CMAPS 32        // shared by all fonts
+
+typedef struct {
+    uint32_t pack_bytes;       // 0: no valid pack mounted
+    uint16_t entries;
+    uint16_t fonts;            // descriptors handed out so far
+    uint16_t images;
+    uint16_t bad;              // entries that failed their CRC or bounds check
+    uint32_t map_us;           // time to map and check the entry table
+} asset_pack_stats_t;
+
+// Map the partition and check the header and entry table. False (and every
+// lookup NULL) if there is no partition or no valid pack in it.
+bool asset_pack_mount(void);
+
+// Same for a pack that is already in memory (e.g. an mmap()ed file on a
+// host). `base` must stay valid and 4-byte aligned.
+bool asset_pack_open(const void *base, size_t size);
+
+// NULL if the pack has no such asset of that type, its CRC fails or the
+// pool for that type (ASSET_PACK_MAX_FONTS / _IMAGES) is full. The
+// first lookup checks the blob; later ones return the same descriptor.
+const lv_font_t *asset_pack_font(const char *name);
+const lv_image_dsc_t *asset_pack_image(const char *name);
+
+void asset_pack_get_stats(asset_pack_stats_t *out);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
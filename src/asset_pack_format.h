@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+
+// Asset pack layout (little-endian). extras/asset_pack.py writes it; the
+// "assets" flash partition holds one pack, memory-mapped at boot.
+//
+//   pack  := pack_header entry[count] blob*
+//
+// Blobs start at ASSET_PACK_ALIGN boundaries and are used in place: image
+// pixels are the lv_image_dsc_t data, and font blobs hold the tables of an
+// lv_font_fmt_txt_dsc_t exactly as LVGL reads them (8-byte glyph
+// descriptors as with LV_FONT_FMT_TXT_LARGE 0), so only the small
+// descriptors that point at them live in RAM.
+//
+// The header CRC covers the entry table; each entry's CRC covers its blob
+// and is checked the first time the asset is looked up.
+
+#define ASSET_PACK_MAGIC 0x4B505341u       // "ASPK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGN 4
+#define ASSET_PACK_NAME_LEN 24
+
+typedef enum {
+    ASSET_FONT = 1,
+    ASSET_IMAGE = 2,
+} asset_type_t;
+
+#pragma pack(push, 1)
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;            // entries after the header
+    uint32_t total_bytes;      // whole pack, header included
+    uint32_t crc32;            // IEEE CRC-32 of the entry table
+} asset_pack_header_t;
+
+typedef struct {
+    char name[ASSET_PACK_NAME_LEN];   // NUL-terminated
+    uint8_t type;              // asset_type_t
+    uint8_t reserved[3];
+    uint32_t offset;           // blob, from the start of the pack
+    uint32_t size;
+    uint32_t crc32;            // IEEE CRC-32 of the blob
+    union {
+        struct {
+            uint16_t w;
+            uint16_t h;
+            uint16_t stride;   // 0: LVGL derives it from w and cf
+            uint8_t cf;        // lv_color_format_t
+            uint8_t reserved;
+        } image;
+        struct {
+            uint16_t line_height;
+            int16_t base_line;
+            int8_t underline_position;
+            uint8_t underline_thickness;
+            uint8_t bpp;
+            uint8_t bitmap_format;     // lv_font_fmt_txt_bitmap_format_t
+        } font;
+    } u;
+} asset_pack_entry_t;
+
+// Font blob header; offsets are from the start of the blob.
+typedef struct {
+    uint16_t glyph_count;      // glyph descriptors, id 0 included
+    uint16_t cmap_num;
+    uint16_t kern_scale;
+    uint16_t kern_pair_cnt;    // 0: no kerning
+    uint32_t glyph_dsc_ofs;    // lv_font_fmt_txt_glyph_dsc_t[glyph_count]
+    uint32_t bitmap_ofs;
+    uint32_t cmaps_ofs;        // asset_font_cmap_t[cmap_num]
+    uint32_t kern_ids_ofs;     // uint8_t[2 * kern_pair_cnt]
+    uint32_t kern_values_ofs;  // int8_t[kern_pair_cnt]
+} asset_font_header_t;
+
+typedef struct {
+    uint32_t range_start;
+    uint16_t range_length;
+    uint16_t glyph_id_start;
+    uint16_t list_length;
+    uint8_t type;              // lv_font_fmt_txt_cmap_type_t
+    uint8_t reserved;
+    uint32_t unicode_list_ofs;     // uint16_t[list_length], 0: none
+    uint32_t glyph_id_ofs_ofs;     // glyph_id_ofs_list, 0: none
+} asset_font_cmap_t;
+
+#pragma pack(pop)
@@ -0,0 +1,166 @@
+#include "ble_links.h"
+
+#include <Arduino.h>
+#include <NimBLEDevice.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Connection intervals in 1.25 ms units. The VESC link is request/response
+// at up to 50 Hz, so it gets the shortest interval; the BMS link answers one
+// status frame per second. Its interval is a multiple of the VESC one so the
+// two links' connection events keep a fixed phase instead of drifting into
+// each other.
+static constexpr uint16_t kVescInterval = 6;            // 7.5 ms
+static constexpr uint16_t kBmsIntervalShared = 48;      // 60 ms, VESC also connected
+static constexpr uint16_t kBmsIntervalAlone = 24;       // 30 ms
+static constexpr uint16_t kSupervisionTimeout = 400;    // 4 s, in 10 ms units
+
+struct Link {
+    NimBLEClient *client;
+    bool connected;
+    ble_link_stats_t stats;
+    uint32_t last_rx_ms;
+    uint32_t window_start_ms;
+    uint32_t window_bytes;
+};
+
+static Link s_links[BLE_LINK_COUNT];
+static SemaphoreHandle_t s_connect_mutex = nullptr;
+// Guards Link::client/connected. rebalance() runs on whichever task's link
+// changed but talks to the BMS client, which its own task may be deleting;
+// ble_link_disconnected() takes this before the owner deletes the client.
+static SemaphoreHandle_t s_client_mutex = nullptr;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static bool valid(ble_link_id_t link)
+{
+    return link >= 0 && link < BLE_LINK_COUNT;
+}
+
+static uint16_t interval_for(ble_link_id_t link)
+{
+    if (link == BLE_LINK_VESC) return kVescInterval;
+    return s_links[BLE_LINK_VESC].connected ? kBmsIntervalShared : kBmsIntervalAlone;
+}
+
+// Re-request parameters for the BMS link when the VESC link comes or goes.
+// Caller holds s_client_mutex.
+static void rebalance()
+{
+    Link &bms = s_links[BLE_LINK_BMS];
+    if (!bms.connected || !bms.client || !bms.client->isConnected()) return;
+    uint16_t itvl = interval_for(BLE_LINK_BMS);
+    if (itvl == bms.stats.interval_1250us) return;
+    bms.client->updateConnParams(itvl, itvl, 0, kSupervisionTimeout);
+    bms.stats.interval_1250us = itvl;
+}
+
+void ble_links_init(void)
+{
+    if (s_connect_mutex) return;
+    s_client_mutex = xSemaphoreCreateMutex();
+    s_connect_mutex = xSemaphoreCreateMutex();
+}
+
+bool ble_link_connect(ble_link_id_t link, NimBLEClient *client, const NimBLEAddress &addr)
+{
+    if (!valid(link) || !client || !s_connect_mutex) return false;
+
+    uint16_t itvl = interval_for(link);
+    client->setConnectionParams(itvl, itvl, 0, kSupervisionTimeout);
+    client->setConnectTimeout(5);
+
+    xSemaphoreTake(s_connect_mutex, portMAX_DELAY);
+    bool ok = client->connect(addr);
+    if (ok) {
+        xSemaphoreTake(s_client_mutex, portMAX_DELAY);
+        Link &l = s_links[link];
+        l.client = client;
+        l.connected = true;
+        l.stats.connects++;
+        l.stats.interval_1250us = itvl;
+        l.last_rx_ms = 0;
+        l.window_start_ms = millis();
+        l.window_bytes = 0;
+        rebalance();
+        xSemaphoreGive(s_client_mutex);
+    }
+    xSemaphoreGive(s_connect_mutex);
+    return ok;
+}
+
+void ble_link_disconnected(ble_link_id_t link)
+{
+    if (!valid(link) || !s_client_mutex) return;
+    xSemaphoreTake(s_client_mutex, portMAX_DELAY);
+    Link &l = s_links[link];
+    if (l.connected) {
+        l.connected = false;
+        l.client = nullptr;
+        l.stats.disconnects++;
+        l.stats.interval_1250us = 0;
+        rebalance();
+    }
+    xSemaphoreGive(s_client_mutex);
+}
+
+void ble_link_note_rx(ble_link_id_t link, uint32_t len)
+{
+    if (!valid(link)) return;
+    Link &l = s_links[link];
+    const uint32_t now = millis();
+    portENTER_CRITICAL(&s_mux);
+    l.stats.rx_notifies++;
+    l.stats.rx_bytes += len;
+    if (l.last_rx_ms != 0 && now - l.last_rx_ms > l.stats.max_rx_gap_ms) {
+        l.stats.max_rx_gap_ms = now - l.last_rx_ms;
+    }
+    l.last_rx_ms = now;
+    l.window_bytes += len;
+    if (now - l.window_start_ms >= 1000) {
+        l.stats.rx_bps = (uint32_t)((uint64_t)l.window_bytes * 1000 / (now - l.window_start_ms));
+        l.window_start_ms = now;
+        l.window_bytes = 0;
+    }
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void ble_link_note_tx(ble_link_id_t link, bool ok)
+{
+    if (!valid(link)) return;
+    portENTER_CRITICAL(&s_mux);
+    s_links[link].stats.tx_writes++;
+    if (!ok) s_links[link].stats.tx_failures++;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void ble_link_note_rtt(ble_link_id_t link, uint32_t rtt_us)
+{
+    if (!valid(link)) return;
+    portENTER_CRITICAL(&s_mux);
+    ble_link_stats_t &st = s_links[link].stats;
+    st.last_rtt_us = rtt_us;
+    st.avg_rtt_us = (st.avg_rtt_us == 0) ? rtt_us : (st.avg_rtt_us * 7 + rtt_us) / 8;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void ble_link_clear_gap(ble_link_id_t link)
+{
+    if (!valid(link)) return;
+    portENTER_CRITICAL(&s_mux);
+    s_links[link].stats.max_rx_gap_ms = 0;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void ble_link_get_stats(ble_link_id_t link, ble_link_stats_t *out)
+{
+    if (!out || !valid(link)) return;
+    portENTER_CRITICAL(&s_mux);
+    *out = s_links[link].stats;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+bool ble_link_is_connected(ble_link_id_t link)
+{
+    return valid(link) && s_links[link].connected;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shared NimBLE host bookkeeping for the concurrent client links (BMS and
+// VESC). Serializes connection setup, picks connection parameters so the
+// fast VESC link and the slow BMS link interleave without starving each
+// other, and keeps per-link throughput/latency counters.
+
+typedef enum {
+    BLE_LINK_BMS = 0,
+    BLE_LINK_VESC,
+    BLE_LINK_COUNT,
+} ble_link_id_t;
+
+typedef struct {
+    uint32_t connects;
+    uint32_t disconnects;
+    uint32_t rx_notifies;
+    uint32_t rx_bytes;
+    uint32_t rx_bps;              // bytes/s over the last full second
+    uint32_t max_rx_gap_ms;       // longest silence between notifications
+    uint32_t tx_writes;
+    uint32_t tx_failures;
+    uint32_t last_rtt_us;         // request -> matching reply
+    uint32_t avg_rtt_us;          // EWMA, 1/8 weight
+    uint16_t interval_1250us;     // connection interval currently requested
+} ble_link_stats_t;
+
+// Creates the link locks. Call once from setup, before any task connects.
+void ble_links_init(void);
+
+// Counters. Safe from the NimBLE host task and from the link's own task.
+void ble_link_note_rx(ble_link_id_t link, uint32_t len);
+void ble_link_note_tx(ble_link_id_t link, bool ok);
+void ble_link_note_rtt(ble_link_id_t link, uint32_t rtt_us);
+void ble_link_clear_gap(ble_link_id_t link);
+
+void ble_link_get_stats(ble_link_id_t link, ble_link_stats_t *out);
+bool ble_link_is_connected(ble_link_id_t link);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+
+class NimBLEClient;
+class NimBLEAddress;
+
+// Connect `client` for `link` with the link's connection parameters. Only
+// one GAP connection procedure runs at a time; callers on other tasks wait.
+bool ble_link_connect(ble_link_id_t link, NimBLEClient *client, const NimBLEAddress &addr);
+// Call before deleting the client (or after it dropped). Once it returns
+// the other link's task no longer touches the client.
+void ble_link_disconnected(ble_link_id_t link);
+#endif
@@ -0,0 +1,480 @@
+#include "dlog.h"
+#include "usb_stream.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static constexpr uint32_t kCells = 128;
+static constexpr size_t kCellData = 28;
+static constexpr int kMaxSites = 128;
+static constexpr uint16_t kIdPending = 0xFFFF;
+static constexpr uint32_t kTaskPeriodMs = 20;
+static constexpr uint8_t kFlagText = 0x01;
+
+static_assert((kCells & (kCells - 1)) == 0, "capacity must be a power of two");
+
+// Record header; the payload follows it across as many cells as needed.
+struct __attribute__((packed)) RecordHeader {
+    uint16_t site;
+    uint8_t len;                  // payload bytes
+    uint8_t flags;
+    uint32_t t_us;
+    uint16_t suppressed;
+    uint16_t reserved;
+};
+
+static constexpr size_t kMaxPayload = (DLOG_MAX_TEXT > DLOG_MAX_ARGS * 4) ? DLOG_MAX_TEXT : DLOG_MAX_ARGS * 4;
+static constexpr size_t kMaxRecordCells = (sizeof(RecordHeader) + kMaxPayload + kCellData - 1) / kCellData;
+static_assert(kMaxPayload <= 255, "len is a byte");
+
+// Bounded MPSC ring (Vyukov) where a record may claim several consecutive
+// cells with one CAS. Cells are released in order, so when the last cell
+// of a claim is free all the ones before it are too.
+struct Cell {
+    std::atomic<uint32_t> seq;
+    uint8_t data[kCellData];
+};
+
+static Cell s_cells[kCells];
+static std::atomic<uint32_t> s_head{0};
+static std::atomic<uint32_t> s_tail{0};
+// Serial formatter and USB source never consume at the same time.
+static std::atomic_flag s_consumer = ATOMIC_FLAG_INIT;
+
+static struct CellInit {
+    CellInit()
+    {
+        for (uint32_t i = 0; i < kCells; i++) s_cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+} s_cell_init;
+
+std::atomic<uint8_t> g_dlog_level{DLOG_MIN_LEVEL};
+
+static dlog_site_t *s_sites[kMaxSites];
+static std::atomic<int> s_site_count{0};
+// dlog_text() records; their ids sit above the call-site table.
+static dlog_site_t s_text_sites[DLOG_DEBUG + 1] = {
+    {"%s", "", 0, DLOG_ERROR, 0, {kMaxSites + 1}, {0}, {0}},
+    {"%s", "", 0, DLOG_WARN, 0, {kMaxSites + 2}, {0}, {0}},
+    {"%s", "", 0, DLOG_INFO, 0, {kMaxSites + 3}, {0}, {0}},
+    {"%s", "", 0, DLOG_DEBUG, 0, {kMaxSites + 4}, {0}, {0}},
+};
+
+static std::atomic<uint32_t> s_written{0};
+static std::atomic<uint32_t> s_dropped{0};
+static std::atomic<uint32_t> s_suppressed{0};
+static uint32_t s_formatted = 0;
+static uint32_t s_streamed = 0;
+static TaskHandle_t s_task = nullptr;
+
+struct Record {
+    RecordHeader h;
+    uint8_t payload[kMaxPayload];
+};
+
+// --- producer side -------------------------------------------------------
+
+static uint16_t site_id(dlog_site_t *site)
+{
+    uint16_t id = site->id.load(std::memory_order_acquire);
+    if (id != 0) return id;
+    uint16_t expected = 0;
+    // Another task is registering this site right now; drop this record.
+    if (!site->id.compare_exchange_strong(expected, kIdPending, std::memory_order_acq_rel)) return expected;
+    // Different sites register concurrently, so the slot is claimed with a
+    // single atomic add; an overflowing claim is handed back.
+    int idx = s_site_count.fetch_add(1, std::memory_order_acq_rel);
+    if (idx >= kMaxSites) {
+        s_site_count.fetch_sub(1, std::memory_order_relaxed);
+        return kIdPending;   // stays pending: the site is never logged
+    }
+    s_sites[idx] = site;
+    id = (uint16_t)(idx + 1);
+    site->id.store(id, std::memory_order_release);
+    return id;
+}
+
+static void cells_copy_in(uint32_t pos, size_t off, const void *src, size_t n)
+{
+    const uint8_t *p = (const uint8_t *)src;
+    while (n > 0) {
+        Cell &c = s_cells[(pos + off / kCellData) & (kCells - 1)];
+        size_t o = off % kCellData;
+        size_t chunk = kCellData - o;
+        if (chunk > n) chunk = n;
+        memcpy(c.data + o, p, chunk);
+        p += chunk;
+        off += chunk;
+        n -= chunk;
+    }
+}
+
+static void cells_copy_out(uint32_t pos, size_t off, void *dst, size_t n)
+{
+    uint8_t *p = (uint8_t *)dst;
+    while (n > 0) {
+        const Cell &c = s_cells[(pos + off / kCellData) & (kCells - 1)];
+        size_t o = off % kCellData;
+        size_t chunk = kCellData - o;
+        if (chunk > n) chunk = n;
+        memcpy(p, c.data + o, chunk);
+        p += chunk;
+        off += chunk;
+        n -= chunk;
+    }
+}
+
+static void push(dlog_site_t *site, uint8_t flags, const void *payload, size_t len)
+{
+    if (site->min_interval_ms) {
+        const uint32_t now = millis();
+        const uint32_t last = site->last_ms.load(std::memory_order_relaxed);
+        if (last != 0 && now - last < site->min_interval_ms) {
+            site->suppressed.fetch_add(1, std::memory_order_relaxed);
+            s_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        site->last_ms.store(now ? now : 1, std::memory_order_relaxed);
+    }
+    const uint16_t id = site_id(site);
+    if (id == kIdPending) {
+        s_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint32_t k = (uint32_t)((sizeof(RecordHeader) + len + kCellData - 1) / kCellData);
+    uint32_t pos = s_head.load(std::memory_order_relaxed);
+    for (;;) {
+        const uint32_t last_pos = pos + k - 1;
+        uint32_t seq = s_cells[last_pos & (kCells - 1)].seq.load(std::memory_order_acquire);
+        int32_t dif = (int32_t)(seq - last_pos);
+        if (dif == 0) {
+            if (s_head.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) break;
+        } else if (dif < 0) {
+            s_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = s_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    RecordHeader h;
+    h.site = id;
+    h.len = (uint8_t)len;
+    h.flags = flags;
+    h.t_us = micros();
+    h.suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+    h.reserved = 0;
+    cells_copy_in(pos, 0, &h, sizeof(h));
+    cells_copy_in(pos, sizeof(h), payload, len);
+    for (uint32_t i = 0; i < k; i++) {
+        s_cells[(pos + i) & (kCells - 1)].seq.store(pos + i + 1, std::memory_order_release);
+    }
+    s_written.fetch_add(1, std::memory_order_relaxed);
+}
+
+void dlog_commit(dlog_site_t *site, const uint32_t *words, int count)
+{
+    if (!site) return;
+    if (count > DLOG_MAX_ARGS) count = DLOG_MAX_ARGS;
+    push(site, 0, words, (size_t)count * 4);
+}
+
+void dlog_text(dlog_level_t level, const char *text)
+{
+    if (!text || level > dlog_get_level()) return;
+    size_t n = strnlen(text, DLOG_MAX_TEXT);
+    // LVGL lines end in a newline; the formatter adds its own.
+    while (n > 0 && (text[n - 1] == '\n' || text[n - 1] == '\r')) n--;
+    push(&s_text_sites[level], kFlagText, text, n);
+}
+
+// --- consumer side -------------------------------------------------------
+
+static bool pop(Record *out)
+{
+    const uint32_t pos = s_tail.load(std::memory_order_relaxed);
+    if (s_cells[pos & (kCells - 1)].seq.load(std::memory_order_acquire) != pos + 1) return false;
+    cells_copy_out(pos, 0, &out->h, sizeof(out->h));
+    const uint32_t k = (uint32_t)((sizeof(RecordHeader) + out->h.len + kCellData - 1) / kCellData);
+    if (k > kMaxRecordCells) return false;
+    for (uint32_t i = 1; i < k; i++) {
+        // The producer is still filling the tail of this record.
+        if (s_cells[(pos + i) & (kCells - 1)].seq.load(std::memory_order_acquire) != pos + i + 1) return false;
+    }
+    cells_copy_out(pos, sizeof(out->h), out->payload, out->h.len);
+    for (uint32_t i = 0; i < k; i++) {
+        s_cells[(pos + i) & (kCells - 1)].seq.store(pos + i + kCells, std::memory_order_release);
+    }
+    s_tail.store(pos + k, std::memory_order_relaxed);
+    return true;
+}
+
+static const dlog_site_t *site_of(const Record &r)
+{
+    if (r.h.site > kMaxSites && r.h.site <= kMaxSites + DLOG_DEBUG + 1) return &s_text_sites[r.h.site - kMaxSites - 1];
+    if (r.h.site == 0 || r.h.site > s_site_count.load(std::memory_order_acquire)) return nullptr;
+    return s_sites[r.h.site - 1];
+}
+
+// Parses one conversion starting after '%'. Copies it without length
+// modifiers into `spec` and sets `tag` to how its argument is stored:
+// 'i' / 'u' 32-bit, 'q' / 'Q' 64-bit, 'f' float, 's' string, '%' none.
+static const char *parse_spec(const char *p, char *spec, size_t cap, char *tag)
+{
+    size_t n = 0;
+    spec[n++] = '%';
+    while (*p && strchr("-+ #0123456789.", *p)) {
+        if (n + 3 < cap) spec[n++] = *p;
+        p++;
+    }
+    int longs = 0;
+    while (*p && strchr("hlzjtL", *p)) {
+        if (*p == 'l') longs++;
+        p++;
+    }
+    char conv = *p ? *p++ : '%';
+    switch (conv) {
+    case 'd': case 'i': case 'c': *tag = (longs >= 2) ? 'q' : 'i'; break;
+    case 'u': case 'x': case 'X': case 'o': *tag = (longs >= 2) ? 'Q' : 'u'; break;
+    case 'p': *tag = 'u'; conv = 'x'; if (n + 3 < cap) spec[n++] = '#'; break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': *tag = 'f'; break;
+    case 's': *tag = 's'; break;
+    default: *tag = '%'; conv = '%'; break;
+    }
+    if (*tag == 'q' || *tag == 'Q') {
+        spec[n++] = 'l';
+        spec[n++] = 'l';
+    }
+    spec[n++] = conv;
+    spec[n] = '\0';
+    return p;
+}
+
+static size_t format_record(const Record &r, const dlog_site_t *site, char *out, size_t cap)
+{
+    static const char kLevels[] = "EWID";
+    const char *file = site->file;
+    const char *slash = strrchr(file, '/');
+    if (slash) file = slash + 1;
+    size_t len = 0;
+    auto append = [&](int w) {
+        if (w > 0) len += (size_t)w;
+        if (len >= cap) len = cap - 1;
+    };
+
+    append(snprintf(out, cap, "%c %lu.%03lu ", kLevels[site->level & 3],
+                    (unsigned long)(r.h.t_us / 1000000u), (unsigned long)((r.h.t_us / 1000u) % 1000u)));
+    if (site->line) append(snprintf(out + len, cap - len, "%s:%u ", file, site->line));
+
+    if (r.h.flags & kFlagText) {
+        append(snprintf(out + len, cap - len, "%.*s", (int)r.h.len, (const char *)r.payload));
+    } else {
+        uint32_t words[DLOG_MAX_ARGS];
+        const int count = r.h.len / 4;
+        memcpy(words, r.payload, (size_t)count * 4);
+        int wi = 0;
+        for (const char *p = site->fmt; *p && len < cap - 1;) {
+            if (*p != '%') {
+                out[len++] = *p++;
+                continue;
+            }
+            char spec[16];
+            char tag;
+            p = parse_spec(p + 1, spec, sizeof(spec), &tag);
+            const int need = (tag == 'q' || tag == 'Q') ? 2 : (tag == '%') ? 0 : 1;
+            if (wi + need > count) {
+                append(snprintf(out + len, cap - len, "?"));
+                continue;
+            }
+            switch (tag) {
+            case 'i': append(snprintf(out + len, cap - len, spec, (int)words[wi])); break;
+            case 'u': append(snprintf(out + len, cap - len, spec, (unsigned)words[wi])); break;
+            case 'q':
+            case 'Q': {
+                uint64_t v = (uint64_t)words[wi] | ((uint64_t)words[wi + 1] << 32);
+                append(snprintf(out + len, cap - len, spec, (unsigned long long)v));
+                break;
+            }
+            case 'f': {
+                float f;
+                memcpy(&f, &words[wi], sizeof(f));
+                append(snprintf(out + len, cap - len, spec, (double)f));
+                break;
+            }
+            case 's': {
+                const char *s = (const char *)(uintptr_t)words[wi];
+                append(snprintf(out + len, cap - len, spec, s ? s : "(null)"));
+                break;
+            }
+            default: append(snprintf(out + len, cap - len, "%%")); break;
+            }
+            wi += need;
+        }
+        out[len] = '\0';
+    }
+    if (r.h.suppressed) append(snprintf(out + len, cap - len, " (+%u suppressed)", r.h.suppressed));
+    return len;
+}
+
+static void format_task(void *arg)
+{
+    (void)arg;
+    static Record r;
+    static char line[192];
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(kTaskPeriodMs));
+        // While the binary stream is open the USB source drains the ring.
+        if (usb_stream_is_open() || s_consumer.test_and_set(std::memory_order_acquire)) continue;
+        while (pop(&r)) {
+            const dlog_site_t *site = site_of(r);
+            if (!site) continue;
+            size_t n = format_record(r, site, line, sizeof(line) - 2);
+            line[n++] = '\r';
+            line[n++] = '\n';
+            Serial.write((const uint8_t *)line, n);
+            s_formatted++;
+        }
+        s_consumer.clear(std::memory_order_release);
+    }
+}
+
+// --- USB stream source ---------------------------------------------------
+//
+// USB_FT_LOG_SITE: id:u16 level:u8 line:u16 file fmt          (strings: len:u8 + bytes)
+// USB_FT_LOG:      id:u16 suppressed:u16 t_us:u32 nargs:u8 {tag:char value}
+//                  values: i/u u32, q/Q u64, f f32, s string
+
+static uint32_t s_session = 0;
+static uint8_t s_site_sent[(kMaxSites + DLOG_DEBUG + 2 + 7) / 8];
+static Record s_pending;
+static bool s_have_pending = false;
+
+static size_t put_str(uint8_t *buf, size_t pos, size_t cap, const char *s)
+{
+    size_t n = s ? strnlen(s, 255) : 0;
+    if (pos + 1 + n > cap) n = (pos + 1 < cap) ? cap - pos - 1 : 0;
+    if (pos < cap) buf[pos++] = (uint8_t)n;
+    memcpy(buf + pos, s, n);
+    return pos + n;
+}
+
+static size_t encode_site(const dlog_site_t *site, uint16_t id, uint8_t *buf, size_t cap)
+{
+    const char *file = site->file;
+    const char *slash = strrchr(file, '/');
+    if (slash) file = slash + 1;
+    size_t pos = 0;
+    memcpy(buf + pos, &id, 2);
+    pos += 2;
+    buf[pos++] = site->level;
+    memcpy(buf + pos, &site->line, 2);
+    pos += 2;
+    pos = put_str(buf, pos, cap, file);
+    return put_str(buf, pos, cap, site->fmt);
+}
+
+static size_t encode_record(const Record &r, const dlog_site_t *site, uint8_t *buf, size_t cap)
+{
+    size_t pos = 0;
+    memcpy(buf + pos, &r.h.site, 2);
+    pos += 2;
+    memcpy(buf + pos, &r.h.suppressed, 2);
+    pos += 2;
+    memcpy(buf + pos, &r.h.t_us, 4);
+    pos += 4;
+    uint8_t *nargs = &buf[pos++];
+    *nargs = 0;
+
+    if (r.h.flags & kFlagText) {
+        buf[pos++] = 's';
+        buf[pos++] = r.h.len;
+        memcpy(buf + pos, r.payload, r.h.len);
+        *nargs = 1;
+        return pos + r.h.len;
+    }
+
+    uint32_t words[DLOG_MAX_ARGS];
+    const int count = r.h.len / 4;
+    memcpy(words, r.payload, (size_t)count * 4);
+    int wi = 0;
+    for (const char *p = site->fmt; *p;) {
+        if (*p++ != '%') continue;
+        char spec[16];
+        char tag;
+        p = parse_spec(p, spec, sizeof(spec), &tag);
+        if (tag == '%') continue;
+        const int need = (tag == 'q' || tag == 'Q') ? 2 : 1;
+        if (wi + need > count || pos + 1 + 8 > cap) break;
+        buf[pos++] = (uint8_t)tag;
+        if (tag == 's') {
+            pos = put_str(buf, pos, cap, (const char *)(uintptr_t)words[wi]);
+        } else {
+            memcpy(buf + pos, &words[wi], (size_t)need * 4);
+            pos += (size_t)need * 4;
+        }
+        wi += need;
+        (*nargs)++;
+    }
+    return pos;
+}
+
+static size_t usb_source(uint8_t *type, uint8_t *buf, size_t cap, void *user_data)
+{
+    (void)user_data;
+    const uint32_t session = usb_stream_session();
+    if (session != s_session) {
+        s_session = session;
+        memset(s_site_sent, 0, sizeof(s_site_sent));
+    }
+    if (!s_have_pending) {
+        if (s_consumer.test_and_set(std::memory_order_acquire)) return 0;
+        s_have_pending = pop(&s_pending);
+        s_consumer.clear(std::memory_order_release);
+        if (!s_have_pending) return 0;
+    }
+
+    const dlog_site_t *site = site_of(s_pending);
+    if (!site) {
+        s_have_pending = false;
+        return 0;
+    }
+    // Sites are described to the host once per session, before their first record.
+    const uint16_t id = s_pending.h.site;
+    if (id < sizeof(s_site_sent) * 8 && !(s_site_sent[id / 8] & (1u << (id % 8)))) {
+        s_site_sent[id / 8] |= (uint8_t)(1u << (id % 8));
+        *type = USB_FT_LOG_SITE;
+        return encode_site(site, id, buf, cap);
+    }
+    s_have_pending = false;
+    s_streamed++;
+    *type = USB_FT_LOG;
+    return encode_record(s_pending, site, buf, cap);
+}
+
+// -------------------------------------------------------------------------
+
+void dlog_init(uint8_t core)
+{
+    if (s_task) return;
+    usb_stream_add_source(usb_source, nullptr);
+    xTaskCreatePinnedToCore(format_task, "dlog", 3072, nullptr, 1, &s_task, core);
+}
+
+void dlog_set_level(dlog_level_t level)
+{
+    g_dlog_level.store(level, std::memory_order_relaxed);
+}
+
+void dlog_get_stats(dlog_stats_t *out)
+{
+    if (!out) return;
+    out->written = s_written.load(std::memory_order_relaxed);
+    out->dropped = s_dropped.load(std::memory_order_relaxed);
+    out->suppressed = s_suppressed.load(std::memory_order_relaxed);
+    out->formatted = s_formatted;
+    out->streamed = s_streamed;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+// Deferred logging for hot paths. A call site stores its id and the raw
+// arguments into a lock-free ring (one CAS and a few word copies, no
+// formatting, no I/O). A low-priority task formats the records to Serial
+// later, or, while extras/usb_stream.py has the USB stream open, they are
+// shipped raw and formatted on the host.
+//
+//   DLOG_I("[ANT] Detected variant: %s", name);
+//   DLOG_RL(DLOG_WARN, 1000, "touch: I2C read failed (%d bytes)", n);
+//
+// Arguments are captured as 32-bit words: integers (64-bit ones as %lld /
+// %llu / %llx take two), floats (stored as float) and pointers. %s
+// arguments are stored as pointers and must be static strings; copy a
+// transient buffer with dlog_text() instead.
+
+typedef enum : uint8_t {
+    DLOG_ERROR = 0,
+    DLOG_WARN,
+    DLOG_INFO,
+    DLOG_DEBUG,
+} dlog_level_t;
+
+// Call sites above this level compile to nothing.
+#ifndef DLOG_MIN_LEVEL
+#define DLOG_MIN_LEVEL DLOG_INFO
+#endif
+
+#define DLOG_MAX_ARGS 8           // argument words per record
+#define DLOG_MAX_TEXT 104         // dlog_text() truncates here
+
+// One per call site, static. id is assigned on first use.
+typedef struct {
+    const char *fmt;
+    const char *file;
+    uint16_t line;
+    uint8_t level;
+    uint16_t min_interval_ms;     // rate limit, 0 = none
+    std::atomic<uint16_t> id;
+    std::atomic<uint32_t> last_ms;
+    std::atomic<uint16_t> suppressed;   // dropped by the rate limit since the last record
+} dlog_site_t;
+
+typedef struct {
+    uint32_t written;
+    uint32_t dropped;             // ring full
+    uint32_t suppressed;          // rate limited
+    uint32_t formatted;           // printed to Serial
+    uint32_t streamed;            // sent over the USB stream
+} dlog_stats_t;
+
+// Start the formatter task and register the USB stream source. Records
+// logged before this are kept in the ring.
+void dlog_init(uint8_t core);
+
+void dlog_set_level(dlog_level_t level);
+
+extern std::atomic<uint8_t> g_dlog_level;
+
+inline dlog_level_t dlog_get_level(void)
+{
+    return (dlog_level_t)g_dlog_level.load(std::memory_order_relaxed);
+}
+
+// Copies up to DLOG_MAX_TEXT bytes of `text` (e.g. LVGL's log lines).
+void dlog_text(dlog_level_t level, const char *text);
+
+void dlog_get_stats(dlog_stats_t *out);
+
+void dlog_commit(dlog_site_t *site, const uint32_t *words, int count);
+
+namespace dlog_detail {
+
+template <typename T>
+inline void put(uint32_t *w, int &n, T v)
+{
+  if constexpr (std::is_floating_point<T>::value) {
+    float f = (float)v;
+    memcpy(&w[n++], &f, sizeof(f));
+  } else if constexpr (std::is_pointer<T>::value) {
+    w[n++] = (uint32_t)(uintptr_t)v;
+  } else if constexpr (sizeof(T) > 4) {
+    const uint64_t x = (uint64_t)v;
+    w[n++] = (uint32_t)x;
+    w[n++] = (uint32_t)(x >> 32);
+  } else {
+    w[n++] = (uint32_t)v;
+  }
+}
+
+}  // namespace dlog_detail
+
+template <typename... Args>
+inline void dlog_write(dlog_site_t *site, Args... args)
+{
+  static_assert(sizeof...(Args) <= DLOG_MAX_ARGS, "too many log arguments");
+  uint32_t words[sizeof...(Args) * 2 + 1];
+  int n = 0;
+  (dlog_detail::put(words, n, args), ...);
+  dlog_commit(site, words, n);
+}
+
+#define DLOG_AT(level, interval_ms, fmt, ...)                                                  \
+    do {                                                                                       \
+        if ((level) <= DLOG_MIN_LEVEL && (level) <= dlog_get_level()) {                        \
+            static dlog_site_t dlog_site_ = {fmt, __FILE__, __LINE__, (uint8_t)(level),        \
+                                             (uint16_t)(interval_ms), {0}, {0}, {0}};          \
+            dlog_write(&dlog_site_, ##__VA_ARGS__);                                            \
+        }                                                                                      \
+    } while (0)
+
+#define DLOG_E(fmt, ...) DLOG_AT(DLOG_ERROR, 0, fmt, ##__VA_ARGS__)
+#define DLOG_W(fmt, ...) DLOG_AT(DLOG_WARN, 0, fmt, ##__VA_ARGS__)
+#define DLOG_I(fmt, ...) DLOG_AT(DLOG_INFO, 0, fmt, ##__VA_ARGS__)
+#define DLOG_D(fmt, ...) DLOG_AT(DLOG_DEBUG, 0, fmt, ##__VA_ARGS__)
+
+// At most one record per `interval_ms` from this call site; the skipped
+// ones are counted and reported with the next record.
+#define DLOG_RL(level, interval_ms, fmt, ...) DLOG_AT(level, interval_ms, fmt, ##__VA_ARGS__)
@@ -1,4 +1,5 @@
 #include "esp_lcd_touch_axs15231b.h"
+#include "dlog.h"
 TwoWire *g_touch_i2c;       
 
 uint16_t g_width; 
@@ -12,13 +13,14 @@ static bool touch_i2c_write_read(uint8_t driver_addr, uint8_t *write_buf, uint32
     g_touch_i2c->beginTransmission(driver_addr);
     g_touch_i2c->write(write_buf, write_len);
     if (g_touch_i2c->endTransmission() != 0) {
-        Serial.println("The I2C write fails. - I2C Read\r\n");
+        DLOG_RL(DLOG_WARN, 1000, "touch: I2C write to 0x%02x failed", driver_addr);
         return false;
     }
 
     g_touch_i2c->requestFrom(driver_addr, read_len);
     if (g_touch_i2c->available() != read_len) {
-        Serial.println("The I2C read fails. - I2C Read\r\n");
+        DLOG_RL(DLOG_WARN, 1000, "touch: I2C read from 0x%02x returned %d of %u bytes", driver_addr,
+                g_touch_i2c->available(), read_len);
         return false;
     }
     g_touch_i2c->readBytes(read_buf, read_len);
@@ -114,6 +114,10 @@
 /*Align the start address of draw_buf addresses to this bytes*/
 #define LV_DRAW_BUF_ALIGN                       4
 
+/*Move the rendered pixels of a scrolled container instead of redrawing it (direct render mode).
+ *Only the newly exposed strip is drawn; overlays and non-opaque backgrounds fall back to a redraw.*/
+#define LV_REFR_SCROLL_BLIT                     1
+
 /*Using matrix for transformations.
  *Requirements:
     `LV_USE_MATRIX = 1`.
@@ -179,6 +183,14 @@
         * radius * 4 bytes are used per circle (the most often used radiuses are saved)
         * 0: to disable caching */
         #define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
+
+        /* Draw solid arcs with per-row analytic coverage instead of the angle/radius masks.
+        * Only the anti-aliased edges are evaluated per pixel; arcs with an image source keep the mask path. */
+        #define LV_DRAW_SW_ARC_ANALYTIC 1
+
+        /* Keep pre-blended RGB565 tiles of glyphs drawn over one-color backgrounds.
+        * Enable per font with lv_draw_sw_glyph_atlas_add_font() after giving it memory with lv_draw_sw_glyph_atlas_init(). */
+        #define LV_DRAW_SW_GLYPH_ATLAS 1
     #endif
 
     #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_NONE
@@ -526,8 +538,9 @@
  *Compiler error will be triggered if a font needs it.*/
 #define LV_FONT_FMT_TXT_LARGE 0
 
-/*Enables/disables support for compressed fonts.*/
-#define LV_USE_FONT_COMPRESSED 0
+/*Enables/disables support for compressed fonts.
+ *The value digit subsets (extras/fonts.json) are RLE-compressed.*/
+#define LV_USE_FONT_COMPRESSED 1
 
 /*Enable drawing placeholders when glyph dsc is not found*/
 #define LV_USE_FONT_PLACEHOLDER 1
@@ -858,7 +871,7 @@
  *==================*/
 
 /*1: Enable API to take snapshot for object*/
-#define LV_USE_SNAPSHOT 0
+#define LV_USE_SNAPSHOT 1
 
 /*1: Enable system monitor component*/
 #define LV_USE_SYSMON   0
@@ -6,8 +6,19 @@
 #include "esp_lcd_touch_axs15231b.h"
 #include "esp_heap_caps.h"
 #include "ui.h"
+#include "ui_screens.h"
 #include <NimBLEDevice.h>
+#include "ble_links.h"
 #include "ant_bms_ble_module.h"
+#include "ui_msg_queue.h"
+#include "ui_update_sched.h"
+#include "vesc_module.h"
+#include "ui_dash_bridge.h"
+#include "ts_recorder.h"
+#include "ride_log.h"
+#include "usb_stream.h"
+#include "dlog.h"
+#include "asset_pack.h"
 
 #define DIRECT_RENDER_MODE
 #define ROTATE_LVGL_CW 1
@@ -25,6 +36,34 @@
 #define I2C_SDA 4
 #define I2C_SCL 8
 
+// VESC link: UART (controller TX -> VESC_UART_RX) or BLE (NUS) next to the BMS
+#define VESC_USE_BLE 0
+#define VESC_BLE_MAC ""
+#define VESC_UART_RX 18
+#define VESC_UART_TX 17
+#define VESC_UART_BAUD 115200
+#define VESC_POLL_HZ 50
+#define VESC_MOTOR_POLES 14
+#define VESC_WHEEL_DIAMETER_MM 254.0f
+#define VESC_GEAR_RATIO 1.0f
+#define VESC_CAN_SLAVE_ID -1      // second controller behind COMM_FORWARD_CAN, -1 = none
+// Telemetry history in PSRAM (about a two-hour ride at 5 Hz)
+#define TS_POOL_BYTES (384 * 1024)
+#define TS_RECORD_HZ 5
+
+// Ride log on LittleFS
+#define RIDE_LOG_VESC_HZ 20
+#define RIDE_LOG_BMS_HZ 1
+#define RIDE_LOG_AUTOSTART 1
+
+// Binary telemetry/trace stream on the USB CDC port (host: extras/usb_stream.py)
+#define USB_STREAM_CORE 0
+#define DLOG_CORE 0
+#define USB_CDC_TX_FIFO 4096
+
+#define DASH_SPEED_MAX_KMH 60
+#define DASH_POWER_MAX_W 3000
+
 Arduino_DataBus *bus = new Arduino_ESP32QSPI(
     LCD_QSPI_CS, LCD_QSPI_CLK, LCD_QSPI_D0, LCD_QSPI_D1, LCD_QSPI_D2, LCD_QSPI_D3);
 Arduino_GFX *gfx = new Arduino_AXS15231B(bus, -1 /* RST */, 0 /* rotation */, false, 320, 480);
@@ -36,13 +75,16 @@ lv_display_t *disp;
 lv_color_t *disp_draw_buf1;
 lv_color_t *disp_draw_buf2;
 lv_color_t *rot_buf;
+uint16_t trace_flush;
 
 #if LV_USE_LOG != 0
 void my_print(lv_log_level_t level, const char *buf)
 {
-  LV_UNUSED(level);
-  Serial.println(buf);
-  Serial.flush();
+  dlog_level_t l = DLOG_INFO;
+  if (level == LV_LOG_LEVEL_TRACE) l = DLOG_DEBUG;
+  else if (level == LV_LOG_LEVEL_WARN) l = DLOG_WARN;
+  else if (level == LV_LOG_LEVEL_ERROR) l = DLOG_ERROR;
+  dlog_text(l, buf);
 }
 #endif
 
@@ -54,6 +96,7 @@ uint32_t millis_cb(void)
 /* LVGL calls it when a rendered image needs to copied to the display */
 void my_disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
 {
+  UsbTraceScope trace(trace_flush);
   uint32_t w = lv_area_get_width(area);
   uint32_t h = lv_area_get_height(area);
   if (ROTATE_LVGL_CW) {
@@ -63,14 +106,27 @@ void my_disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
         rot_buf = (lv_color_t *)malloc(screenWidth * screenHeight * 2);
       }
     }
-    if (rot_buf && area->x1 == 0 && area->y1 == 0 && w == screenWidth && h == screenHeight) {
+    /* Direct mode: px_map is the whole frame; send it once, after its last updated area */
+    if (rot_buf && lv_display_flush_is_last(disp)) {
       lv_draw_sw_rotate(px_map, rot_buf, screenWidth, screenHeight,
                         screenWidth * 2, screenHeight * 2,
                         LV_DISPLAY_ROTATION_90, LV_COLOR_FORMAT_RGB565);
       gfx->draw16bitRGBBitmap(0, 0, (uint16_t *)rot_buf, screenHeight, screenWidth);
     }
   } else {
+#ifdef DIRECT_RENDER_MODE
+    /* Direct mode: px_map is the whole frame, so the area's rows are screenWidth apart */
+    uint16_t *src = (uint16_t *)px_map + area->y1 * screenWidth + area->x1;
+    if (w == screenWidth) {
+      gfx->draw16bitRGBBitmap(area->x1, area->y1, src, w, h);
+    } else {
+      for (uint32_t y = 0; y < h; y++) {
+        gfx->draw16bitRGBBitmap(area->x1, area->y1 + y, src + y * screenWidth, w, 1);
+      }
+    }
+#else
     gfx->draw16bitRGBBitmap(area->x1, area->y1, (uint16_t *)px_map, w, h);
+#endif
   }
 
   /* Call it to tell LVGL you are ready */
@@ -110,8 +166,10 @@ void setup()
 {
   Wire.begin(I2C_SDA, I2C_SCL);
 
+  Serial.setTxBufferSize(USB_CDC_TX_FIFO);
   Serial.begin(115200);
   Serial.println("Arduino_GFX LVGL_Arduino_v9 example");
+  dlog_init(DLOG_CORE);
 
   if (!gfx->begin())
   {
@@ -125,6 +183,7 @@ void setup()
   digitalWrite(GFX_BL, HIGH);
 #endif
 
+  trace_flush = usb_trace_register("lv_flush");
   lv_init();
 
   /* Set a tick source so that LVGL will know how much time elapsed. */
@@ -156,7 +215,9 @@ void setup()
     disp = lv_display_create(screenWidth, screenHeight);
     lv_display_set_flush_cb(disp, my_disp_flush);
 #ifdef DIRECT_RENDER_MODE
-    lv_display_set_buffers(disp, disp_draw_buf1, disp_draw_buf2, bufSize * 2, LV_DISPLAY_RENDER_MODE_FULL);
+    // Only the invalidated areas are rendered; scrolled containers move their
+    // pixels instead of redrawing them (LV_REFR_SCROLL_BLIT).
+    lv_display_set_buffers(disp, disp_draw_buf1, disp_draw_buf2, bufSize * 2, LV_DISPLAY_RENDER_MODE_DIRECT);
 #else
     lv_display_set_buffers(disp, disp_draw_buf1, disp_draw_buf2, bufSize * 2, LV_DISPLAY_RENDER_MODE_PARTIAL);
 #endif
@@ -165,13 +226,48 @@ void setup()
     lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
     lv_indev_set_read_cb(indev, my_touchpad_read);
 
+    // Fonts and images from the "assets" partition replace the built-in ones
+    // where the pack has them (extras/asset_pack.py).
+    if (asset_pack_mount()) Serial.println("Asset pack mounted");
     ui_init();
+    ui_screens_init();
+    ui_msg_queue_init();
+    ui_sched_init(disp, 4000);
+    ui_dash_bridge_set_ranges(DASH_SPEED_MAX_KMH, DASH_POWER_MAX_W);
   }
 
   NimBLEDevice::init("");
   NimBLEDevice::setPower(ESP_PWR_LVL_P9);
+  ble_links_init();
   ant_bms_ble_module_init();
 
+  vesc_module_config_t vesc_cfg;
+  vesc_module_default_config(&vesc_cfg);
+#if VESC_USE_BLE
+  vesc_cfg.link = VESC_LINK_BLE;
+  strncpy(vesc_cfg.ble_mac, VESC_BLE_MAC, sizeof(vesc_cfg.ble_mac) - 1);
+#endif
+  vesc_cfg.rx_pin = VESC_UART_RX;
+  vesc_cfg.tx_pin = VESC_UART_TX;
+  vesc_cfg.baud = VESC_UART_BAUD;
+  vesc_cfg.poll_hz = VESC_POLL_HZ;
+  vesc_cfg.motor_poles = VESC_MOTOR_POLES;
+  vesc_cfg.wheel_diameter_mm = VESC_WHEEL_DIAMETER_MM;
+  vesc_cfg.gear_ratio = VESC_GEAR_RATIO;
+#if VESC_CAN_SLAVE_ID >= 0
+  vesc_cfg.can_ids[0] = VESC_CAN_SLAVE_ID;
+  vesc_cfg.can_count = 1;
+#endif
+  vesc_module_init(&vesc_cfg);
+
+  ts_recorder_init(TS_POOL_BYTES, TS_RECORD_HZ);
+
+  if (ride_log_init(RIDE_LOG_VESC_HZ, RIDE_LOG_BMS_HZ) && RIDE_LOG_AUTOSTART) {
+    ride_log_start();
+  }
+
+  usb_stream_init(USB_STREAM_CORE);
+
   Serial.println("Setup done");
 }
 
@@ -0,0 +1,184 @@
+#include "minmax_pyramid.h"
+
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <string.h>
+
+struct Level {
+    mmp_pair_t *ring;
+    uint32_t count;                 // completed entries
+    mmp_pair_t acc;                 // entry being built from the level below
+    uint8_t acc_n;
+};
+
+struct Pyramid {
+    Level lv[MMP_LEVELS];
+    uint32_t n;
+    uint16_t hz;
+};
+
+static constexpr mmp_pair_t kEmpty = {INT32_MAX, INT32_MIN};
+
+static Pyramid s_pyr[MMP_MAX];
+static int s_count = 0;
+static SemaphoreHandle_t s_lock = nullptr;
+
+static inline void merge(mmp_pair_t &into, const mmp_pair_t &p)
+{
+    if (p.min < into.min) into.min = p.min;
+    if (p.max > into.max) into.max = p.max;
+}
+
+static inline uint32_t span_of(int k)
+{
+    return 1u << (2 * k);           // MMP_FANOUT^k
+}
+
+static_assert(MMP_FANOUT == 4, "span_of() assumes a fan-out of 4");
+
+static Pyramid *get(int id)
+{
+    return (id >= 0 && id < s_count) ? &s_pyr[id] : nullptr;
+}
+
+// Entry e of level k covers samples [e * 4^k, (e + 1) * 4^k). The entry
+// still being filled is rebuilt from the accumulators below it.
+static bool entry(const Pyramid &p, int k, uint32_t e, mmp_pair_t &out)
+{
+    const Level &l = p.lv[k];
+    if (e < l.count) {
+        if (l.count - e > MMP_LEVEL_LEN) return false;
+        out = l.ring[e % MMP_LEVEL_LEN];
+        return true;
+    }
+    out = kEmpty;
+    if (e == l.count) {
+        for (int j = 1; j <= k; j++) merge(out, p.lv[j].acc);
+    }
+    return true;
+}
+
+static bool available(const Pyramid &p, int k, uint32_t e)
+{
+    const Level &l = p.lv[k];
+    return e >= l.count || l.count - e <= MMP_LEVEL_LEN;
+}
+
+int mmp_create(uint16_t hz)
+{
+    if (!s_lock) s_lock = xSemaphoreCreateMutex();
+    if (s_count >= MMP_MAX) return -1;
+    Pyramid &p = s_pyr[s_count];
+    const size_t bytes = sizeof(mmp_pair_t) * MMP_LEVEL_LEN;
+    for (int k = 0; k < MMP_LEVELS; k++) {
+        p.lv[k].ring = (mmp_pair_t *)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!p.lv[k].ring) {
+            for (int j = 0; j < k; j++) heap_caps_free(p.lv[j].ring);
+            memset(&p, 0, sizeof(p));
+            return -1;
+        }
+        p.lv[k].count = 0;
+        p.lv[k].acc = kEmpty;
+        p.lv[k].acc_n = 0;
+    }
+    p.n = 0;
+    p.hz = hz ? hz : 1;
+    return s_count++;
+}
+
+void mmp_append(int id, bool valid, int32_t value)
+{
+    Pyramid *p = get(id);
+    if (!p) return;
+    mmp_pair_t e = valid ? mmp_pair_t{value, value} : kEmpty;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    p->n++;
+    Level &l0 = p->lv[0];
+    l0.ring[l0.count++ % MMP_LEVEL_LEN] = e;
+    // Carry completed entries upward.
+    for (int k = 1; k < MMP_LEVELS; k++) {
+        Level &l = p->lv[k];
+        merge(l.acc, e);
+        if (++l.acc_n < MMP_FANOUT) break;
+        e = l.acc;
+        l.ring[l.count++ % MMP_LEVEL_LEN] = e;
+        l.acc = kEmpty;
+        l.acc_n = 0;
+    }
+    xSemaphoreGive(s_lock);
+}
+
+uint32_t mmp_samples(int id)
+{
+    Pyramid *p = get(id);
+    return p ? p->n : 0;
+}
+
+uint16_t mmp_hz(int id)
+{
+    Pyramid *p = get(id);
+    return p ? p->hz : 1;
+}
+
+void mmp_render(int id, uint32_t window, mmp_pair_t *out, int columns)
+{
+    if (columns <= 0) return;
+    for (int c = 0; c < columns; c++) out[c] = kEmpty;
+    Pyramid *p = get(id);
+    if (!p) return;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    const int64_t n = p->n;
+    const int64_t w = window ? (int64_t)window : n;
+    if (w == 0) {
+        xSemaphoreGive(s_lock);
+        return;
+    }
+    const int64_t s0 = n - w;
+
+    // Finest level whose entries are no wider than a column.
+    int k0 = 0;
+    const int64_t per_col = w / columns;
+    while (k0 + 1 < MMP_LEVELS && (int64_t)span_of(k0 + 1) <= per_col) k0++;
+
+    for (int c = 0; c < columns; c++) {
+        int64_t a = s0 + w * c / columns;
+        int64_t b = s0 + w * (c + 1) / columns;
+        if (b <= a) b = a + 1;
+        if (b <= 0) continue;
+        if (a < 0) a = 0;
+
+        // Older data survives only at coarser levels.
+        int k = k0;
+        while (k + 1 < MMP_LEVELS && !available(*p, k, (uint32_t)(a >> (2 * k)))) k++;
+        uint32_t e = (uint32_t)(a >> (2 * k));
+        const uint32_t e_end = (uint32_t)((b - 1) >> (2 * k));
+        if (!available(*p, k, e)) {
+            const Level &l = p->lv[k];
+            e = l.count - MMP_LEVEL_LEN;
+            if (e > e_end) continue;
+        }
+        mmp_pair_t acc = kEmpty;
+        for (; e <= e_end; e++) {
+            mmp_pair_t v;
+            if (entry(*p, k, e, v)) merge(acc, v);
+        }
+        out[c] = acc;
+    }
+    xSemaphoreGive(s_lock);
+}
+
+void mmp_reset(int id)
+{
+    Pyramid *p = get(id);
+    if (!p) return;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int k = 0; k < MMP_LEVELS; k++) {
+        p->lv[k].count = 0;
+        p->lv[k].acc = kEmpty;
+        p->lv[k].acc_n = 0;
+    }
+    p->n = 0;
+    xSemaphoreGive(s_lock);
+}
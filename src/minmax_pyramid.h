@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Multi-resolution min/max history for long-window charts. Samples arrive
+// at a fixed rate. Level 0 keeps the newest raw samples and each level above
+// keeps min/max pairs over MMP_FANOUT entries of the level below, so a
+// window of any length is answered from the level whose entries are just
+// finer than one pixel column: at most a handful of entries per column
+// however long the window. Appends are amortized O(1). Rings live in PSRAM.
+
+#define MMP_MAX 4
+#define MMP_LEVELS 7
+#define MMP_FANOUT 4
+#define MMP_LEVEL_LEN 1024          // entries per level; the top level covers LEN * FANOUT^6 samples
+
+typedef struct {
+    int32_t min;
+    int32_t max;                    // min > max = no data
+} mmp_pair_t;
+
+// Returns the pyramid id, or -1 when the table is full or out of memory.
+int mmp_create(uint16_t hz);
+
+// One sample per tick. A gap (valid = false) keeps the time axis aligned
+// while the source is offline.
+void mmp_append(int id, bool valid, int32_t value);
+
+uint32_t mmp_samples(int id);
+uint16_t mmp_hz(int id);
+
+// One min/max pair per column over the newest `window` samples (0 = all of
+// them), oldest column first. Columns before the first sample are empty.
+void mmp_render(int id, uint32_t window, mmp_pair_t *out, int columns);
+
+void mmp_reset(int id);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
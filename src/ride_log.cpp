@@ -0,0 +1,294 @@
+#include "ride_log.h"
+#include "ride_log_format.h"
+#include "telemetry_hub.h"
+#include "ant_bms_ble_module.h"
+#include "vesc_module.h"
+
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <atomic>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static constexpr uint32_t kTaskPeriodMs = 100;
+static constexpr int kMaxFiles = 50;
+static constexpr float kMaxFsUse = 0.85f;   // prune oldest rides above this fill level
+static constexpr uint32_t kPruneCheckBlocks = 8;   // block writes between fill checks (usedBytes walks the FS)
+static const char *kDir = "/rides";
+
+static bool s_inited = false;
+static uint32_t s_vesc_interval_ms = 20;
+static uint32_t s_bms_interval_ms = 1000;
+static std::atomic<bool> s_want_active{false};
+static std::atomic<bool> s_active{false};
+static ride_log_stats_t s_stats;
+
+// Task-owned state.
+static File s_file;
+static int s_file_idx = -1;
+static size_t s_file_end = 0;      // end of the last block written whole
+static uint8_t s_block[RIDE_LOG_BLOCK_BYTES];
+static size_t s_block_len = 0;
+static uint16_t s_block_records = 0;
+static uint32_t s_block_seq = 0;
+static uint32_t s_write_attempts = 0;
+static uint32_t s_block_t0 = 0;
+static uint32_t s_block_t1 = 0;
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+static int file_index(const char *name)
+{
+    // "NNNN.rlg", possibly with a leading directory.
+    const char *base = strrchr(name, '/');
+    base = base ? base + 1 : name;
+    return (strlen(base) == 8 && strcmp(base + 4, ".rlg") == 0) ? atoi(base) : -1;
+}
+
+static bool fs_full()
+{
+    return LittleFS.usedBytes() > (size_t)(LittleFS.totalBytes() * kMaxFsUse);
+}
+
+// Returns the highest existing index; deletes the oldest files other than
+// `keep_idx` while the file system is too full or there are too many rides.
+static int scan_and_prune(int keep_idx)
+{
+    for (;;) {
+        int lo = -1, hi = -1, count = 0;
+        File dir = LittleFS.open(kDir);
+        if (!dir) return -1;
+        for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+            int idx = file_index(f.name());
+            if (idx < 0) continue;
+            if (idx > hi) hi = idx;
+            if (idx == keep_idx) continue;
+            count++;
+            if (lo < 0 || idx < lo) lo = idx;
+        }
+        dir.close();
+        if (lo < 0 || (count < kMaxFiles && !fs_full())) return hi;
+        char path[24];
+        snprintf(path, sizeof(path), "%s/%04d.rlg", kDir, lo);
+        LittleFS.remove(path);
+    }
+}
+
+static void block_reset(uint32_t t)
+{
+    s_block_len = sizeof(ride_log_block_header_t);
+    s_block_records = 0;
+    s_block_t0 = s_block_t1 = t;
+}
+
+// Writes s_block at s_file_end. On a short write it seeks back over
+// whatever part of the block landed so the next one starts on the
+// boundary; a torn tail is all the reader sees if nothing else gets written.
+static bool write_whole_block()
+{
+    bool ok = s_file.write(s_block, sizeof(s_block)) == sizeof(s_block);
+    s_file.flush();
+    if (!ok) s_file.seek(s_file_end);
+    return ok;
+}
+
+static void block_write()
+{
+    if (s_block_records == 0 || !s_file) return;
+    ride_log_block_header_t h = {};
+    h.magic = RIDE_LOG_BLOCK_MAGIC;
+    h.seq = s_block_seq;
+    h.t_first_ms = s_block_t0;
+    h.t_last_ms = s_block_t1;
+    h.record_count = s_block_records;
+    h.payload_bytes = (uint16_t)(s_block_len - sizeof(h));
+    memcpy(s_block, &h, sizeof(h));
+    memset(s_block + s_block_len, 0xFF, sizeof(s_block) - s_block_len);
+    h.crc32 = crc32_update(0, s_block, s_block_len);
+    memcpy(s_block, &h, sizeof(h));
+
+    // Long rides can outgrow the space open_file() left; make room before
+    // the write rather than failing it, and once more if it fails anyway.
+    if (++s_write_attempts % kPruneCheckBlocks == 0 && fs_full()) scan_and_prune(s_file_idx);
+
+    uint32_t t0 = micros();
+    bool ok = write_whole_block();
+    if (!ok) {
+        scan_and_prune(s_file_idx);
+        ok = write_whole_block();
+    }
+    s_stats.last_write_us = micros() - t0;
+    if (ok) {
+        s_stats.blocks_written++;
+        s_block_seq++;
+        s_file_end += sizeof(s_block);
+    } else {
+        s_stats.write_errors++;
+    }
+    s_block_records = 0;
+}
+
+static void append(uint8_t type, uint32_t t, const void *payload, size_t len)
+{
+    const size_t need = sizeof(ride_log_record_header_t) + len;
+    if (s_block_records > 0 && (s_block_len + need > sizeof(s_block) || t - s_block_t0 > 0xFFFF)) {
+        block_write();
+    }
+    if (s_block_records == 0) block_reset(t);
+
+    ride_log_record_header_t rh = {type, (uint8_t)len, (uint16_t)(t - s_block_t0)};
+    memcpy(s_block + s_block_len, &rh, sizeof(rh));
+    memcpy(s_block + s_block_len + sizeof(rh), payload, len);
+    s_block_len += need;
+    s_block_records++;
+    s_block_t1 = t;
+    s_stats.records++;
+}
+
+static void log_bms(const ant_bms_sample_t &b, uint32_t t)
+{
+    uint8_t buf[sizeof(ride_rec_bms_t) + 2 * ANT_BMS_MAX_CELLS];
+    ride_rec_bms_t r = {};
+    r.pack_mv = b.pack_mv;
+    r.current_ma = b.current_ma;
+    r.power_w = b.power_w;
+    r.soc_dpct = b.soc_dpct;
+    r.temp1_dc = b.temp_dc[0];
+    r.temp2_dc = b.temp_dc[1];
+    r.temp_mos_dc = b.temp_dc[6];
+    r.cell_count = b.cell_count > ANT_BMS_MAX_CELLS ? ANT_BMS_MAX_CELLS : b.cell_count;
+    memcpy(buf, &r, sizeof(r));
+    memcpy(buf + sizeof(r), b.cell_mv, 2u * r.cell_count);
+    append(RIDE_REC_BMS, t, buf, sizeof(r) + 2u * r.cell_count);
+}
+
+static void log_vesc(const vesc_snapshot_t &v, uint32_t t)
+{
+    if (!v.connected) return;
+    ride_rec_vesc_t r = {};
+    r.speed_dkmh = v.speed_dkmh;
+    r.power_w = v.power_w;
+    r.current_in_ca = v.current_in_ca;
+    r.v_in_dv = v.v_in_dv;
+    r.temp_motor_dc = v.temp_motor_dc;
+    r.temp_fet_dc = v.temp_fet_dc;
+    r.duty_pm = v.duty_pm;
+    r.odometer_m = v.odometer_m;
+    r.fault = v.fault;
+    append(RIDE_REC_VESC, t, &r, sizeof(r));
+}
+
+static bool open_file()
+{
+    LittleFS.mkdir(kDir);
+    s_file_idx = (scan_and_prune(-1) + 1) % 10000;
+    snprintf(s_stats.path, sizeof(s_stats.path), "%s/%04d.rlg", kDir, s_file_idx);
+    s_file = LittleFS.open(s_stats.path, FILE_WRITE);
+    if (!s_file) return false;
+    ride_log_file_header_t fh = {RIDE_LOG_MAGIC, RIDE_LOG_VERSION, RIDE_LOG_BLOCK_BYTES, millis(), 0};
+    if (s_file.write((const uint8_t *)&fh, sizeof(fh)) != sizeof(fh)) {
+        s_file.close();
+        LittleFS.remove(s_stats.path);
+        return false;
+    }
+    s_file_end = sizeof(fh);
+    s_block_seq = 0;
+    s_block_records = 0;
+    return true;
+}
+
+static void close_file()
+{
+    block_write();
+    if (s_file) s_file.close();
+}
+
+static void log_task(void *)
+{
+    hub_reader_t bms, vesc;
+    ant_bms_sample_t b;
+    vesc_snapshot_t v;
+    uint32_t last_bms_t = 0, last_vesc_t = 0;
+    TickType_t wake = xTaskGetTickCount();
+
+    for (;;) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(kTaskPeriodMs));
+
+        bool want = s_want_active.load();
+        if (want != s_active.load()) {
+            if (want) {
+                if (!open_file()) {
+                    s_stats.write_errors++;
+                    s_want_active.store(false);
+                    continue;
+                }
+                hub_reader_init(&bms, HUB_CH_BMS, 0);
+                hub_reader_init(&vesc, HUB_CH_VESC, 0);
+                last_bms_t = last_vesc_t = 0;
+            } else {
+                close_file();
+            }
+            s_active.store(want);
+        }
+        if (!want) continue;
+
+        // Walk the history rings so the log keeps the source rate (up to
+        // the configured cap) even though this task only wakes at 10 Hz.
+        uint32_t t;
+        while (hub_read_next(&vesc, &v, &t)) {
+            if (last_vesc_t != 0 && t - last_vesc_t < s_vesc_interval_ms) continue;
+            last_vesc_t = t;
+            log_vesc(v, t);
+        }
+        while (hub_read_next(&bms, &b, &t)) {
+            if (last_bms_t != 0 && t - last_bms_t < s_bms_interval_ms) continue;
+            last_bms_t = t;
+            log_bms(b, t);
+        }
+        s_stats.dropped = vesc.missed + bms.missed;
+    }
+}
+
+bool ride_log_init(uint16_t vesc_hz, uint16_t bms_hz)
+{
+    if (s_inited) return true;
+    if (!LittleFS.begin(true)) return false;
+    s_inited = true;
+    // Slightly under the nominal period so jitter doesn't halve the rate.
+    if (vesc_hz > 0) s_vesc_interval_ms = 1000u / vesc_hz * 9 / 10;
+    if (bms_hz > 0) s_bms_interval_ms = 1000u / bms_hz * 9 / 10;
+    xTaskCreatePinnedToCore(log_task, "ride_log", 4096, nullptr, 1, nullptr, 0);
+    return true;
+}
+
+bool ride_log_start(void)
+{
+    if (!s_inited) return false;
+    s_want_active.store(true);
+    return true;
+}
+
+void ride_log_stop(void)
+{
+    s_want_active.store(false);
+}
+
+bool ride_log_is_active(void)
+{
+    return s_active.load();
+}
+
+void ride_log_get_stats(ride_log_stats_t *out)
+{
+    if (out) *out = s_stats;
+}
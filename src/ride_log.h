@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Ride logger: records HUB_CH_BMS / HUB_CH_VESC samples into
+// /rides/NNNN.rlg on LittleFS (format in ride_log_format.h) from a
+// low-priority task. Records are packed into 4 KB blocks in RAM and each
+// block is appended with one write + flush, so the file system sees one
+// write and one commit every few seconds regardless of the sample rate.
+// Blocks are not sector-aligned on flash: they follow the 16-byte file
+// header, and LittleFS stores skip-list pointers at the start of its own
+// blocks, so a log block usually straddles two erase blocks.
+
+typedef struct {
+    uint32_t blocks_written;
+    uint32_t records;
+    uint32_t dropped;          // samples lost to a full hub history ring
+    uint32_t write_errors;
+    uint32_t last_write_us;
+    char path[24];
+} ride_log_stats_t;
+
+// Mount LittleFS and start the task. vesc_hz / bms_hz cap the logged rate
+// (the sources may publish faster).
+bool ride_log_init(uint16_t vesc_hz, uint16_t bms_hz);
+
+// Start a new file / close the current one (the partial block is flushed).
+bool ride_log_start(void);
+void ride_log_stop(void);
+bool ride_log_is_active(void);
+
+void ride_log_get_stats(ride_log_stats_t *out);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
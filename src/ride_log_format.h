@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+// On-flash ride log layout (little-endian). extras/ride_log.py reads it.
+//
+//   file   := file_header block*
+//   block  := block_header record* padding      (exactly RIDE_LOG_BLOCK_BYTES)
+//   record := record_header payload
+//
+// Blocks are fixed size and written whole, so block N lives at
+// sizeof(file_header) + N * RIDE_LOG_BLOCK_BYTES and a time seek is a binary
+// search over block headers. A block torn by power loss fails its CRC and
+// is ignored together with everything after it.
+
+#define RIDE_LOG_MAGIC 0x474F4C52u        // "RLOG"
+#define RIDE_LOG_BLOCK_MAGIC 0x4B4C4252u  // "RBLK"
+#define RIDE_LOG_VERSION 1
+#define RIDE_LOG_BLOCK_BYTES 4096         // file offsets only, not flash-aligned
+
+typedef enum {
+    RIDE_REC_BMS = 1,
+    RIDE_REC_VESC = 2,
+} ride_rec_type_t;
+
+#pragma pack(push, 1)
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t block_bytes;
+    uint32_t boot_ms;          // millis() when the file was opened
+    uint32_t reserved;
+} ride_log_file_header_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;              // block number within the file
+    uint32_t t_first_ms;       // record times are offsets from this
+    uint32_t t_last_ms;
+    uint16_t record_count;
+    uint16_t payload_bytes;    // records after this header
+    uint32_t crc32;            // IEEE CRC-32 of header (crc32 = 0) + payload
+} ride_log_block_header_t;
+
+typedef struct {
+    uint8_t type;              // ride_rec_type_t
+    uint8_t len;               // payload bytes
+    uint16_t dt_ms;            // since block t_first_ms
+} ride_log_record_header_t;
+
+typedef struct {
+    int32_t pack_mv;
+    int32_t current_ma;
+    int32_t power_w;
+    uint16_t soc_dpct;
+    int16_t temp1_dc;
+    int16_t temp2_dc;
+    int16_t temp_mos_dc;
+    uint8_t cell_count;
+    // followed by cell_count x uint16_t cell_mv
+} ride_rec_bms_t;
+
+typedef struct {
+    int32_t speed_dkmh;
+    int32_t power_w;
+    int32_t current_in_ca;
+    int16_t v_in_dv;
+    int16_t temp_motor_dc;
+    int16_t temp_fet_dc;
+    int16_t duty_pm;
+    uint32_t odometer_m;
+    uint8_t fault;
+} ride_rec_vesc_t;
+
+#pragma pack(pop)
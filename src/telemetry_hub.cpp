@@ -0,0 +1,183 @@
+#include "telemetry_hub.h"
+#include "ui_msg_queue.h"
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+// A slot is [seq][t_ms][payload]. seq is odd while the writer copies and
+// 2 * sample_seq once the slot holds that sample.
+struct SlotHdr {
+    std::atomic<uint32_t> seq;
+    uint32_t t_ms;
+};
+
+struct Channel {
+    bool ready;
+    size_t sample_size;
+    size_t slot_size;
+    uint16_t history_len;
+    uint32_t ui_bits;
+    std::atomic<uint32_t> head;  // last published sample seq
+    uint8_t *latest;
+    uint8_t *history;
+};
+
+static Channel s_channels[HUB_CH_COUNT];
+
+static bool valid(int ch)
+{
+    return ch >= 0 && ch < HUB_CH_COUNT && s_channels[ch].ready;
+}
+
+static SlotHdr *hdr(uint8_t *slot)
+{
+    return reinterpret_cast<SlotHdr *>(slot);
+}
+
+static void slot_write(uint8_t *slot, const void *sample, size_t size, uint32_t seq, uint32_t t_ms)
+{
+    SlotHdr *h = hdr(slot);
+    h->seq.store(2 * seq - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    h->t_ms = t_ms;
+    memcpy(slot + sizeof(SlotHdr), sample, size);
+    h->seq.store(2 * seq, std::memory_order_release);
+}
+
+// Copy the slot out. Returns the sample seq it held, 0 if it was torn.
+static uint32_t slot_read(uint8_t *slot, void *out, size_t size, uint32_t *t_ms)
+{
+    SlotHdr *h = hdr(slot);
+    for (int tries = 0; tries < 4; tries++) {
+        uint32_t s1 = h->seq.load(std::memory_order_acquire);
+        if (s1 == 0) return 0;
+        if (s1 & 1u) continue;
+        uint32_t t = h->t_ms;
+        memcpy(out, slot + sizeof(SlotHdr), size);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (h->seq.load(std::memory_order_relaxed) == s1) {
+            if (t_ms) *t_ms = t;
+            return s1 / 2;
+        }
+    }
+    return 0;
+}
+
+static uint8_t *alloc_slots(size_t slot_size, size_t n)
+{
+    uint8_t *p = (uint8_t *)calloc(n, slot_size);
+    if (!p) return nullptr;
+    for (size_t i = 0; i < n; i++) new (p + i * slot_size) SlotHdr();
+    return p;
+}
+
+bool hub_channel_init(hub_channel_t ch, size_t sample_size, uint16_t history_len, uint32_t ui_source_bits)
+{
+    if (ch < 0 || ch >= HUB_CH_COUNT || sample_size == 0) return false;
+    Channel &c = s_channels[ch];
+    if (c.ready) return c.sample_size == sample_size;
+
+    // Keep slots word-aligned so the header atomics stay aligned.
+    size_t slot = (sizeof(SlotHdr) + sample_size + 3u) & ~(size_t)3u;
+    c.latest = alloc_slots(slot, 1);
+    c.history = history_len ? alloc_slots(slot, history_len) : nullptr;
+    if (!c.latest || (history_len && !c.history)) {
+        free(c.latest);
+        free(c.history);
+        c.latest = c.history = nullptr;
+        return false;
+    }
+    c.sample_size = sample_size;
+    c.slot_size = slot;
+    c.history_len = history_len;
+    c.ui_bits = ui_source_bits;
+    c.head.store(0, std::memory_order_relaxed);
+    c.ready = true;
+    return true;
+}
+
+uint32_t hub_publish(hub_channel_t ch, const void *sample, uint32_t t_ms)
+{
+    if (!valid(ch) || !sample) return 0;
+    Channel &c = s_channels[ch];
+    uint32_t seq = c.head.load(std::memory_order_relaxed) + 1;
+    if (c.history) {
+        slot_write(c.history + ((seq - 1) % c.history_len) * c.slot_size, sample, c.sample_size, seq, t_ms);
+    }
+    slot_write(c.latest, sample, c.sample_size, seq, t_ms);
+    c.head.store(seq, std::memory_order_release);
+    if (c.ui_bits) ui_msg_post_telemetry(c.ui_bits);
+    return seq;
+}
+
+uint32_t hub_seq(hub_channel_t ch)
+{
+    if (!valid(ch)) return 0;
+    return s_channels[ch].head.load(std::memory_order_acquire);
+}
+
+bool hub_peek(hub_channel_t ch, void *out, uint32_t *t_ms)
+{
+    if (!valid(ch) || !out) return false;
+    Channel &c = s_channels[ch];
+    return slot_read(c.latest, out, c.sample_size, t_ms) != 0;
+}
+
+void hub_reader_init(hub_reader_t *r, hub_channel_t ch, uint32_t min_interval_ms)
+{
+    if (!r) return;
+    memset(r, 0, sizeof(*r));
+    r->ch = (uint8_t)ch;
+    r->min_interval_ms = min_interval_ms;
+    r->next_seq = hub_seq(ch) + 1;
+}
+
+bool hub_read_latest(hub_reader_t *r, void *out, uint32_t *t_ms)
+{
+    if (!r || !out || !valid(r->ch)) return false;
+    Channel &c = s_channels[r->ch];
+    uint32_t head = c.head.load(std::memory_order_acquire);
+    if (head == 0 || head == r->last_seq) return false;
+
+    uint32_t t = 0;
+    uint32_t seq = slot_read(c.latest, out, c.sample_size, &t);
+    if (seq == 0 || seq == r->last_seq) return false;
+    if (r->last_seq != 0 && (t - r->last_t_ms) < r->min_interval_ms) return false;
+    r->last_seq = seq;
+    r->last_t_ms = t;
+    if (t_ms) *t_ms = t;
+    return true;
+}
+
+bool hub_read_next(hub_reader_t *r, void *out, uint32_t *t_ms)
+{
+    if (!r || !out || !valid(r->ch)) return false;
+    Channel &c = s_channels[r->ch];
+    if (!c.history) return false;
+
+    for (;;) {
+        uint32_t head = c.head.load(std::memory_order_acquire);
+        if (r->next_seq > head) return false;
+        // Too far behind: jump to the oldest entry that can still be intact.
+        if (head - r->next_seq >= c.history_len) {
+            uint32_t oldest = head - c.history_len + 1;
+            r->missed += oldest - r->next_seq;
+            r->next_seq = oldest;
+        }
+        uint8_t *slot = c.history + ((r->next_seq - 1) % c.history_len) * c.slot_size;
+        uint32_t seq = slot_read(slot, out, c.sample_size, t_ms);
+        if (seq == r->next_seq) {
+            r->next_seq++;
+            return true;
+        }
+        // Overwritten (or being overwritten) while we looked: skip it.
+        if (seq == 0 || seq > r->next_seq) {
+            r->missed++;
+            r->next_seq++;
+            continue;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Telemetry data plane between producers (BLE/UART tasks, derived
+// calculators) and consumers (UI, logger, alerts) on either core.
+// Each channel carries fixed-size samples of one type, written by a single
+// producer into a latest-value slot and an optional history ring. Readers
+// never block the writer and never take a lock: every slot is a seqlock,
+// and a reader that races a write just retries or skips the entry.
+// The sample type is owned by the producer's header.
+
+typedef enum {
+    HUB_CH_BMS = 0,          // ant_bms_sample_t
+    HUB_CH_VESC,             // vesc_snapshot_t
+    HUB_CH_COUNT,
+} hub_channel_t;
+
+// Producer side. Call once before the first publish (not thread-safe).
+// `ui_source_bits` are posted via ui_msg_post_telemetry on every publish.
+bool hub_channel_init(hub_channel_t ch, size_t sample_size, uint16_t history_len, uint32_t ui_source_bits);
+
+// Single writer per channel. Returns the sample's sequence number (from 1).
+uint32_t hub_publish(hub_channel_t ch, const void *sample, uint32_t t_ms);
+
+// Sequence number of the newest sample, 0 if none yet.
+uint32_t hub_seq(hub_channel_t ch);
+
+// Newest sample regardless of what any reader has seen.
+bool hub_peek(hub_channel_t ch, void *out, uint32_t *t_ms);
+
+// Consumer cursor. Each consumer owns one per channel and picks its own
+// decimation; readers are independent of each other.
+typedef struct {
+    uint8_t ch;
+    uint32_t next_seq;           // next history sample to return
+    uint32_t last_seq;           // last sample returned by hub_read_latest
+    uint32_t min_interval_ms;    // decimation for hub_read_latest
+    uint32_t last_t_ms;
+    uint32_t missed;             // history samples overwritten before read
+} hub_reader_t;
+
+void hub_reader_init(hub_reader_t *r, hub_channel_t ch, uint32_t min_interval_ms);
+
+// Newest sample if it is newer than the last one returned and at least
+// min_interval_ms after it.
+bool hub_read_latest(hub_reader_t *r, void *out, uint32_t *t_ms);
+
+// Oldest history sample not yet returned to this reader. Samples that were
+// overwritten in the meantime are skipped and counted in r->missed.
+bool hub_read_next(hub_reader_t *r, void *out, uint32_t *t_ms);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
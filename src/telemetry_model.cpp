@@ -0,0 +1,75 @@
+#include "telemetry_model.h"
+
+#include <math.h>
+
+static lv_subject_t s_subjects[TELEM_ID_COUNT];
+static lv_subject_t s_cells[TELEM_MAX_CELLS];
+static bool s_inited = false;
+
+static int32_t quantize(float value, float scale)
+{
+    if (!isfinite(value)) return TELEM_UNKNOWN;
+    return (int32_t)lroundf(value * scale);
+}
+
+void telem_init(void)
+{
+    if (s_inited) return;
+    s_inited = true;
+    for (int i = 0; i < TELEM_ID_COUNT; i++) {
+        lv_subject_init_int(&s_subjects[i], TELEM_UNKNOWN);
+    }
+    lv_subject_init_int(&s_subjects[TELEM_CELL_COUNT], 0);
+    for (int i = 0; i < TELEM_MAX_CELLS; i++) {
+        lv_subject_init_int(&s_cells[i], TELEM_UNKNOWN);
+    }
+}
+
+void telem_reset_bms(void)
+{
+    if (!s_inited) return;
+    for (int i = 0; i < TELEM_VESC_FIRST; i++) {
+        lv_subject_set_int(&s_subjects[i], (i == TELEM_CELL_COUNT) ? 0 : TELEM_UNKNOWN);
+    }
+    for (int i = 0; i < TELEM_MAX_CELLS; i++) {
+        lv_subject_set_int(&s_cells[i], TELEM_UNKNOWN);
+    }
+}
+
+void telem_reset_vesc(void)
+{
+    if (!s_inited) return;
+    // The odometer is persisted, so it stays valid across link drops.
+    for (int i = TELEM_VESC_FIRST; i < TELEM_ID_COUNT; i++) {
+        if (i != TELEM_ODO_KM) lv_subject_set_int(&s_subjects[i], TELEM_UNKNOWN);
+    }
+}
+
+lv_subject_t *telem_subject(telem_id_t id)
+{
+    if (id < 0 || id >= TELEM_ID_COUNT) return nullptr;
+    return &s_subjects[id];
+}
+
+lv_subject_t *telem_cell_subject(int cell)
+{
+    if (cell < 0 || cell >= TELEM_MAX_CELLS) return nullptr;
+    return &s_cells[cell];
+}
+
+void telem_publish_int(telem_id_t id, int32_t value)
+{
+    if (!s_inited || id < 0 || id >= TELEM_ID_COUNT) return;
+    lv_subject_set_int(&s_subjects[id], value);
+}
+
+void telem_publish_float(telem_id_t id, float value, float scale)
+{
+    telem_publish_int(id, quantize(value, scale));
+}
+
+void telem_publish_cell_mv(int cell, int32_t mv)
+{
+    if (!s_inited || cell < 0 || cell >= TELEM_MAX_CELLS) return;
+    lv_subject_set_int(&s_cells[cell], mv);
+}
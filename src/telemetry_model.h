@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One lv_subject_t per telemetry quantity, holding the value quantized to the
+// resolution the UI shows. Publishing an unchanged quantized value is free:
+// observers are only notified on change. LVGL thread only.
+
+#define TELEM_UNKNOWN INT32_MIN   // value not available (NaN / disconnected)
+#define TELEM_MAX_CELLS 32
+
+typedef enum {
+    TELEM_PACK_V_DV = 0,     // pack voltage, 0.1 V
+    TELEM_PACK_A_DA,         // pack current, 0.1 A
+    TELEM_CHG_ON,            // charge MOSFET on (0/1)
+    TELEM_DSG_ON,            // discharge MOSFET on (0/1)
+    TELEM_SOC_PCT,           // state of charge, 1 %
+    TELEM_TEMP1_C,           // 1 degC
+    TELEM_TEMP2_C,
+    TELEM_TEMP_MOS_C,
+    TELEM_CELL_DELTA_MV,
+    TELEM_CELL_LOW_IDX,      // 0-based
+    TELEM_CELL_LOW_MV,
+    TELEM_CELL_HIGH_IDX,
+    TELEM_CELL_HIGH_MV,
+    TELEM_CELL_COUNT,
+    TELEM_VESC_FIRST,
+    TELEM_SPEED_DKMH = TELEM_VESC_FIRST,  // 0.1 km/h
+    TELEM_POWER_W,           // input power, 1 W
+    TELEM_MOTOR_TEMP_DC,     // 0.1 degC
+    TELEM_FET_TEMP_DC,       // 0.1 degC
+    TELEM_ODO_KM,            // lifetime distance, 1 km
+    TELEM_ID_COUNT,
+} telem_id_t;
+
+void telem_init(void);
+
+// Reset the BMS (pack/temps/cells) or VESC quantities to their "no data"
+// value (cell count 0, others unknown).
+void telem_reset_bms(void);
+void telem_reset_vesc(void);
+
+lv_subject_t *telem_subject(telem_id_t id);
+lv_subject_t *telem_cell_subject(int cell);   // cell voltage, 1 mV
+
+void telem_publish_int(telem_id_t id, int32_t value);
+// Quantize value * scale to the nearest integer; NaN/inf publish TELEM_UNKNOWN.
+void telem_publish_float(telem_id_t id, float value, float scale);
+void telem_publish_cell_mv(int cell, int32_t mv);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
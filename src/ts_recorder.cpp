@@ -0,0 +1,126 @@
+#include "ts_recorder.h"
+#include "ts_store.h"
+#include "minmax_pyramid.h"
+#include "telemetry_hub.h"
+#include "ant_bms_ble_module.h"
+#include "vesc_module.h"
+#include "ui_msg_queue.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static int s_ids[TS_REC_COUNT];
+static bool s_inited = false;
+static uint16_t s_hz = 5;
+
+// Min/max pyramids for long-window charts: one entry per tick, holding the
+// latest BMS sample, gaps once it is older than kStaleMs or for values the
+// BMS did not report.
+static constexpr ts_rec_series_t kPyramidSeries[] = {TS_REC_PACK_MV, TS_REC_CURRENT_MA, TS_REC_POWER_W};
+static constexpr int kPyramidCount = sizeof(kPyramidSeries) / sizeof(kPyramidSeries[0]);
+static constexpr uint32_t kStaleMs = 2000;
+static int s_pyramids[kPyramidCount] = {-1, -1, -1};
+
+static const char *const kNames[TS_REC_CELL0_MV] = {
+    "pack_mv", "current_ma", "power_w", "soc_dpct", "temp1_dc", "temp2_dc", "temp_mos_dc",
+    "speed_dkmh", "vesc_power_w", "motor_dc", "fet_dc",
+};
+
+static void append(ts_rec_series_t s, uint32_t t, int32_t v)
+{
+    ts_append(s_ids[s], t, v);
+}
+
+static void record_bms(const ant_bms_sample_t &b, uint32_t t)
+{
+    // Unknown values are skipped rather than stored as a sentinel.
+    if (b.pack_mv != ANT_BMS_UNKNOWN) append(TS_REC_PACK_MV, t, b.pack_mv);
+    if (b.current_ma != ANT_BMS_UNKNOWN) append(TS_REC_CURRENT_MA, t, b.current_ma);
+    if (b.power_w != ANT_BMS_UNKNOWN) append(TS_REC_POWER_W, t, b.power_w);
+    append(TS_REC_SOC_DPCT, t, b.soc_dpct);
+    if (b.temp_dc[0] != ANT_BMS_TEMP_UNKNOWN) append(TS_REC_TEMP1_DC, t, b.temp_dc[0]);
+    if (b.temp_dc[1] != ANT_BMS_TEMP_UNKNOWN) append(TS_REC_TEMP2_DC, t, b.temp_dc[1]);
+    if (b.temp_dc[6] != ANT_BMS_TEMP_UNKNOWN) append(TS_REC_TEMP_MOS_DC, t, b.temp_dc[6]);
+    for (int i = 0; i < b.cell_count && i < 32; i++) {
+        append((ts_rec_series_t)(TS_REC_CELL0_MV + i), t, b.cell_mv[i]);
+    }
+}
+
+static void record_vesc(const vesc_snapshot_t &v, uint32_t t)
+{
+    if (!v.connected) return;
+    append(TS_REC_VESC_SPEED_DKMH, t, v.speed_dkmh);
+    append(TS_REC_VESC_POWER_W, t, v.power_w);
+    append(TS_REC_VESC_MOTOR_DC, t, v.temp_motor_dc);
+    append(TS_REC_VESC_FET_DC, t, v.temp_fet_dc);
+}
+
+static void tick_pyramids(const ant_bms_sample_t &b, bool fresh)
+{
+    const int32_t values[kPyramidCount] = {b.pack_mv, b.current_ma, b.power_w};
+    for (int i = 0; i < kPyramidCount; i++) {
+        mmp_append(s_pyramids[i], fresh && values[i] != ANT_BMS_UNKNOWN, values[i]);
+    }
+}
+
+static void recorder_task(void *)
+{
+    const uint32_t period_ms = 1000 / s_hz;
+    // Decimate slightly under the period so a sample that lands a tick late
+    // is not skipped.
+    hub_reader_t bms, vesc;
+    hub_reader_init(&bms, HUB_CH_BMS, period_ms * 3 / 4);
+    hub_reader_init(&vesc, HUB_CH_VESC, period_ms * 3 / 4);
+    ant_bms_sample_t b = {};
+    vesc_snapshot_t v;
+    uint32_t b_ms = 0;
+    bool have_b = false;
+    TickType_t wake = xTaskGetTickCount();
+
+    for (;;) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(period_ms));
+        uint32_t t;
+        if (hub_read_latest(&bms, &b, &t)) {
+            record_bms(b, t);
+            b_ms = millis();
+            have_b = true;
+        }
+        tick_pyramids(b, have_b && millis() - b_ms < kStaleMs);
+        if (hub_read_latest(&vesc, &v, &t)) record_vesc(v, t);
+        // The pyramids advance (with gaps) even when no sample came in.
+        ui_msg_post_telemetry(UI_TELEM_SRC_RECORDER);
+    }
+}
+
+void ts_recorder_init(size_t pool_bytes, uint16_t hz)
+{
+    if (s_inited) return;
+    if (!ts_store_init(pool_bytes)) return;
+    s_inited = true;
+    s_hz = (hz == 0) ? 5 : (hz > 50 ? 50 : hz);
+
+    for (int i = 0; i < TS_REC_COUNT; i++) {
+        char name[16];
+        if (i < TS_REC_CELL0_MV) snprintf(name, sizeof(name), "%s", kNames[i]);
+        else snprintf(name, sizeof(name), "cell%02d_mv", i - TS_REC_CELL0_MV);
+        s_ids[i] = ts_series_add(name);
+    }
+    for (int i = 0; i < kPyramidCount; i++) s_pyramids[i] = mmp_create(s_hz);
+    xTaskCreatePinnedToCore(recorder_task, "ts_rec", 3072, nullptr, 1, nullptr, 0);
+}
+
+int ts_recorder_series(ts_rec_series_t s)
+{
+    if (!s_inited || s < 0 || s >= TS_REC_COUNT) return -1;
+    return s_ids[s];
+}
+
+int ts_recorder_pyramid(ts_rec_series_t s)
+{
+    for (int i = 0; i < kPyramidCount; i++) {
+        if (kPyramidSeries[i] == s) return s_pyramids[i];
+    }
+    return -1;
+}
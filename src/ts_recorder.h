@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Feeds ts_store from the telemetry hub at a fixed rate (default 5 Hz) on a
+// low-priority task. Charts look up series ids with ts_recorder_series().
+// Pack voltage, current and power also go into min/max pyramids
+// (minmax_pyramid.h) that cover the whole ride.
+
+typedef enum {
+    TS_REC_PACK_MV = 0,
+    TS_REC_CURRENT_MA,
+    TS_REC_POWER_W,
+    TS_REC_SOC_DPCT,
+    TS_REC_TEMP1_DC,
+    TS_REC_TEMP2_DC,
+    TS_REC_TEMP_MOS_DC,
+    TS_REC_VESC_SPEED_DKMH,
+    TS_REC_VESC_POWER_W,
+    TS_REC_VESC_MOTOR_DC,
+    TS_REC_VESC_FET_DC,
+    TS_REC_CELL0_MV,                           // cells 0..31 follow
+    TS_REC_COUNT = TS_REC_CELL0_MV + 32,
+} ts_rec_series_t;
+
+void ts_recorder_init(size_t pool_bytes, uint16_t hz);
+
+// ts_store series id, or -1 before init.
+int ts_recorder_series(ts_rec_series_t s);
+
+// minmax_pyramid id for TS_REC_PACK_MV, TS_REC_CURRENT_MA or TS_REC_POWER_W,
+// -1 for other series or before init.
+int ts_recorder_pyramid(ts_rec_series_t s);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
@@ -0,0 +1,348 @@
+#include "ts_store.h"
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <string.h>
+
+struct Block {
+    int16_t series;         // -1 = free
+    int16_t next;           // next (newer) block of the same series, -1 = none
+    uint16_t bit_len;
+    uint16_t count;
+    uint32_t alloc_seq;     // eviction order
+    uint32_t t_first;
+    uint32_t t_last;
+    int32_t v_first;
+    int32_t min;
+    int32_t max;
+    int64_t sum;
+    uint8_t data[];
+};
+
+static constexpr size_t kDataBytes = TS_BLOCK_BYTES - sizeof(Block);
+static constexpr uint32_t kDataBits = kDataBytes * 8;
+static constexpr uint32_t kMaxPointBits = 4 + 32 + 4 + 32;
+
+struct Series {
+    char name[16];
+    int16_t head;           // oldest block
+    int16_t tail;           // block being appended to
+    uint32_t last_t;
+    int32_t last_dt;
+    int32_t last_v;
+    uint32_t points;
+};
+
+static uint8_t *s_pool = nullptr;
+static int s_block_count = 0;
+static Series s_series[TS_MAX_SERIES];
+static int s_series_count = 0;
+static uint32_t s_alloc_seq = 0;
+static uint32_t s_evictions = 0;
+static SemaphoreHandle_t s_lock = nullptr;
+
+static Block *block(int idx)
+{
+    return reinterpret_cast<Block *>(s_pool + (size_t)idx * TS_BLOCK_BYTES);
+}
+
+static uint32_t zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v)
+{
+    return (int32_t)((v >> 1) ^ (0u - (v & 1u)));
+}
+
+// ---- bit I/O (MSB first) ----
+
+static void put_bits(Block *b, uint32_t value, int n)
+{
+    for (int i = n - 1; i >= 0; i--) {
+        uint32_t pos = b->bit_len++;
+        uint8_t &byte = b->data[pos >> 3];
+        if ((pos & 7) == 0) byte = 0;
+        if ((value >> i) & 1u) byte |= (uint8_t)(0x80u >> (pos & 7));
+    }
+}
+
+struct BitReader {
+    const Block *b;
+    uint32_t pos;
+
+    uint32_t get(int n)
+    {
+        uint32_t v = 0;
+        for (int i = 0; i < n; i++) {
+            uint32_t p = pos++;
+            v = (v << 1) | ((b->data[p >> 3] >> (7 - (p & 7))) & 1u);
+        }
+        return v;
+    }
+
+    // Number of leading 1s in a prefix of at most `max` bits.
+    int prefix(int max)
+    {
+        int n = 0;
+        while (n < max && get(1)) n++;
+        return n;
+    }
+};
+
+// Prefix buckets: '0', '10', '110', '1110', '1111'. Payload widths per bucket.
+static constexpr int kTsWidth[5] = {0, 7, 9, 12, 32};
+static constexpr int kValWidth[5] = {0, 6, 12, 20, 32};
+
+static int bucket_for(uint32_t zz, const int *widths)
+{
+    if (zz == 0) return 0;
+    for (int i = 1; i < 4; i++) {
+        if (zz < (1u << widths[i])) return i;
+    }
+    return 4;
+}
+
+static int bucket_bits(int bucket, const int *widths)
+{
+    return (bucket < 4 ? bucket + 1 : 4) + widths[bucket];
+}
+
+static void put_bucket(Block *b, int bucket, uint32_t zz, const int *widths)
+{
+    if (bucket < 4) put_bits(b, ((1u << bucket) - 1u) << 1, bucket + 1);
+    else put_bits(b, 0xF, 4);
+    if (widths[bucket]) put_bits(b, zz, widths[bucket]);
+}
+
+static uint32_t get_bucket(BitReader &r, const int *widths)
+{
+    int bucket = r.prefix(4);
+    return widths[bucket] ? r.get(widths[bucket]) : 0;
+}
+
+// ---- block pool ----
+
+static void unlink_head(int idx)
+{
+    Block *b = block(idx);
+    Series &s = s_series[b->series];
+    s.points -= b->count;
+    s.head = b->next;
+    if (s.tail == idx) s.tail = -1;
+    b->series = -1;
+    b->next = -1;
+}
+
+static int alloc_block()
+{
+    int victim = -1;
+    for (int i = 0; i < s_block_count; i++) {
+        Block *b = block(i);
+        if (b->series < 0) {
+            victim = i;
+            break;
+        }
+        // The globally oldest block is always the head of its own series.
+        if (victim < 0 || b->alloc_seq < block(victim)->alloc_seq) victim = i;
+    }
+    if (victim < 0) return -1;
+    if (block(victim)->series >= 0) {
+        unlink_head(victim);
+        s_evictions++;
+    }
+    Block *b = block(victim);
+    memset(b, 0, sizeof(Block));
+    b->series = -1;
+    b->next = -1;
+    b->alloc_seq = ++s_alloc_seq;
+    return victim;
+}
+
+static bool start_block(int series, uint32_t t, int32_t v)
+{
+    Series &s = s_series[series];
+    int idx = alloc_block();
+    if (idx < 0) return false;
+    Block *b = block(idx);
+    b->series = (int16_t)series;
+    b->count = 1;
+    b->t_first = b->t_last = t;
+    b->v_first = b->min = b->max = v;
+    b->sum = v;
+    // alloc_block may have evicted this series' own head; re-read the links.
+    if (s.tail >= 0) block(s.tail)->next = (int16_t)idx;
+    else s.head = (int16_t)idx;
+    s.tail = (int16_t)idx;
+    s.last_t = t;
+    s.last_dt = 0;
+    s.last_v = v;
+    s.points++;
+    return true;
+}
+
+bool ts_store_init(size_t pool_bytes)
+{
+    if (s_pool) return true;
+    s_block_count = (int)(pool_bytes / TS_BLOCK_BYTES);
+    if (s_block_count <= 0 || s_block_count > INT16_MAX) return false;
+    s_pool = (uint8_t *)heap_caps_malloc((size_t)s_block_count * TS_BLOCK_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!s_pool) s_pool = (uint8_t *)malloc((size_t)s_block_count * TS_BLOCK_BYTES);
+    if (!s_pool) return false;
+    for (int i = 0; i < s_block_count; i++) {
+        block(i)->series = -1;
+        block(i)->next = -1;
+    }
+    s_lock = xSemaphoreCreateMutex();
+    return true;
+}
+
+int ts_series_add(const char *name)
+{
+    if (s_series_count >= TS_MAX_SERIES) return -1;
+    Series &s = s_series[s_series_count];
+    memset(&s, 0, sizeof(s));
+    strncpy(s.name, name ? name : "", sizeof(s.name) - 1);
+    s.head = s.tail = -1;
+    return s_series_count++;
+}
+
+const char *ts_series_name(int series)
+{
+    return (series >= 0 && series < s_series_count) ? s_series[series].name : nullptr;
+}
+
+bool ts_append(int series, uint32_t t_ms, int32_t value)
+{
+    if (!s_pool || series < 0 || series >= s_series_count) return false;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    Series &s = s_series[series];
+    bool ok;
+    if (s.tail < 0 || block(s.tail)->count == 0xFFFF || t_ms < s.last_t) {
+        ok = (s.tail < 0 || t_ms >= s.last_t) && start_block(series, t_ms, value);
+    } else {
+        int32_t dt = (int32_t)(t_ms - s.last_t);
+        uint32_t ts_zz = zigzag(dt - s.last_dt);
+        uint32_t v_zz = zigzag((int32_t)((uint32_t)value - (uint32_t)s.last_v));
+        int tb = bucket_for(ts_zz, kTsWidth);
+        int vb = bucket_for(v_zz, kValWidth);
+        Block *b = block(s.tail);
+        if (b->bit_len + (uint32_t)(bucket_bits(tb, kTsWidth) + bucket_bits(vb, kValWidth)) > kDataBits) {
+            ok = start_block(series, t_ms, value);
+        } else {
+            put_bucket(b, tb, ts_zz, kTsWidth);
+            put_bucket(b, vb, v_zz, kValWidth);
+            b->count++;
+            b->t_last = t_ms;
+            if (value < b->min) b->min = value;
+            if (value > b->max) b->max = value;
+            b->sum += value;
+            s.last_t = t_ms;
+            s.last_dt = dt;
+            s.last_v = value;
+            s.points++;
+            ok = true;
+        }
+    }
+    xSemaphoreGive(s_lock);
+    return ok;
+}
+
+// Decode every point of a block, oldest first.
+template <typename F>
+static void decode_block(const Block *b, F &&visit)
+{
+    uint32_t t = b->t_first;
+    int32_t v = b->v_first;
+    int32_t dt = 0;
+    visit(t, v);
+    BitReader r{b, 0};
+    for (uint16_t i = 1; i < b->count; i++) {
+        dt += unzigzag(get_bucket(r, kTsWidth));
+        v = (int32_t)((uint32_t)v + (uint32_t)unzigzag(get_bucket(r, kValWidth)));
+        t += (uint32_t)dt;
+        visit(t, v);
+    }
+}
+
+uint32_t ts_query_range(int series, uint32_t t_from, uint32_t t_to, ts_point_cb_t cb, void *user_data)
+{
+    if (!s_pool || !cb || series < 0 || series >= s_series_count) return 0;
+    uint32_t n = 0;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int idx = s_series[series].head; idx >= 0; idx = block(idx)->next) {
+        const Block *b = block(idx);
+        if (b->t_last < t_from) continue;
+        if (b->t_first > t_to) break;
+        decode_block(b, [&](uint32_t t, int32_t v) {
+            if (t < t_from || t > t_to) return;
+            cb(t, v, user_data);
+            n++;
+        });
+    }
+    xSemaphoreGive(s_lock);
+    return n;
+}
+
+static void merge(ts_rollup_t &r, int32_t min, int32_t max, int64_t sum, uint32_t count)
+{
+    if (r.count == 0 || min < r.min) r.min = min;
+    if (r.count == 0 || max > r.max) r.max = max;
+    r.sum += sum;
+    r.count += count;
+}
+
+int ts_query_rollup(int series, uint32_t t_from, uint32_t t_to, uint32_t bucket_ms,
+                    ts_rollup_t *out, int max_buckets)
+{
+    if (!s_pool || !out || max_buckets <= 0 || bucket_ms == 0 || t_to < t_from ||
+        series < 0 || series >= s_series_count) {
+        return 0;
+    }
+    uint32_t span = (t_to - t_from) / bucket_ms + 1;
+    int buckets = (span < (uint32_t)max_buckets) ? (int)span : max_buckets;
+    for (int i = 0; i < buckets; i++) {
+        out[i] = {};
+        out[i].t_start = t_from + (uint32_t)i * bucket_ms;
+    }
+    const uint32_t t_end = t_from + (uint32_t)buckets * bucket_ms - 1;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int idx = s_series[series].head; idx >= 0; idx = block(idx)->next) {
+        const Block *b = block(idx);
+        if (b->t_last < t_from) continue;
+        if (b->t_first > t_end) break;
+        if (b->t_first >= t_from && b->t_last <= t_end &&
+            (b->t_first - t_from) / bucket_ms == (b->t_last - t_from) / bucket_ms) {
+            merge(out[(b->t_first - t_from) / bucket_ms], b->min, b->max, b->sum, b->count);
+            continue;
+        }
+        decode_block(b, [&](uint32_t t, int32_t v) {
+            if (t < t_from || t > t_end) return;
+            merge(out[(t - t_from) / bucket_ms], v, v, v, 1);
+        });
+    }
+    xSemaphoreGive(s_lock);
+    return buckets;
+}
+
+void ts_store_get_stats(ts_stats_t *out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!s_pool) return;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    out->blocks_total = s_block_count;
+    out->evictions = s_evictions;
+    for (int i = 0; i < s_block_count; i++) {
+        const Block *b = block(i);
+        if (b->series < 0) continue;
+        out->blocks_used++;
+        out->bits_used += b->bit_len;
+    }
+    for (int i = 0; i < s_series_count; i++) out->points += s_series[i].points;
+    xSemaphoreGive(s_lock);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// In-RAM compressed time series for on-device graphs. Points are
+// (t_ms, int32) pairs. Timestamps are stored as delta-of-delta and values as
+// zig-zag deltas in variable-width bit buckets (Gorilla-style, with integer
+// deltas instead of float XOR since all telemetry here is fixed point).
+// Storage is a pool of fixed-size PSRAM blocks; when it runs out the oldest
+// block of any series is evicted. Each block keeps min/max/sum/count so
+// coarse rollups skip decoding.
+
+#define TS_MAX_SERIES 48
+#define TS_BLOCK_BYTES 512          // including the block header
+
+typedef struct {
+    uint32_t t_start;               // bucket start
+    int32_t min;
+    int32_t max;
+    int64_t sum;
+    uint32_t count;                 // 0 = no data in this bucket
+} ts_rollup_t;
+
+typedef struct {
+    uint32_t blocks_total;
+    uint32_t blocks_used;
+    uint32_t evictions;
+    uint32_t points;                // currently held
+    uint32_t bits_used;             // compressed payload, all blocks
+} ts_stats_t;
+
+typedef void (*ts_point_cb_t)(uint32_t t_ms, int32_t value, void *user_data);
+
+// Allocate the block pool (PSRAM when present). Call once.
+bool ts_store_init(size_t pool_bytes);
+
+// Returns the series id, or -1 when the table is full.
+int ts_series_add(const char *name);
+const char *ts_series_name(int series);
+
+// Timestamps must not go backwards within a series.
+bool ts_append(int series, uint32_t t_ms, int32_t value);
+
+// Visit raw points with t_from <= t <= t_to, oldest first. Returns the count.
+uint32_t ts_query_range(int series, uint32_t t_from, uint32_t t_to, ts_point_cb_t cb, void *user_data);
+
+// Fixed-width buckets starting at t_from. Blocks that fall inside a single
+// bucket contribute their stored summary without being decoded. Returns the
+// number of buckets written.
+int ts_query_rollup(int series, uint32_t t_from, uint32_t t_to, uint32_t bucket_ms,
+                    ts_rollup_t *out, int max_buckets);
+
+void ts_store_get_stats(ts_stats_t *out);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
@@ -3,6 +3,14 @@
 #include "ui.h"
 #include "ui_Settings.h"
 #include "ant_bms_ble_module.h"
+#include "telemetry_model.h"
+#include "ui_bind.h"
+#include "ui_sparkline.h"
+#include "ui_minmax_chart.h"
+#include "ts_recorder.h"
+#include "ui_update_sched.h"
+#include "ui_msg_queue.h"
+#include "telemetry_hub.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -26,6 +34,41 @@ static lv_obj_t *s_cell_delta = NULL;
 static lv_obj_t *s_cell_high = NULL;
 static lv_obj_t *s_cell_low = NULL;
 static lv_obj_t *s_cell_list = NULL;
+static lv_obj_t *s_cell_spark_title = NULL;
+static lv_obj_t *s_cell_spark = NULL;
+
+// Cell drift sparklines: deviation from the pack mean, one column per BMS sample.
+static constexpr uint8_t kSparkStripH = 10;
+static constexpr int16_t kDriftRangeMv = 40;
+static constexpr int16_t kDriftWarnMv = 15;
+static int s_ch_spark = -1;
+static hub_reader_t s_spark_reader;
+
+// Pack trend chart under the connection panel. Tap the title for the next
+// series, the chart for the next window.
+struct TrendSeries {
+    ts_rec_series_t rec;
+    const char *name;
+    const char *unit;
+    int32_t div;                  // raw units per displayed unit
+    uint32_t color;
+};
+static const TrendSeries kTrendSeries[] = {
+    {TS_REC_CURRENT_MA, "Current", "A", 1000, 0x3AA0D1},
+    {TS_REC_POWER_W, "Power", "W", 1, 0xD1873A},
+    {TS_REC_PACK_MV, "Voltage", "V", 1000, 0x3AD16A},
+};
+static const uint32_t kTrendWindows[] = {30, 300, 1800, 0};
+static const char *const kTrendWindowNames[] = {"30 s", "5 min", "30 min", "ride"};
+static constexpr int kTrendSeriesCount = sizeof(kTrendSeries) / sizeof(kTrendSeries[0]);
+static constexpr int kTrendWindowCount = sizeof(kTrendWindows) / sizeof(kTrendWindows[0]);
+static constexpr int32_t kTrendChartH = 90;
+static lv_obj_t *s_trend_title = NULL;
+static lv_obj_t *s_trend_chart = NULL;
+static int s_trend_series = 0;
+static int s_trend_window = 1;
+static int s_trend_bound = -1;    // pyramid the chart is showing
+static int s_ch_trend = -1;
 
 static lv_obj_t *s_cell_rows[32];
 static lv_obj_t *s_cell_value_labels[32];
@@ -238,6 +281,19 @@ static void setup_cell_container(void)
     lv_label_set_text(s_cell_low, "Low: --");
     lv_obj_set_style_text_font(s_cell_low, &ui_font_Euro15, LV_PART_MAIN | LV_STATE_DEFAULT);
 
+    s_cell_spark_title = lv_label_create(ui_Cell_info);
+    lv_label_set_text_fmt(s_cell_spark_title, "Drift vs mean (+/-%d mV)", kDriftRangeMv);
+    lv_obj_set_style_text_font(s_cell_spark_title, &ui_font_Euro15, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    lv_obj_update_layout(ui_Cell_info);
+    int32_t spark_w = lv_obj_get_content_width(ui_Cell_info);
+    if (spark_w < 32) spark_w = 200;
+    s_cell_spark = ui_sparkline_create(ui_Cell_info, spark_w, kSparkStripH, ANT_BMS_MAX_CELLS);
+    if (s_cell_spark) {
+        ui_sparkline_set_strips(s_cell_spark, 1);
+        ui_sparkline_set_range(s_cell_spark, -kDriftRangeMv, kDriftRangeMv, kDriftWarnMv);
+    }
+
     s_cell_list = lv_obj_create(ui_Cell_info);
     lv_obj_set_width(s_cell_list, lv_pct(100));
     lv_obj_set_height(s_cell_list, LV_SIZE_CONTENT);
@@ -253,11 +309,250 @@ static void setup_cell_container(void)
     lv_obj_set_style_text_color(s_cell_list, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
 }
 
+static void mos_fmt(lv_obj_t *label, int32_t on, void *user_data)
+{
+    const char *prefix = (const char *)user_data;
+    char buf[8];
+    snprintf(buf, sizeof(buf), "%s %s", prefix, (on == 1) ? "ON" : "OFF");
+    lv_label_set_text(label, buf);
+    lv_obj_set_style_text_color(label, (on == 1) ? lv_color_hex(0x3AD16A) : lv_color_hex(0xD13A3A),
+                                LV_PART_MAIN | LV_STATE_DEFAULT);
+}
+
+static void soc_fmt(lv_obj_t *label, int32_t soc_pct, void *user_data)
+{
+    (void)user_data;
+    if (soc_pct == TELEM_UNKNOWN || soc_pct < 0 || soc_pct > 1000) {
+        lv_label_set_text(label, "--");
+        return;
+    }
+    lv_label_set_text_fmt(label, "%ld%%", (long)soc_pct);
+}
+
+// High/low labels depend on two subjects (index and voltage); both bind here.
+static void cell_extreme_fmt(lv_obj_t *label, int32_t unused, void *user_data)
+{
+    (void)unused;
+    bool high = (user_data != NULL);
+    int32_t idx = lv_subject_get_int(telem_subject(high ? TELEM_CELL_HIGH_IDX : TELEM_CELL_LOW_IDX));
+    int32_t mv = lv_subject_get_int(telem_subject(high ? TELEM_CELL_HIGH_MV : TELEM_CELL_LOW_MV));
+    const char *title = high ? "High:" : "Low: ";
+    if (idx == TELEM_UNKNOWN || mv == TELEM_UNKNOWN) {
+        lv_label_set_text_fmt(label, "%s --", title);
+        return;
+    }
+    lv_label_set_text_fmt(label, "%s C%02ld %ld.%03ldV", title, (long)(idx + 1), (long)(mv / 1000), (long)(mv % 1000));
+}
+
+static void cell_value_fmt(lv_obj_t *bar, int32_t mv, void *user_data)
+{
+    int i = (int)(intptr_t)user_data;
+    lv_obj_t *label = lv_obj_get_child(bar, 0);
+    if (mv == TELEM_UNKNOWN) {
+        if (label) lv_label_set_text_fmt(label, "C%02d --.-", i + 1);
+        return;
+    }
+    int32_t clamped = mv;
+    if (clamped < 3000) clamped = 3000;
+    if (clamped > 4200) clamped = 4200;
+    lv_bar_set_value(bar, clamped, LV_ANIM_OFF);
+    lv_color_t c = lv_color_hex(0xD13A3A);
+    if (mv >= 3600) c = lv_color_hex(0x3AD16A);
+    else if (mv >= 3200) c = lv_color_hex(0xD1B93A);
+    lv_obj_set_style_bg_color(bar, c, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    if (label) lv_label_set_text_fmt(label, "C%02d %ld.%03ld", i + 1, (long)(mv / 1000), (long)(mv % 1000));
+}
+
+static void cells_rebuild(lv_obj_t *list, int32_t n, void *user_data)
+{
+    (void)user_data;
+    if (n < 0) n = 0;
+    if (n > 32) n = 32;
+    if (n == s_cell_count) return;
+    s_cell_count = n;
+    lv_obj_clean(list);
+    for (int i = 0; i < n; i++) {
+        lv_obj_t *row = lv_obj_create(list);
+        lv_obj_set_width(row, lv_pct(100));
+        lv_obj_set_height(row, 24);
+        lv_obj_remove_flag(row, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_set_style_pad_all(row, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_opa(row, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+        lv_obj_t *bar = lv_bar_create(row);
+        lv_obj_set_width(bar, lv_pct(100));
+        lv_obj_set_height(bar, 20);
+        lv_obj_set_align(bar, LV_ALIGN_CENTER);
+        lv_bar_set_range(bar, 3000, 4200);
+        lv_bar_set_value(bar, 3600, LV_ANIM_OFF);
+        lv_obj_set_style_bg_color(bar, lv_color_hex(0x202020), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_opa(bar, 120, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_opa(bar, 255, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+        lv_obj_set_style_radius(bar, 6, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_radius(bar, 6, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+
+        lv_obj_t *label = lv_label_create(bar);
+        lv_label_set_text(label, "C00 --.-");
+        lv_obj_center(label);
+        lv_obj_set_style_text_color(label, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+        s_cell_rows[i] = row;
+        s_cell_bars[i] = bar;
+        s_cell_value_labels[i] = label;
+        ui_bind_int(bar, telem_cell_subject(i), cell_value_fmt, (void *)(intptr_t)i);
+    }
+    lv_obj_set_height(list, LV_SIZE_CONTENT);
+}
+
+static void apply_spark(void *user_data)
+{
+    (void)user_data;
+    ant_bms_sample_t b;
+    while (hub_read_next(&s_spark_reader, &b, NULL)) {
+        if (!s_cell_spark) continue;
+        int n = b.cell_count;
+        if (n > ANT_BMS_MAX_CELLS) n = ANT_BMS_MAX_CELLS;
+        if (n == 0) {
+            ui_sparkline_push(s_cell_spark, NULL, 0);
+            continue;
+        }
+        int32_t sum = 0;
+        for (int i = 0; i < n; i++) sum += b.cell_mv[i];
+        const int32_t mean = sum / n;
+        int16_t dev[ANT_BMS_MAX_CELLS];
+        for (int i = 0; i < n; i++) {
+            int32_t d = (int32_t)b.cell_mv[i] - mean;
+            if (d < -INT16_MAX) d = -INT16_MAX;
+            if (d > INT16_MAX) d = INT16_MAX;
+            dev[i] = (int16_t)d;
+        }
+        ui_sparkline_set_strips(s_cell_spark, (uint8_t)n);
+        ui_sparkline_push(s_cell_spark, dev, (uint8_t)n);
+    }
+}
+
+static void trend_update_title(void)
+{
+    if (!s_trend_title) return;
+    const TrendSeries &ts = kTrendSeries[s_trend_series];
+    char buf[64];
+    int32_t lo, hi;
+    if (ui_minmax_chart_get_range(s_trend_chart, &lo, &hi)) {
+        const int prec = (ts.div > 1) ? 1 : 0;
+        snprintf(buf, sizeof(buf), "%s | %s  %.*f..%.*f %s", ts.name, kTrendWindowNames[s_trend_window],
+                 prec, (double)lo / ts.div, prec, (double)hi / ts.div, ts.unit);
+    } else {
+        snprintf(buf, sizeof(buf), "%s | %s  no data", ts.name, kTrendWindowNames[s_trend_window]);
+    }
+    lv_label_set_text(s_trend_title, buf);
+}
+
+static void apply_trend(void *user_data)
+{
+    (void)user_data;
+    if (!s_trend_chart || !ui_battery_is_active()) return;
+    // The recorder starts after the UI, so the pyramid is bound lazily.
+    const TrendSeries &ts = kTrendSeries[s_trend_series];
+    const int pyr = ts_recorder_pyramid(ts.rec);
+    if (pyr != s_trend_bound) {
+        s_trend_bound = pyr;
+        ui_minmax_chart_set_source(s_trend_chart, pyr, lv_color_hex(ts.color));
+        trend_update_title();
+        return;
+    }
+    if (ui_minmax_chart_refresh(s_trend_chart)) trend_update_title();
+}
+
+static void trend_series_cb(lv_event_t *e)
+{
+    (void)e;
+    s_trend_series = (s_trend_series + 1) % kTrendSeriesCount;
+    s_trend_bound = -2;
+    apply_trend(NULL);
+}
+
+static void trend_window_cb(lv_event_t *e)
+{
+    (void)e;
+    s_trend_window = (s_trend_window + 1) % kTrendWindowCount;
+    ui_minmax_chart_set_window(s_trend_chart, kTrendWindows[s_trend_window]);
+    trend_update_title();
+}
+
+static void setup_trend_panel(void)
+{
+    lv_obj_t *parent = lv_obj_get_parent(ui_Battery_Connect_info);
+    if (!parent) return;
+    lv_obj_t *panel = lv_obj_create(parent);
+    lv_obj_remove_style_all(panel);
+    lv_obj_set_width(panel, lv_pct(49));
+    lv_obj_set_height(panel, LV_SIZE_CONTENT);
+    lv_obj_set_align(panel, LV_ALIGN_TOP_LEFT);
+    lv_obj_set_y(panel, lv_obj_get_style_height(ui_Battery_Connect_info, LV_PART_MAIN) + 8);
+    lv_obj_remove_flag(panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_radius(panel, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_color(panel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_opa(panel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(panel, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_all(panel, 6, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_row(panel, 4, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(panel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_flex_flow(panel, LV_FLEX_FLOW_COLUMN);
+
+    s_trend_title = lv_label_create(panel);
+    lv_obj_set_style_text_font(s_trend_title, &ui_font_Euro15, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_flag(s_trend_title, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(s_trend_title, trend_series_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_update_layout(panel);
+    int32_t w = lv_obj_get_content_width(panel);
+    if (w < 32) w = 200;
+    s_trend_chart = ui_minmax_chart_create(panel, w, kTrendChartH);
+    if (s_trend_chart) {
+        lv_obj_add_flag(s_trend_chart, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(s_trend_chart, trend_window_cb, LV_EVENT_CLICKED, NULL);
+        ui_minmax_chart_set_window(s_trend_chart, kTrendWindows[s_trend_window]);
+    }
+    s_trend_bound = -2;
+    trend_update_title();
+}
+
+static void bind_telemetry(void)
+{
+    if (ui_Voltage) ui_bind_label_fixed(ui_Voltage, telem_subject(TELEM_PACK_V_DV), "%sv", 1);
+    if (ui_Amps) ui_bind_label_fixed(ui_Amps, telem_subject(TELEM_PACK_A_DA), "%sa", 1);
+    if (ui_battery_percent) ui_bind_int(ui_battery_percent, telem_subject(TELEM_SOC_PCT), soc_fmt, NULL);
+    if (s_conn_mos_c) ui_bind_int(s_conn_mos_c, telem_subject(TELEM_CHG_ON), mos_fmt, (void *)"C");
+    if (s_conn_mos_d) ui_bind_int(s_conn_mos_d, telem_subject(TELEM_DSG_ON), mos_fmt, (void *)"D");
+    if (s_cell_delta) ui_bind_label_fixed(s_cell_delta, telem_subject(TELEM_CELL_DELTA_MV), "Δ Cell: %s V", 3);
+    if (s_cell_high) {
+        ui_bind_int(s_cell_high, telem_subject(TELEM_CELL_HIGH_IDX), cell_extreme_fmt, (void *)1);
+        ui_bind_int(s_cell_high, telem_subject(TELEM_CELL_HIGH_MV), cell_extreme_fmt, (void *)1);
+    }
+    if (s_cell_low) {
+        ui_bind_int(s_cell_low, telem_subject(TELEM_CELL_LOW_IDX), cell_extreme_fmt, NULL);
+        ui_bind_int(s_cell_low, telem_subject(TELEM_CELL_LOW_MV), cell_extreme_fmt, NULL);
+    }
+    if (s_cell_list) ui_bind_int(s_cell_list, telem_subject(TELEM_CELL_COUNT), cells_rebuild, NULL);
+}
+
 void ui_battery_bridge_init(void)
 {
     if (!ui_Battery_Connect_info || !ui_Cell_info) return;
     setup_conn_container();
     setup_cell_container();
+    setup_trend_panel();
+    telem_init();
+    bind_telemetry();
+    if (s_ch_spark < 0) {
+        hub_reader_init(&s_spark_reader, HUB_CH_BMS, 0);
+        s_ch_spark = ui_sched_add_channel("cell_spark", apply_spark, NULL, 5, UI_SCHED_EXPENSIVE);
+        ui_sched_set_channel_sources(s_ch_spark, UI_TELEM_SRC_BMS);
+        s_ch_trend = ui_sched_add_channel("batt_trend", apply_trend, NULL, 2, UI_SCHED_EXPENSIVE);
+        // The chart scrolls on recorder ticks, so it keeps moving (and shows
+        // the gap) while the BMS is disconnected.
+        ui_sched_set_channel_sources(s_ch_trend, UI_TELEM_SRC_BMS | UI_TELEM_SRC_RECORDER);
+    }
 }
 
 void ui_battery_bridge_deinit(void)
@@ -280,6 +575,10 @@ void ui_battery_bridge_deinit(void)
     s_cell_high = NULL;
     s_cell_low = NULL;
     s_cell_list = NULL;
+    s_cell_spark_title = NULL;
+    s_cell_spark = NULL;
+    s_trend_title = NULL;
+    s_trend_chart = NULL;
     s_cell_count = 0;
     s_scan_count = 0;
     s_selected_mac[0] = '\0';
@@ -335,127 +634,6 @@ void ui_battery_set_connection_state(ui_battery_conn_state_t state, const char *
     }
 }
 
-void ui_battery_set_pack_values(float pack_v, float pack_a, bool chg_on, bool dsg_on)
-{
-    char buf[24];
-    if (ui_Voltage) {
-        snprintf(buf, sizeof(buf), "%.1fv", pack_v);
-        lv_label_set_text(ui_Voltage, buf);
-    }
-    if (ui_Amps) {
-        snprintf(buf, sizeof(buf), "%.1fa", pack_a);
-        lv_label_set_text(ui_Amps, buf);
-    }
-    if (s_conn_mos_c && s_conn_mos_d) {
-        lv_label_set_text(s_conn_mos_c, chg_on ? "C ON" : "C OFF");
-        lv_label_set_text(s_conn_mos_d, dsg_on ? "D ON" : "D OFF");
-        lv_obj_set_style_text_color(s_conn_mos_c,
-                                    chg_on ? lv_color_hex(0x3AD16A) : lv_color_hex(0xD13A3A),
-                                    LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_obj_set_style_text_color(s_conn_mos_d,
-                                    dsg_on ? lv_color_hex(0x3AD16A) : lv_color_hex(0xD13A3A),
-                                    LV_PART_MAIN | LV_STATE_DEFAULT);
-    }
-}
-
-void ui_battery_set_soc(float soc_pct)
-{
-    if (!ui_battery_percent) return;
-    if (soc_pct < 0.0f || soc_pct > 1000.0f) {
-        lv_label_set_text(ui_battery_percent, "--");
-        return;
-    }
-    char buf[16];
-    snprintf(buf, sizeof(buf), "%.0f%%", soc_pct);
-    lv_label_set_text(ui_battery_percent, buf);
-}
-
-void ui_battery_set_temps(float t1, float t2, float t_mos_optional, bool has_mos_temp)
-{
-    (void)t1;
-    (void)t2;
-    (void)t_mos_optional;
-    (void)has_mos_temp;
-}
-
-void ui_battery_set_temps_all(const float *temps, int count, float t_mos_optional, bool has_mos_temp)
-{
-    (void)temps;
-    (void)count;
-    (void)t_mos_optional;
-    (void)has_mos_temp;
-}
-
-void ui_battery_set_cell_summary(float delta_v, int low_i, float low_v, int high_i, float high_v)
-{
-    if (!s_cell_delta || !s_cell_high || !s_cell_low) return;
-    char buf[40];
-    snprintf(buf, sizeof(buf), "Δ Cell: %.3f V", delta_v);
-    lv_label_set_text(s_cell_delta, buf);
-    snprintf(buf, sizeof(buf), "High: C%02d %.3fV", high_i + 1, high_v);
-    lv_label_set_text(s_cell_high, buf);
-    snprintf(buf, sizeof(buf), "Low:  C%02d %.3fV", low_i + 1, low_v);
-    lv_label_set_text(s_cell_low, buf);
-}
-
-void ui_battery_cells_set_count(int n)
-{
-    if (!s_cell_list) return;
-    if (n < 0) n = 0;
-    if (n > 32) n = 32;
-    s_cell_count = n;
-    lv_obj_clean(s_cell_list);
-    for (int i = 0; i < n; i++) {
-        lv_obj_t *row = lv_obj_create(s_cell_list);
-        lv_obj_set_width(row, lv_pct(100));
-        lv_obj_set_height(row, 24);
-        lv_obj_remove_flag(row, LV_OBJ_FLAG_SCROLLABLE);
-        lv_obj_set_style_pad_all(row, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_obj_set_style_bg_opa(row, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-        lv_obj_t *bar = lv_bar_create(row);
-        lv_obj_set_width(bar, lv_pct(100));
-        lv_obj_set_height(bar, 20);
-        lv_obj_set_align(bar, LV_ALIGN_CENTER);
-        lv_bar_set_range(bar, 3000, 4200);
-        lv_bar_set_value(bar, 3600, LV_ANIM_OFF);
-        lv_obj_set_style_bg_color(bar, lv_color_hex(0x202020), LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_obj_set_style_bg_opa(bar, 120, LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_obj_set_style_bg_opa(bar, 255, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-        lv_obj_set_style_radius(bar, 6, LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_obj_set_style_radius(bar, 6, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-
-        lv_obj_t *label = lv_label_create(bar);
-        lv_label_set_text(label, "C00 --.-");
-        lv_obj_center(label);
-        lv_obj_set_style_text_color(label, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-
-        s_cell_rows[i] = row;
-        s_cell_bars[i] = bar;
-        s_cell_value_labels[i] = label;
-    }
-    lv_obj_set_height(s_cell_list, LV_SIZE_CONTENT);
-}
-
-void ui_battery_cells_set_value(int i, float v)
-{
-    if (i < 0 || i >= s_cell_count) return;
-    if (!s_cell_value_labels[i]) return;
-    int mv = (int)(v * 1000.0f);
-    if (mv < 3000) mv = 3000;
-    if (mv > 4200) mv = 4200;
-    if (s_cell_bars[i]) {
-        lv_bar_set_value(s_cell_bars[i], mv, LV_ANIM_OFF);
-        lv_color_t c = lv_color_hex(0xD13A3A);
-        if (v >= 3.6f) c = lv_color_hex(0x3AD16A);
-        else if (v >= 3.2f) c = lv_color_hex(0xD1B93A);
-        lv_obj_set_style_bg_color(s_cell_bars[i], c, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    }
-    char buf[16];
-    snprintf(buf, sizeof(buf), "C%02d %.3f", i + 1, v);
-    lv_label_set_text(s_cell_value_labels[i], buf);
-}
-
 void ui_battery_scanlist_clear(void)
 {
     if (!s_scan_list) return;
@@ -27,14 +27,8 @@ void onBatteryConnectPressed(const char *mac);
 void onBatteryDeviceSelected(const char *mac);
 
 // Public UI bridge API (same as Waveshareport battery screen).
+// Pack, SoC and cell widgets are bound to telemetry_model subjects at init.
 void ui_battery_set_connection_state(ui_battery_conn_state_t state, const char *name, const char *mac);
-void ui_battery_set_pack_values(float pack_v, float pack_a, bool chg_on, bool dsg_on);
-void ui_battery_set_soc(float soc_pct);
-void ui_battery_set_temps(float t1, float t2, float t_mos_optional, bool has_mos_temp);
-void ui_battery_set_temps_all(const float *temps, int count, float t_mos_optional, bool has_mos_temp);
-void ui_battery_set_cell_summary(float delta_v, int low_i, float low_v, int high_i, float high_v);
-void ui_battery_cells_set_count(int n);
-void ui_battery_cells_set_value(int i, float v);
 
 // Scan list control.
 void ui_battery_scanlist_clear(void);
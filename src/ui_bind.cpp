@@ -0,0 +1,189 @@
+#include "ui_bind.h"
+#include "telemetry_model.h"
+
+#include <stdio.h>
+
+struct Binding {
+    Binding *prev;
+    Binding *next;
+    lv_subject_t *subject;
+    lv_obj_t *obj;
+    ui_bind_fmt_cb_t fmt;
+    void *user_data;
+    bool dirty;
+    // ui_bind_label_fixed
+    const char *label_fmt;
+    uint8_t decimals;
+};
+
+static Binding *s_head = nullptr;
+
+// Screens / tabviews we already listen on for "became visible".
+static constexpr int kMaxHooks = 8;
+static lv_obj_t *s_hooked[kMaxHooks];
+
+static void list_remove(Binding *b)
+{
+    if (b->prev) b->prev->next = b->next;
+    else s_head = b->next;
+    if (b->next) b->next->prev = b->prev;
+    b->prev = b->next = nullptr;
+}
+
+// Visible = on the active screen, no hidden ancestor, and on the active page
+// of every tabview on the way up.
+static bool is_visible(lv_obj_t *obj)
+{
+    if (lv_obj_get_screen(obj) != lv_screen_active()) return false;
+    lv_obj_t *child = obj;
+    while (child) {
+        if (lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) return false;
+        lv_obj_t *parent = lv_obj_get_parent(child);
+        if (parent) {
+            lv_obj_t *tv = lv_obj_get_parent(parent);
+            if (tv && lv_obj_check_type(tv, &lv_tabview_class) && parent == lv_tabview_get_content(tv)) {
+                if ((uint32_t)lv_obj_get_index(child) != lv_tabview_get_tab_active(tv)) return false;
+            }
+        }
+        child = parent;
+    }
+    return true;
+}
+
+static void apply(Binding *b)
+{
+    b->dirty = false;
+    b->fmt(b->obj, lv_subject_get_int(b->subject), b->user_data);
+}
+
+static void observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+    (void)subject;
+    Binding *b = (Binding *)lv_observer_get_user_data(observer);
+    if (!b) return;
+    if (!is_visible(b->obj)) {
+        b->dirty = true;
+        return;
+    }
+    apply(b);
+}
+
+static void binding_delete_cb(lv_event_t *e)
+{
+    Binding *b = (Binding *)lv_event_get_user_data(e);
+    list_remove(b);
+    lv_free(b);
+}
+
+static void hook_delete_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = (lv_obj_t *)lv_event_get_target(e);
+    for (int i = 0; i < kMaxHooks; i++) {
+        if (s_hooked[i] == obj) s_hooked[i] = nullptr;
+    }
+}
+
+static void resume_cb(lv_event_t *e)
+{
+    (void)e;
+    ui_bind_flush();
+}
+
+static void hook(lv_obj_t *obj, lv_event_code_t code)
+{
+    int free_slot = -1;
+    for (int i = 0; i < kMaxHooks; i++) {
+        if (s_hooked[i] == obj) return;
+        if (!s_hooked[i] && free_slot < 0) free_slot = i;
+    }
+    if (free_slot < 0) return;
+    s_hooked[free_slot] = obj;
+    lv_obj_add_event_cb(obj, resume_cb, code, nullptr);
+    lv_obj_add_event_cb(obj, hook_delete_cb, LV_EVENT_DELETE, nullptr);
+}
+
+static void hook_scopes(lv_obj_t *obj)
+{
+    hook(lv_obj_get_screen(obj), LV_EVENT_SCREEN_LOADED);
+    for (lv_obj_t *p = lv_obj_get_parent(obj); p; p = lv_obj_get_parent(p)) {
+        if (lv_obj_check_type(p, &lv_tabview_class)) hook(p, LV_EVENT_VALUE_CHANGED);
+    }
+}
+
+static Binding *alloc_binding(lv_obj_t *obj, lv_subject_t *subject, ui_bind_fmt_cb_t fmt, void *user_data)
+{
+    if (!obj || !subject || !fmt) return nullptr;
+    Binding *b = (Binding *)lv_malloc_zeroed(sizeof(Binding));
+    if (!b) return nullptr;
+    b->subject = subject;
+    b->obj = obj;
+    b->fmt = fmt;
+    b->user_data = user_data;
+    b->next = s_head;
+    if (s_head) s_head->prev = b;
+    s_head = b;
+    return b;
+}
+
+static void attach(Binding *b)
+{
+    hook_scopes(b->obj);
+    lv_obj_add_event_cb(b->obj, binding_delete_cb, LV_EVENT_DELETE, b);
+    // Adding the observer evaluates it once, so the widget starts in sync.
+    lv_subject_add_observer_obj(b->subject, observer_cb, b->obj, b);
+}
+
+void ui_bind_int(lv_obj_t *obj, lv_subject_t *subject, ui_bind_fmt_cb_t fmt, void *user_data)
+{
+    Binding *b = alloc_binding(obj, subject, fmt, user_data);
+    if (b) attach(b);
+}
+
+static void fixed_label_fmt(lv_obj_t *obj, int32_t value, void *user_data)
+{
+    const Binding *b = (const Binding *)user_data;
+    char num[16];
+    if (value == TELEM_UNKNOWN) {
+        snprintf(num, sizeof(num), "--");
+    } else if (b->decimals == 0) {
+        snprintf(num, sizeof(num), "%ld", (long)value);
+    } else {
+        int32_t div = 1;
+        for (uint8_t i = 0; i < b->decimals; i++) div *= 10;
+        int32_t mag = (value < 0) ? -value : value;
+        snprintf(num, sizeof(num), "%s%ld.%0*ld", (value < 0) ? "-" : "", (long)(mag / div),
+                 (int)b->decimals, (long)(mag % div));
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), b->label_fmt, num);
+    lv_label_set_text(obj, buf);
+}
+
+void ui_bind_label_fixed(lv_obj_t *label, lv_subject_t *subject, const char *fmt, uint8_t decimals)
+{
+    if (!fmt) return;
+    Binding *b = alloc_binding(label, subject, fixed_label_fmt, nullptr);
+    if (!b) return;
+    // The formatter needs the format, so the binding is its own user data.
+    b->user_data = b;
+    b->label_fmt = fmt;
+    b->decimals = decimals;
+    attach(b);
+}
+
+void ui_bind_flush(void)
+{
+    // A formatter may create or delete bindings (e.g. the cell list), so
+    // restart from the head after every apply instead of holding an iterator.
+    bool again = true;
+    while (again) {
+        again = false;
+        for (Binding *b = s_head; b; b = b->next) {
+            if (b->dirty && is_visible(b->obj)) {
+                apply(b);
+                again = true;
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bind a widget to an int subject through a formatter. The formatter runs
+// only when the subject changes and the widget is on the active screen (and
+// on the active tab when it lives inside a tabview). Changes that arrive
+// while hidden are applied once when the screen/tab becomes visible again.
+// Bindings are released automatically when the widget is deleted.
+
+typedef void (*ui_bind_fmt_cb_t)(lv_obj_t *obj, int32_t value, void *user_data);
+
+void ui_bind_int(lv_obj_t *obj, lv_subject_t *subject, ui_bind_fmt_cb_t fmt, void *user_data);
+
+// Label showing a fixed-point value with `decimals` fraction digits, e.g.
+// ("%sv", 1) turns 844 into "84.4v". `fmt` must contain exactly one %s and
+// must outlive the label. Unknown values render as "--".
+void ui_bind_label_fixed(lv_obj_t *label, lv_subject_t *subject, const char *fmt, uint8_t decimals);
+
+// Apply pending changes to bindings that are visible now.
+void ui_bind_flush(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
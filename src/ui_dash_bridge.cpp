@@ -0,0 +1,192 @@
+#include "ui_dash_bridge.h"
+
+#include "ui.h"
+#include "ui_Mainui.h"
+#include "telemetry_model.h"
+#include "ui_bind.h"
+#include "ui_static_layer.h"
+#include "ui_numeric.h"
+#include "asset_pack.h"
+#include "ui_image_variant.h"
+
+#include "esp_heap_caps.h"
+#include <stdio.h>
+
+// Cache the dashboard chrome (background, arc tracks, settings icon) in one
+// image so each frame only draws the knobs and value labels on top.
+#ifndef UI_DASH_STATIC_LAYER
+#define UI_DASH_STATIC_LAYER 1
+#endif
+
+// Pre-blended tiles of the big value digits (white on the panel color), so
+// a changed digit is copied instead of decoded and blended again.
+#ifndef UI_DASH_GLYPH_ATLAS
+#define UI_DASH_GLYPH_ATLAS LV_DRAW_SW_GLYPH_ATLAS
+#endif
+#define UI_DASH_GLYPH_ATLAS_BYTES (96 * 1024)
+
+// Fixed-cell speed, power and odometer readouts that redraw only the digits
+// that changed, instead of the whole label box.
+#ifndef UI_DASH_NUMERIC
+#define UI_DASH_NUMERIC 1
+#endif
+
+static uint16_t s_speed_max_kmh = 60;
+static uint16_t s_power_max_w = 3000;
+
+static lv_obj_t *s_speed_value;
+static lv_obj_t *s_power_value;
+static lv_obj_t *s_odo_value;
+
+static void apply_ranges(void)
+{
+    if (ui_Speed) lv_arc_set_range(ui_Speed, 0, s_speed_max_kmh * 10);
+    if (ui_Watts) lv_arc_set_range(ui_Watts, 0, s_power_max_w);
+}
+
+static void arc_fmt(lv_obj_t *obj, int32_t value, void *)
+{
+    // Regen shows as zero on the power arc; lv_arc clamps to its range.
+    lv_arc_set_value(obj, (value == TELEM_UNKNOWN || value < 0) ? 0 : value);
+}
+
+// Values are clamped to the digits the layout has room for.
+static void set_value_text(lv_obj_t *obj, const char *text)
+{
+    if (lv_obj_check_type(obj, &lv_label_class)) lv_label_set_text(obj, text);
+    else ui_numeric_set_text(obj, text);
+}
+
+static void speed_fmt(lv_obj_t *obj, int32_t value, void *)
+{
+    char buf[8];
+    if (value == TELEM_UNKNOWN) snprintf(buf, sizeof(buf), "--");
+    else snprintf(buf, sizeof(buf), "%02ld", (long)LV_MIN((value + 5) / 10, 99));
+    set_value_text(obj, buf);
+}
+
+static void power_fmt(lv_obj_t *obj, int32_t value, void *)
+{
+    char buf[12];
+    if (value == TELEM_UNKNOWN) snprintf(buf, sizeof(buf), "----");
+    // Regen is negative; both ends are clamped so the sign fits the 4 cells.
+    else snprintf(buf, sizeof(buf), "%04ld", (long)LV_CLAMP(-999, value, 9999));
+    set_value_text(obj, buf);
+}
+
+static void odo_fmt(lv_obj_t *obj, int32_t value, void *)
+{
+    char buf[12];
+    if (value == TELEM_UNKNOWN) snprintf(buf, sizeof(buf), "------");
+    else snprintf(buf, sizeof(buf), "%06ld", (long)LV_MIN(value, 999999));
+    set_value_text(obj, buf);
+}
+
+static void setup_static_layer(void)
+{
+    ui_static_layer_t *layer = ui_static_layer_create(ui_Mainui);
+    if (!layer) return;
+    ui_static_layer_add_static(layer, ui_Mainui, LV_PART_MAIN);
+    lv_obj_t *const arcs[] = {ui_Speed, ui_Watts};
+    for (lv_obj_t *arc : arcs) {
+        if (!arc) continue;
+        ui_static_layer_add_static(layer, arc, LV_PART_MAIN);
+        ui_static_layer_add_dynamic(layer, arc, LV_PART_INDICATOR);
+        ui_static_layer_add_dynamic(layer, arc, LV_PART_KNOB);
+    }
+    if (ui_settings1) ui_static_layer_add_static(layer, ui_settings1, LV_PART_MAIN);
+    lv_obj_t *const values[] = {s_speed_value, s_power_value, ui_Temps, s_odo_value};
+    for (lv_obj_t *obj : values) {
+        if (obj) ui_static_layer_add_dynamic(layer, obj, LV_PART_MAIN);
+    }
+    ui_static_layer_build(layer);
+}
+
+#if UI_DASH_GLYPH_ATLAS
+static void setup_glyph_atlas(void)
+{
+    static void *s_tiles = nullptr;
+    if (!s_tiles) {
+        s_tiles = heap_caps_malloc(UI_DASH_GLYPH_ATLAS_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_tiles) return;
+        lv_draw_sw_glyph_atlas_init(s_tiles, UI_DASH_GLYPH_ATLAS_BYTES);
+    }
+    // The fonts the value labels ended up with, built-in or from the pack.
+    lv_obj_t *const labels[] = {ui_Speedlabel, ui_Watt_Label};
+    for (lv_obj_t *obj : labels) {
+        if (obj) lv_draw_sw_glyph_atlas_add_font(lv_obj_get_style_text_font(obj, LV_PART_MAIN));
+    }
+}
+#endif
+
+// Pack assets override the built-in ones by name.
+static void apply_pack_assets(void)
+{
+    const struct {
+        lv_obj_t *obj;
+        const char *font;
+    } fonts[] = {{ui_Speedlabel, "Euro60"}, {ui_Watt_Label, "Euro40"}};
+    for (const auto &f : fonts) {
+        const lv_font_t *font = asset_pack_font(f.font);
+        if (f.obj && font) lv_obj_set_style_text_font(f.obj, font, LV_PART_MAIN);
+    }
+    const lv_image_dsc_t *img = asset_pack_image("settings");
+    if (ui_settings1 && img) lv_image_set_src(ui_settings1, img);
+}
+
+// The scaled, recolored settings icon as a pre-baked mask.
+static void setup_icons(void)
+{
+    if (ui_settings1) ui_image_variant_attach(ui_settings1);
+}
+
+static void setup_values(void)
+{
+    s_speed_value = ui_Speedlabel;
+    s_power_value = ui_Watt_Label;
+    s_odo_value = ui_Odometer;
+#if UI_DASH_NUMERIC
+    lv_obj_t *num;
+    if (ui_Speedlabel && (num = ui_numeric_replace_label(ui_Speedlabel, 2))) s_speed_value = num;
+    if (ui_Watt_Label && (num = ui_numeric_replace_label(ui_Watt_Label, 4))) s_power_value = num;
+    if (ui_Odometer && (num = ui_numeric_replace_label(ui_Odometer, 6))) s_odo_value = num;
+#endif
+}
+
+void ui_dash_bridge_init(void)
+{
+    if (!ui_Mainui) return;
+    telem_init();
+    apply_ranges();
+    apply_pack_assets();
+    setup_icons();
+    setup_values();
+
+    if (ui_Speed) ui_bind_int(ui_Speed, telem_subject(TELEM_SPEED_DKMH), arc_fmt, NULL);
+    if (s_speed_value) ui_bind_int(s_speed_value, telem_subject(TELEM_SPEED_DKMH), speed_fmt, NULL);
+    if (ui_Watts) ui_bind_int(ui_Watts, telem_subject(TELEM_POWER_W), arc_fmt, NULL);
+    if (s_power_value) ui_bind_int(s_power_value, telem_subject(TELEM_POWER_W), power_fmt, NULL);
+    if (ui_Motor_Temp) ui_bind_label_fixed(ui_Motor_Temp, telem_subject(TELEM_MOTOR_TEMP_DC), "%sc", 1);
+    if (ui_Controller_temp) ui_bind_label_fixed(ui_Controller_temp, telem_subject(TELEM_FET_TEMP_DC), "%sc", 1);
+    if (s_odo_value) ui_bind_int(s_odo_value, telem_subject(TELEM_ODO_KM), odo_fmt, NULL);
+#if UI_DASH_GLYPH_ATLAS
+    setup_glyph_atlas();
+#endif
+#if UI_DASH_STATIC_LAYER
+    setup_static_layer();
+#endif
+}
+
+void ui_dash_bridge_deinit(void)
+{
+    s_speed_value = NULL;
+    s_power_value = NULL;
+    s_odo_value = NULL;
+}
+
+void ui_dash_bridge_set_ranges(uint16_t speed_max_kmh, uint16_t power_max_w)
+{
+    if (speed_max_kmh > 0) s_speed_max_kmh = speed_max_kmh;
+    if (power_max_w > 0) s_power_max_w = power_max_w;
+    apply_ranges();
+}
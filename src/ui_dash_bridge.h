@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binds the Mainui dashboard (speed/power arcs and labels, temps, odometer)
+// to the VESC telemetry subjects. Called by ui_screens after Mainui is
+// built; the deinit before it is destroyed.
+// Unless UI_DASH_STATIC_LAYER is 0, the static chrome is drawn from a cached
+// layer (ui_static_layer.h).
+void ui_dash_bridge_init(void);
+void ui_dash_bridge_deinit(void);
+
+// Full-scale values for the speed and power arcs.
+void ui_dash_bridge_set_ranges(uint16_t speed_max_kmh, uint16_t power_max_w);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
@@ -0,0 +1,377 @@
+#include "ui_image_variant.h"
+
+// lv_cache is not part of the public lvgl.h; the private headers give
+// lv_cache_ops_t, the size slot of lv_cache_class_lru_rb_size nodes, the
+// transformed-area helper and the software transform the renderer uses.
+#include "src/misc/cache/lv_cache.h"
+#include "src/misc/cache/lv_cache_private.h"
+#include "src/misc/cache/instance/lv_image_cache.h"
+#include "src/draw/lv_draw_image_private.h"
+#include "src/draw/sw/lv_draw_sw.h"
+
+#include "esp_heap_caps.h"
+#include <string.h>
+
+// One cache node. The key fields come first after the size slot and are
+// what compare_cb looks at; create_cb fills in the pixels.
+struct Variant {
+    lv_cache_slot_size_t slot;     // bytes, for the size-bounded LRU
+    const lv_image_dsc_t *src;
+    int32_t scale_x;
+    int32_t scale_y;
+    int32_t rotation;
+    lv_point_t pivot;
+    lv_area_t crop;                // kept part, relative to the image origin
+    uint8_t cf;                    // LV_COLOR_FORMAT_A8 or _RGB565A8
+    bool antialias;
+
+    uint8_t *px;
+    lv_image_dsc_t dsc;
+};
+
+// What the image was set up with, restored when no variant fits.
+struct Attached {
+    const lv_image_dsc_t *src;
+    int32_t scale_x;
+    int32_t scale_y;
+    int32_t rotation;
+    lv_point_t pivot;
+    bool antialias;
+    lv_image_align_t align;
+    lv_point_t offset;
+    lv_area_t crop;
+    lv_point_t place;              // crop origin relative to the object
+    lv_cache_entry_t *entry;       // pinned while shown
+    uint8_t cf;                    // format picked last, 0: the original
+    bool busy;
+    bool pending;                  // refresh queued with lv_async_call()
+};
+
+static lv_cache_t *s_cache;
+static ui_image_variant_stats_t s_stats;
+
+static void *px_alloc(size_t n)
+{
+    // Icons are small: internal RAM blits fastest, PSRAM if that is short.
+    void *p = heap_caps_malloc(n, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    return p ? p : heap_caps_malloc(n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+}
+
+static uint32_t variant_bytes(const lv_area_t *crop, uint8_t cf)
+{
+    const uint32_t n = (uint32_t)lv_area_get_width(crop) * lv_area_get_height(crop);
+    return cf == LV_COLOR_FORMAT_A8 ? n : n * 3;
+}
+
+template <typename T>
+static lv_cache_compare_res_t cmp(T a, T b)
+{
+    return a < b ? -1 : a > b ? 1 : 0;
+}
+
+static lv_cache_compare_res_t compare_cb(const Variant *a, const Variant *b)
+{
+    if (a->src != b->src) return cmp((uintptr_t)a->src, (uintptr_t)b->src);
+    const int32_t ka[] = {a->scale_x, a->scale_y, a->rotation, a->pivot.x, a->pivot.y,
+                          a->crop.x1, a->crop.y1, a->crop.x2, a->crop.y2, a->cf, a->antialias};
+    const int32_t kb[] = {b->scale_x, b->scale_y, b->rotation, b->pivot.x, b->pivot.y,
+                          b->crop.x1, b->crop.y1, b->crop.x2, b->crop.y2, b->cf, b->antialias};
+    for (size_t i = 0; i < sizeof(ka) / sizeof(ka[0]); i++) {
+        if (ka[i] != kb[i]) return cmp(ka[i], kb[i]);
+    }
+    return 0;
+}
+
+// Transform (or just crop) the source into v->px with the same sampling the
+// software renderer uses on screen.
+static bool create_cb(Variant *v, void *)
+{
+    const lv_image_header_t *h = &v->src->header;
+    const int32_t w = lv_area_get_width(&v->crop);
+    const int32_t ht = lv_area_get_height(&v->crop);
+    v->px = (uint8_t *)px_alloc(v->slot.size);
+    if (!v->px) return false;
+
+    const uint8_t *src = (const uint8_t *)v->src->data;
+    const lv_color_format_t src_cf = (lv_color_format_t)h->cf;
+    int32_t stride = h->stride ? h->stride : (int32_t)lv_color_format_get_size(src_cf) * h->w;
+    const bool transformed = v->scale_x != LV_SCALE_NONE || v->scale_y != LV_SCALE_NONE || v->rotation != 0;
+
+    if (!transformed) {
+        // Untransformed variants are masks: a crop of the alpha. RGB565A8
+        // keeps it after the RGB565 plane, at half the stride.
+        if (src_cf == LV_COLOR_FORMAT_RGB565A8) {
+            src += stride * h->h;
+            stride /= 2;
+        }
+        uint8_t *dst = v->px;
+        for (int32_t y = 0; y < ht; y++, dst += w) memcpy(dst, src + (v->crop.y1 + y) * stride + v->crop.x1, w);
+    }
+    else {
+        lv_draw_image_dsc_t d;
+        lv_draw_image_dsc_init(&d);
+        d.scale_x = v->scale_x;
+        d.scale_y = v->scale_y;
+        d.rotation = v->rotation;
+        d.pivot = v->pivot;
+        d.antialias = v->antialias;
+        if (src_cf == LV_COLOR_FORMAT_RGB565A8 && v->cf == LV_COLOR_FORMAT_A8) {
+            // Transform the whole image and keep its alpha plane: sampling the
+            // alpha on its own (as A8) mixes the neighbours differently from
+            // what the renderer does for RGB565A8.
+            uint8_t *tmp = (uint8_t *)px_alloc(v->slot.size * 3);
+            if (!tmp) {
+                heap_caps_free(v->px);
+                v->px = nullptr;
+                return false;
+            }
+            lv_draw_sw_transform(&v->crop, src, h->w, h->h, stride, &d, NULL, src_cf, tmp);
+            memcpy(v->px, tmp + v->slot.size * 2, v->slot.size);
+            heap_caps_free(tmp);
+        }
+        else {
+            lv_draw_sw_transform(&v->crop, src, h->w, h->h, stride, &d, NULL, src_cf, v->px);
+        }
+    }
+
+    memset(&v->dsc, 0, sizeof(v->dsc));
+    v->dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    v->dsc.header.cf = v->cf;
+    v->dsc.header.w = w;
+    v->dsc.header.h = ht;
+    v->dsc.header.stride = v->cf == LV_COLOR_FORMAT_A8 ? w : w * 2;
+    v->dsc.data_size = v->slot.size;
+    v->dsc.data = v->px;
+    s_stats.bakes++;
+    return true;
+}
+
+static void free_cb(Variant *v, void *)
+{
+    lv_image_cache_drop(&v->dsc);
+    heap_caps_free(v->px);
+    v->px = nullptr;
+}
+
+static bool cache_init(void)
+{
+    if (s_cache) return true;
+    lv_cache_ops_t ops = {};
+    ops.compare_cb = (lv_cache_compare_cb_t)compare_cb;
+    ops.create_cb = (lv_cache_create_cb_t)create_cb;
+    ops.free_cb = (lv_cache_free_cb_t)free_cb;
+    s_cache = lv_cache_create(&lv_cache_class_lru_rb_size, sizeof(Variant), UI_IMAGE_VARIANT_CACHE_BYTES, ops);
+    if (s_cache) lv_cache_set_name(s_cache, "UI_IMAGE_VARIANT");
+    return s_cache != nullptr;
+}
+
+static void show(lv_obj_t *obj, Attached *a, lv_cache_entry_t *entry)
+{
+    a->busy = true;
+    if (entry) {
+        const Variant *v = (const Variant *)lv_cache_entry_get_data(entry);
+        lv_image_set_src(obj, &v->dsc);
+        lv_image_set_scale(obj, LV_SCALE_NONE);
+        lv_image_set_rotation(obj, 0);
+        lv_image_set_inner_align(obj, LV_IMAGE_ALIGN_TOP_LEFT);
+        lv_image_set_offset_x(obj, a->place.x);
+        lv_image_set_offset_y(obj, a->place.y);
+    }
+    else {
+        lv_image_set_src(obj, a->src);
+        lv_image_set_scale_x(obj, a->scale_x);
+        lv_image_set_scale_y(obj, a->scale_y);
+        lv_image_set_rotation(obj, a->rotation);
+        lv_image_set_inner_align(obj, a->align);
+        lv_image_set_offset_x(obj, a->offset.x);
+        lv_image_set_offset_y(obj, a->offset.y);
+    }
+    if (a->entry) {
+        lv_cache_release(s_cache, a->entry, NULL);
+        s_stats.attached--;
+    }
+    a->entry = entry;
+    if (entry) s_stats.attached++;
+    a->busy = false;
+}
+
+// The variant format that fits the current recolor, 0 for none.
+static uint8_t pick_cf(lv_obj_t *obj, const Attached *a)
+{
+    const uint8_t src_cf = a->src->header.cf;
+    if (src_cf == LV_COLOR_FORMAT_A8) return LV_COLOR_FORMAT_A8;
+    if (src_cf == LV_COLOR_FORMAT_RGB565A8 &&
+        lv_obj_get_style_image_recolor_opa(obj, LV_PART_MAIN) >= LV_OPA_MAX) {
+        return LV_COLOR_FORMAT_A8;
+    }
+    // Untransformed and not a mask: a variant would only copy the source.
+    const bool transformed = a->scale_x != LV_SCALE_NONE || a->scale_y != LV_SCALE_NONE || a->rotation != 0;
+    return transformed ? LV_COLOR_FORMAT_RGB565A8 : 0;
+}
+
+static void refresh(lv_obj_t *obj, Attached *a)
+{
+    a->cf = pick_cf(obj, a);
+    if (!a->cf) {
+        if (a->entry) show(obj, a, nullptr);
+        return;
+    }
+
+    Variant key;
+    memset(&key, 0, sizeof(key));
+    key.src = a->src;
+    key.scale_x = a->scale_x;
+    key.scale_y = a->scale_y;
+    key.rotation = a->rotation;
+    key.pivot = a->pivot;
+    key.crop = a->crop;
+    key.cf = a->cf;
+    key.antialias = a->antialias;
+    key.slot.size = variant_bytes(&a->crop, a->cf);
+    if (a->entry && compare_cb(&key, (const Variant *)lv_cache_entry_get_data(a->entry)) == 0) return;
+
+    lv_cache_entry_t *entry = lv_cache_acquire(s_cache, &key, NULL);
+    if (entry) s_stats.hits++;
+    else entry = lv_cache_acquire_or_create(s_cache, &key, NULL);
+    // Out of room (everything pinned) or memory: draw the original.
+    show(obj, a, entry);
+}
+
+static Attached *attached_of(lv_obj_t *obj);
+
+static void async_refresh(void *obj)
+{
+    Attached *a = attached_of((lv_obj_t *)obj);
+    if (!a) return;
+    a->pending = false;
+    refresh((lv_obj_t *)obj, a);
+}
+
+static void event_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = (lv_obj_t *)lv_event_get_current_target(e);
+    Attached *a = (Attached *)lv_event_get_user_data(e);
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_DELETE:
+        if (a->pending) lv_async_call_cancel(async_refresh, obj);
+        if (a->entry) {
+            lv_cache_release(s_cache, a->entry, NULL);
+            s_stats.attached--;
+        }
+        lv_free(a);
+        break;
+    case LV_EVENT_STYLE_CHANGED:
+    case LV_EVENT_PRESSED:
+    case LV_EVENT_RELEASED:
+    case LV_EVENT_PRESS_LOST:
+    case LV_EVENT_FOCUSED:
+    case LV_EVENT_DEFOCUSED:
+        if (!a->busy) refresh(obj, a);
+        break;
+    case LV_EVENT_DRAW_MAIN_BEGIN:
+        // Other recolor changes (a local style, a state set in code) only
+        // show up here; the source can't be swapped mid-render, so this
+        // frame is drawn as is and the next timer pass re-picks.
+        if (!a->pending && pick_cf(obj, a) != a->cf) {
+            a->pending = true;
+            lv_async_call(async_refresh, obj);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static Attached *attached_of(lv_obj_t *obj)
+{
+    const uint32_t n = lv_obj_get_event_count(obj);
+    for (uint32_t i = 0; i < n; i++) {
+        lv_event_dsc_t *d = lv_obj_get_event_dsc(obj, i);
+        if (lv_event_dsc_get_cb(d) == event_cb) return (Attached *)lv_event_dsc_get_user_data(d);
+    }
+    return nullptr;
+}
+
+bool ui_image_variant_attach(lv_obj_t *img)
+{
+    if (!img || !lv_obj_check_type(img, &lv_image_class) || attached_of(img)) return false;
+    const void *src_any = lv_image_get_src(img);
+    if (lv_image_src_get_type(src_any) != LV_IMAGE_SRC_VARIABLE) return false;
+    const lv_image_dsc_t *src = (const lv_image_dsc_t *)src_any;
+    const uint8_t cf = src->header.cf;
+    if (cf != LV_COLOR_FORMAT_A8 && cf != LV_COLOR_FORMAT_RGB565 && cf != LV_COLOR_FORMAT_RGB565A8) return false;
+    const lv_image_align_t align = lv_image_get_inner_align(img);
+    if (align >= _LV_IMAGE_ALIGN_AUTO_TRANSFORM) return false;
+    if (!cache_init()) return false;
+
+    Attached *a = (Attached *)lv_malloc_zeroed(sizeof(Attached));
+    if (!a) return false;
+    a->src = src;
+    a->scale_x = lv_image_get_scale_x(img);
+    a->scale_y = lv_image_get_scale_y(img);
+    a->rotation = lv_image_get_rotation(img);
+    lv_image_get_pivot(img, &a->pivot);
+    a->antialias = lv_image_get_antialias(img);
+    a->align = align;
+    a->offset.x = lv_image_get_offset_x(img);
+    a->offset.y = lv_image_get_offset_y(img);
+
+    // Pin the size: a content-sized image would shrink to the variant.
+    lv_obj_update_layout(img);
+    lv_area_t box;
+    lv_obj_get_coords(img, &box);
+    lv_obj_set_size(img, lv_area_get_width(&box), lv_area_get_height(&box));
+
+    // Where LVGL puts the untransformed image, and what of its transformed
+    // area (relative to the image origin) the object shows.
+    lv_area_t origin;
+    lv_area_set(&origin, 0, 0, src->header.w - 1, src->header.h - 1);
+    lv_area_align(&box, &origin, (lv_align_t)align, a->offset.x, a->offset.y);
+    lv_area_t drawn;
+    lv_image_buf_get_transformed_area(&drawn, src->header.w, src->header.h, a->rotation, a->scale_x, a->scale_y,
+                                      &a->pivot);
+    const lv_area_t shown = {box.x1 - origin.x1, box.y1 - origin.y1, box.x2 - origin.x1, box.y2 - origin.y1};
+    const bool transformed = a->scale_x != LV_SCALE_NONE || a->scale_y != LV_SCALE_NONE || a->rotation != 0;
+    const bool spills = drawn.x1 < shown.x1 || drawn.y1 < shown.y1 || drawn.x2 > shown.x2 || drawn.y2 > shown.y2;
+    a->crop.x1 = LV_MAX(drawn.x1, shown.x1);
+    a->crop.y1 = LV_MAX(drawn.y1, shown.y1);
+    a->crop.x2 = LV_MIN(drawn.x2, shown.x2);
+    a->crop.y2 = LV_MIN(drawn.y2, shown.y2);
+    if ((transformed && spills) || a->crop.x1 > a->crop.x2 || a->crop.y1 > a->crop.y2) {
+        lv_free(a);
+        return false;
+    }
+    a->place.x = origin.x1 - box.x1 + a->crop.x1;
+    a->place.y = origin.y1 - box.y1 + a->crop.y1;
+
+    lv_obj_add_event_cb(img, event_cb, LV_EVENT_ALL, a);
+    refresh(img, a);
+    return a->entry != nullptr;
+}
+
+uint32_t ui_image_variant_attach_tree(lv_obj_t *root)
+{
+    if (!root) return 0;
+    uint32_t n = 0;
+    if (lv_obj_check_type(root, &lv_image_class)) {
+        const bool transformed = lv_image_get_scale_x(root) != LV_SCALE_NONE ||
+                                 lv_image_get_scale_y(root) != LV_SCALE_NONE || lv_image_get_rotation(root) != 0;
+        const bool recolored = lv_obj_get_style_image_recolor_opa(root, LV_PART_MAIN) >= LV_OPA_MAX;
+        if ((transformed || recolored) && ui_image_variant_attach(root)) n++;
+    }
+    const uint32_t count = lv_obj_get_child_count(root);
+    for (uint32_t i = 0; i < count; i++) n += ui_image_variant_attach_tree(lv_obj_get_child(root, i));
+    return n;
+}
+
+void ui_image_variant_refresh(lv_obj_t *img)
+{
+    Attached *a = img ? attached_of(img) : nullptr;
+    if (a && !a->busy) refresh(img, a);
+}
+
+void ui_image_variant_get_stats(ui_image_variant_stats_t *out)
+{
+    *out = s_stats;
+    out->bytes = s_cache ? (uint32_t)lv_cache_get_size(s_cache, NULL) : 0;
+}
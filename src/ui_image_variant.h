@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pre-baked variants of scaled, rotated or recolored icons. LVGL transforms
+// and recolors an image on every draw; an attached image instead shows a
+// buffer that holds the already transformed pixels, cropped to what the
+// object shows, so each draw is a plain blit:
+//
+//   - full-opacity recolor: an A8 mask of the transformed alpha. LVGL fills
+//     A8 images with the recolor color, so state colors (e.g. white, black
+//     when pressed) share one variant and are never re-baked.
+//   - otherwise: RGB565A8 with the transform applied; a partial recolor is
+//     still mixed in by LVGL, but without the transform pass.
+//
+// Variants are keyed on (source, scale, rotation, pivot, crop, format) and
+// live in an LRU lv_cache bounded to UI_IMAGE_VARIANT_CACHE_BYTES; the one an
+// object shows stays pinned until the object switches or is deleted.
+
+#ifndef UI_IMAGE_VARIANT_CACHE_BYTES
+#define UI_IMAGE_VARIANT_CACHE_BYTES (16 * 1024)
+#endif
+
+typedef struct {
+    uint32_t bytes;            // variant pixels held by the cache
+    uint16_t attached;         // images currently showing a variant
+    uint32_t bakes;
+    uint32_t hits;             // lookups served without baking
+} ui_image_variant_stats_t;
+
+// Attach after the image's final source, scale, rotation and styles are set.
+// The object keeps its size and position. False (and the image left as is)
+// for sources that are not A8, RGB565 or RGB565A8 variables, for the
+// contain/cover/stretch/tile inner alignments, for transformed images that
+// spill outside their object, and when there is nothing to save.
+bool ui_image_variant_attach(lv_obj_t *img);
+
+// Attach every image in the subtree that has a transform or a full-opacity
+// recolor. Returns the number attached.
+uint32_t ui_image_variant_attach_tree(lv_obj_t *root);
+
+// Re-pick the variant now after code changes the recolor opacity (a local
+// style, a checked or disabled state). Press and focus changes are handled
+// right away; other changes are noticed at the next draw and applied one
+// frame later.
+void ui_image_variant_refresh(lv_obj_t *img);
+
+void ui_image_variant_get_stats(ui_image_variant_stats_t *out);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
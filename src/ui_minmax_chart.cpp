@@ -0,0 +1,182 @@
+#include "ui_minmax_chart.h"
+#include "minmax_pyramid.h"
+
+#include "esp_heap_caps.h"
+#include <stdlib.h>
+
+struct Chart {
+    lv_draw_buf_t buf;
+    uint16_t *px;
+    uint32_t stride_px;
+    int32_t w;
+    int32_t h;
+    mmp_pair_t *cols;
+    int pyramid;
+    uint16_t color;
+    uint32_t window_s;
+    uint32_t drawn_samples;         // pyramid length at the last redraw
+    bool dirty;
+    int32_t lo;                     // axis
+    int32_t hi;
+    int32_t data_lo;                // visible data
+    int32_t data_hi;
+    bool has_range;
+};
+
+static uint16_t s_bg;
+static uint16_t s_grid;
+
+static void *psram_alloc(size_t n)
+{
+    void *p = heap_caps_malloc(n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return p ? p : malloc(n);
+}
+
+static void delete_cb(lv_event_t *e)
+{
+    Chart *c = (Chart *)lv_event_get_user_data(e);
+    heap_caps_free(c->px);
+    heap_caps_free(c->cols);
+    lv_free(c);
+}
+
+static Chart *chart_of(lv_obj_t *obj)
+{
+    return obj ? (Chart *)lv_obj_get_user_data(obj) : nullptr;
+}
+
+static int32_t y_of(const Chart *c, int32_t v)
+{
+    const int64_t span = (int64_t)c->hi - c->lo;
+    int32_t y = (int32_t)(((int64_t)c->hi - v) * (c->h - 1) / span);
+    if (y < 0) y = 0;
+    if (y >= c->h) y = c->h - 1;
+    return y;
+}
+
+static void redraw(Chart *c)
+{
+    const uint32_t hz = mmp_hz(c->pyramid);
+    c->drawn_samples = mmp_samples(c->pyramid);
+    mmp_render(c->pyramid, c->window_s * hz, c->cols, c->w);
+
+    int32_t lo = INT32_MAX, hi = INT32_MIN;
+    for (int32_t x = 0; x < c->w; x++) {
+        if (c->cols[x].min > c->cols[x].max) continue;
+        if (c->cols[x].min < lo) lo = c->cols[x].min;
+        if (c->cols[x].max > hi) hi = c->cols[x].max;
+    }
+    c->has_range = lo <= hi;
+    if (c->has_range) {
+        c->data_lo = lo;
+        c->data_hi = hi;
+        // A little headroom so the trace does not sit on the border.
+        const int64_t pad = ((int64_t)hi - lo) / 16 + 1;
+        c->lo = (int32_t)LV_MAX((int64_t)INT32_MIN, lo - pad);
+        c->hi = (int32_t)LV_MIN((int64_t)INT32_MAX, hi + pad);
+    }
+
+    for (int32_t y = 0; y < c->h; y++) {
+        uint16_t *row = c->px + (uint32_t)y * c->stride_px;
+        for (int32_t x = 0; x < c->w; x++) row[x] = s_bg;
+    }
+    if (!c->has_range) return;
+    if (c->lo < 0 && c->hi > 0) {
+        uint16_t *row = c->px + (uint32_t)y_of(c, 0) * c->stride_px;
+        for (int32_t x = 0; x < c->w; x += 2) row[x] = s_grid;
+    }
+
+    int32_t prev_top = -1, prev_bot = -1;
+    for (int32_t x = 0; x < c->w; x++) {
+        const mmp_pair_t &p = c->cols[x];
+        if (p.min > p.max) {
+            prev_top = -1;
+            continue;
+        }
+        int32_t top = y_of(c, p.max);
+        int32_t bot = y_of(c, p.min);
+        // Bridge to the previous column so steep edges stay connected.
+        const int32_t t = top, b = bot;
+        if (prev_top >= 0) {
+            if (prev_bot < top) top = prev_bot;
+            if (prev_top > bot) bot = prev_top;
+        }
+        prev_top = t;
+        prev_bot = b;
+        uint16_t *px = c->px + x;
+        for (int32_t y = top; y <= bot; y++) px[(uint32_t)y * c->stride_px] = c->color;
+    }
+}
+
+lv_obj_t *ui_minmax_chart_create(lv_obj_t *parent, int32_t width, int32_t height)
+{
+    if (width < 2 || height < 2) return NULL;
+    if (!s_bg) {
+        s_bg = lv_color_to_u16(lv_color_hex(0x101010));
+        s_grid = lv_color_to_u16(lv_color_hex(0x4A4A4A));
+    }
+
+    Chart *c = (Chart *)lv_malloc_zeroed(sizeof(Chart));
+    if (!c) return NULL;
+    c->w = width;
+    c->h = height;
+    c->pyramid = -1;
+    c->color = lv_color_to_u16(lv_color_hex(0x3AD16A));
+    c->stride_px = lv_draw_buf_width_to_stride((uint32_t)width, LV_COLOR_FORMAT_RGB565) / 2;
+    c->px = (uint16_t *)psram_alloc(c->stride_px * 2 * (size_t)height);
+    c->cols = (mmp_pair_t *)psram_alloc(sizeof(mmp_pair_t) * (size_t)width);
+    if (!c->px || !c->cols) {
+        heap_caps_free(c->px);
+        heap_caps_free(c->cols);
+        lv_free(c);
+        return NULL;
+    }
+
+    lv_obj_t *obj = lv_canvas_create(parent);
+    lv_obj_set_user_data(obj, c);
+    lv_obj_add_event_cb(obj, delete_cb, LV_EVENT_DELETE, c);
+    lv_draw_buf_init(&c->buf, (uint32_t)width, (uint32_t)height, LV_COLOR_FORMAT_RGB565, c->stride_px * 2,
+                     c->px, c->stride_px * 2 * (uint32_t)height);
+    lv_canvas_set_draw_buf(obj, &c->buf);
+    redraw(c);
+    return obj;
+}
+
+void ui_minmax_chart_set_source(lv_obj_t *chart, int pyramid, lv_color_t color)
+{
+    Chart *c = chart_of(chart);
+    if (!c) return;
+    c->pyramid = pyramid;
+    c->color = lv_color_to_u16(color);
+    c->dirty = true;
+    ui_minmax_chart_refresh(chart);
+}
+
+void ui_minmax_chart_set_window(lv_obj_t *chart, uint32_t seconds)
+{
+    Chart *c = chart_of(chart);
+    if (!c) return;
+    c->window_s = seconds;
+    c->dirty = true;
+    ui_minmax_chart_refresh(chart);
+}
+
+bool ui_minmax_chart_refresh(lv_obj_t *chart)
+{
+    Chart *c = chart_of(chart);
+    if (!c) return false;
+    if (!c->dirty && mmp_samples(c->pyramid) == c->drawn_samples) return false;
+    c->dirty = false;
+    redraw(c);
+    lv_obj_invalidate(chart);
+    return true;
+}
+
+bool ui_minmax_chart_get_range(lv_obj_t *chart, int32_t *lo, int32_t *hi)
+{
+    Chart *c = chart_of(chart);
+    if (!c || !c->has_range) return false;
+    if (lo) *lo = c->data_lo;
+    if (hi) *hi = c->data_hi;
+    return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Live chart over a minmax_pyramid series. Every refresh renders exactly one
+// min/max span per pixel column, whether the window is 30 s or the whole
+// ride, so cost depends on the canvas size, not the history length. The
+// y axis fits the visible data. Pixels and column pairs live in PSRAM.
+
+// Returns NULL when the buffers cannot be allocated.
+lv_obj_t *ui_minmax_chart_create(lv_obj_t *parent, int32_t width, int32_t height);
+
+// Pyramid id from mmp_create(), -1 = none. Forces a redraw.
+void ui_minmax_chart_set_source(lv_obj_t *chart, int pyramid, lv_color_t color);
+
+// Window in seconds, 0 = everything recorded. Forces a redraw.
+void ui_minmax_chart_set_window(lv_obj_t *chart, uint32_t seconds);
+
+// Redraw if the pyramid has new samples. Returns true when it redrew.
+bool ui_minmax_chart_refresh(lv_obj_t *chart);
+
+// Data range of the last redraw; false when nothing was visible.
+bool ui_minmax_chart_get_range(lv_obj_t *chart, int32_t *lo, int32_t *hi);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
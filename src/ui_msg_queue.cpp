@@ -0,0 +1,287 @@
+#include "ui_msg_queue.h"
+
+#include <lvgl.h>
+#include <string.h>
+#include <atomic>
+
+static_assert((UI_MSG_QUEUE_CAPACITY & (UI_MSG_QUEUE_CAPACITY - 1)) == 0, "capacity must be a power of two");
+static_assert(UI_MSG_QUEUE_RESERVE < UI_MSG_QUEUE_CAPACITY, "reserve must leave room for droppable messages");
+
+// Bounded MPSC ring (Vyukov): each cell carries a sequence number so
+// producers claim slots with a single CAS and never block each other.
+struct Cell {
+    std::atomic<uint32_t> seq;
+    ui_msg_t msg;
+};
+
+static Cell s_cells[UI_MSG_QUEUE_CAPACITY];
+static std::atomic<uint32_t> s_enqueue_pos{0};
+static std::atomic<uint32_t> s_dequeue_pos{0};
+
+// Coalesced connection slot: state, last scan edge, whether a scan STARTED
+// was folded in (its scan-list clear must still run), the post sequence
+// number and a valid bit.
+static constexpr uint32_t kConnStarted = 1u << 10;
+static constexpr uint32_t kConnSeqShift = 12;
+static constexpr uint32_t kConnValid = 0x80000000u;
+static std::atomic<uint32_t> s_conn_latest{0};
+static std::atomic<uint16_t> s_conn_seq{0};
+static uint16_t s_conn_applied;    // newest sequence dispatched (LVGL thread)
+static bool s_conn_any;
+static std::atomic<uint32_t> s_telemetry_bits{0};
+
+static std::atomic<uint32_t> s_posted{0};
+static std::atomic<uint32_t> s_dropped{0};
+static std::atomic<uint32_t> s_coalesced{0};
+static std::atomic<uint32_t> s_high_water{0};
+
+static ui_msg_handler_t s_handlers[UI_MSG_TYPE_COUNT];
+static lv_timer_t *s_drain_timer = nullptr;
+
+// Seed cell sequence numbers during static init so producers may post
+// before ui_msg_queue_init() runs.
+static struct CellInit {
+    CellInit()
+    {
+        for (uint32_t i = 0; i < UI_MSG_QUEUE_CAPACITY; i++) {
+            s_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+} s_cell_init;
+
+static bool try_enqueue(const ui_msg_t *msg, uint32_t limit)
+{
+    uint32_t pos = s_enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32_t used = pos - s_dequeue_pos.load(std::memory_order_acquire);
+        if (used >= limit) return false;
+
+        Cell &cell = s_cells[pos & (UI_MSG_QUEUE_CAPACITY - 1)];
+        uint32_t seq = cell.seq.load(std::memory_order_acquire);
+        int32_t dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            if (s_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.msg = *msg;
+                cell.seq.store(pos + 1, std::memory_order_release);
+
+                used++;
+                uint32_t hw = s_high_water.load(std::memory_order_relaxed);
+                while (used > hw && !s_high_water.compare_exchange_weak(hw, used, std::memory_order_relaxed)) {
+                }
+                return true;
+            }
+        } else if (dif < 0) {
+            return false;
+        } else {
+            pos = s_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+static bool try_dequeue(ui_msg_t *out)
+{
+    uint32_t pos = s_dequeue_pos.load(std::memory_order_relaxed);
+    Cell &cell = s_cells[pos & (UI_MSG_QUEUE_CAPACITY - 1)];
+    uint32_t seq = cell.seq.load(std::memory_order_acquire);
+    if (seq != pos + 1) return false;
+    *out = cell.msg;
+    cell.seq.store(pos + UI_MSG_QUEUE_CAPACITY, std::memory_order_release);
+    s_dequeue_pos.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+static void dispatch(const ui_msg_t *msg)
+{
+    if (msg->type >= UI_MSG_TYPE_COUNT) return;
+    ui_msg_handler_t cb = s_handlers[msg->type];
+    if (cb) cb(msg);
+}
+
+static bool conn_newer(uint16_t a, uint16_t b)
+{
+    return (int16_t)(uint16_t)(a - b) > 0;
+}
+
+static void dispatch_conn(const ui_msg_t *msg)
+{
+    uint16_t seq = msg->u.conn.seq;
+    // A state older than one already shown only matters for its scan edge.
+    if (s_conn_any && !conn_newer(seq, s_conn_applied)) {
+        if (msg->u.conn.scan_event == UI_SCAN_EVT_NONE) return;
+    } else {
+        s_conn_applied = seq;
+        s_conn_any = true;
+    }
+    dispatch(msg);
+}
+
+// Apply the coalesced slot, but only if it is older than `before` (a ring
+// entry about to be dispatched) or unconditionally when `before` is null.
+static void flush_conn_slot(const ui_msg_t *before)
+{
+    uint32_t conn = s_conn_latest.load(std::memory_order_acquire);
+    for (;;) {
+        if (!(conn & kConnValid)) return;
+        uint16_t seq = (uint16_t)(conn >> kConnSeqShift);
+        if (before && !conn_newer(before->u.conn.seq, seq)) return;
+        if (s_conn_latest.compare_exchange_weak(conn, 0, std::memory_order_acquire)) break;
+    }
+
+    ui_msg_t msg;
+    msg.type = UI_MSG_CONN_STATE;
+    msg.u.conn.seq = (uint16_t)(conn >> kConnSeqShift);
+    // Lost a race with a newer ring entry that is already shown.
+    if (s_conn_any && !conn_newer(msg.u.conn.seq, s_conn_applied)) return;
+
+    msg.u.conn.state = (uint8_t)(conn & 0xFF);
+    uint8_t edge = (uint8_t)((conn >> 8) & 0x3);
+    if ((conn & kConnStarted) && edge != UI_SCAN_EVT_STARTED) {
+        // STARTED was overwritten by a later edge: replay it first so the
+        // scan list is still cleared.
+        msg.u.conn.scan_event = UI_SCAN_EVT_STARTED;
+        dispatch(&msg);
+    }
+    msg.u.conn.scan_event = edge;
+    dispatch_conn(&msg);
+}
+
+static void drain_timer_cb(lv_timer_t *t)
+{
+    (void)t;
+    ui_msg_queue_drain(UI_MSG_DRAIN_PER_FRAME);
+}
+
+void ui_msg_queue_init(void)
+{
+    if (s_drain_timer) return;
+    // Timers are inserted at the head of LVGL's list, so this runs right
+    // before the display refresh timer on every handler pass.
+    s_drain_timer = lv_timer_create(drain_timer_cb, LV_DEF_REFR_PERIOD, nullptr);
+}
+
+void ui_msg_queue_set_handler(ui_msg_type_t type, ui_msg_handler_t cb)
+{
+    if (type >= UI_MSG_TYPE_COUNT) return;
+    s_handlers[type] = cb;
+}
+
+bool ui_msg_post(const ui_msg_t *msg)
+{
+    if (!msg || msg->type >= UI_MSG_TYPE_COUNT) return false;
+    s_posted.fetch_add(1, std::memory_order_relaxed);
+
+    switch (msg->type) {
+        case UI_MSG_TELEMETRY:
+            s_telemetry_bits.fetch_or(msg->u.telemetry.sources, std::memory_order_release);
+            return true;
+
+        case UI_MSG_SCAN_RESULT:
+            // Leave headroom so state changes still get through when scans flood.
+            if (try_enqueue(msg, UI_MSG_QUEUE_CAPACITY - UI_MSG_QUEUE_RESERVE)) return true;
+            break;
+
+        case UI_MSG_CONN_STATE: {
+            ui_msg_t stamped = *msg;
+            stamped.u.conn.seq = s_conn_seq.fetch_add(1, std::memory_order_relaxed);
+            if (try_enqueue(&stamped, UI_MSG_QUEUE_CAPACITY)) return true;
+
+            uint32_t packed = kConnValid | stamped.u.conn.state | ((uint32_t)(stamped.u.conn.scan_event & 0x3) << 8) |
+                              ((uint32_t)stamped.u.conn.seq << kConnSeqShift);
+            if (stamped.u.conn.scan_event == UI_SCAN_EVT_STARTED) packed |= kConnStarted;
+            uint32_t prev = s_conn_latest.load(std::memory_order_relaxed);
+            uint32_t next;
+            do {
+                next = packed;
+                if ((prev & kConnValid) && (prev & kConnStarted)) next |= kConnStarted;
+            } while (!s_conn_latest.compare_exchange_weak(prev, next, std::memory_order_release,
+                                                          std::memory_order_relaxed));
+            s_coalesced.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        case UI_MSG_ALERT:
+            if (try_enqueue(msg, UI_MSG_QUEUE_CAPACITY)) return true;
+            break;
+
+        default:
+            break;
+    }
+    s_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool ui_msg_post_scan_result(const char *name, const char *mac, int rssi)
+{
+    ui_msg_t msg;
+    msg.type = UI_MSG_SCAN_RESULT;
+    strncpy(msg.u.scan.name, name ? name : "", sizeof(msg.u.scan.name) - 1);
+    msg.u.scan.name[sizeof(msg.u.scan.name) - 1] = '\0';
+    strncpy(msg.u.scan.mac, mac ? mac : "", sizeof(msg.u.scan.mac) - 1);
+    msg.u.scan.mac[sizeof(msg.u.scan.mac) - 1] = '\0';
+    msg.u.scan.rssi = (int16_t)rssi;
+    return ui_msg_post(&msg);
+}
+
+bool ui_msg_post_conn_state(uint8_t state, uint8_t scan_event)
+{
+    ui_msg_t msg;
+    msg.type = UI_MSG_CONN_STATE;
+    msg.u.conn.state = state;
+    msg.u.conn.scan_event = scan_event;
+    return ui_msg_post(&msg);
+}
+
+void ui_msg_post_telemetry(uint32_t source_bits)
+{
+    ui_msg_t msg;
+    msg.type = UI_MSG_TELEMETRY;
+    msg.u.telemetry.sources = source_bits;
+    (void)ui_msg_post(&msg);
+}
+
+bool ui_msg_post_alert(uint16_t code, uint8_t severity, const char *text)
+{
+    ui_msg_t msg;
+    msg.type = UI_MSG_ALERT;
+    msg.u.alert.code = code;
+    msg.u.alert.severity = severity;
+    strncpy(msg.u.alert.text, text ? text : "", sizeof(msg.u.alert.text) - 1);
+    msg.u.alert.text[sizeof(msg.u.alert.text) - 1] = '\0';
+    return ui_msg_post(&msg);
+}
+
+void ui_msg_queue_drain(uint32_t max_msgs)
+{
+    ui_msg_t msg;
+    uint32_t n = 0;
+    while (n < max_msgs && try_dequeue(&msg)) {
+        if (msg.type == UI_MSG_CONN_STATE) {
+            // The slot was written while the ring was full; it goes before
+            // any entry posted after it.
+            flush_conn_slot(&msg);
+            dispatch_conn(&msg);
+        } else {
+            dispatch(&msg);
+        }
+        n++;
+    }
+
+    // Otherwise it is newer than the whole backlog and waits until that is drained.
+    if (n < max_msgs) flush_conn_slot(nullptr);
+
+    uint32_t bits = s_telemetry_bits.exchange(0, std::memory_order_acquire);
+    if (bits) {
+        msg.type = UI_MSG_TELEMETRY;
+        msg.u.telemetry.sources = bits;
+        dispatch(&msg);
+    }
+}
+
+void ui_msg_queue_get_stats(ui_msg_queue_stats_t *out)
+{
+    if (!out) return;
+    out->posted = s_posted.load(std::memory_order_relaxed);
+    out->dropped = s_dropped.load(std::memory_order_relaxed);
+    out->coalesced = s_coalesced.load(std::memory_order_relaxed);
+    out->high_water = s_high_water.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed-size typed messages from BLE/worker tasks into the LVGL thread.
+// Producers may run on any task; the queue is drained once per frame by
+// an LVGL timer created in ui_msg_queue_init().
+
+#define UI_MSG_QUEUE_CAPACITY 32      // power of two
+#define UI_MSG_QUEUE_RESERVE  8       // slots only ordered control messages may use
+#define UI_MSG_DRAIN_PER_FRAME 16
+
+typedef enum {
+    UI_MSG_SCAN_RESULT = 0,   // ordered, dropped above the reserve watermark
+    UI_MSG_CONN_STATE,        // ordered, coalesced to latest value when full
+    UI_MSG_TELEMETRY,         // coalesced: source bits OR'ed until drained
+    UI_MSG_ALERT,             // ordered, may use the reserve
+    UI_MSG_TYPE_COUNT,
+} ui_msg_type_t;
+
+typedef enum {
+    UI_SCAN_EVT_NONE = 0,
+    UI_SCAN_EVT_STARTED,
+    UI_SCAN_EVT_FINISHED,
+} ui_scan_evt_t;
+
+typedef struct {
+    char name[32];
+    char mac[24];
+    int16_t rssi;
+} ui_msg_scan_result_t;
+
+typedef struct {
+    uint8_t state;        // ui_battery_conn_state_t
+    uint8_t scan_event;   // ui_scan_evt_t
+    uint16_t seq;         // set by ui_msg_post(); orders ring entries against the coalesced slot
+} ui_msg_conn_state_t;
+
+// Telemetry producers (bits for ui_msg_post_telemetry).
+#define UI_TELEM_SRC_BMS   (1u << 0)
+#define UI_TELEM_SRC_VESC  (1u << 1)
+#define UI_TELEM_SRC_RECORDER (1u << 2)   // ts_recorder tick, also while the sources are silent
+
+typedef struct {
+    uint32_t sources;     // bitmask of producers with a new snapshot
+} ui_msg_telemetry_t;
+
+typedef struct {
+    uint16_t code;
+    uint8_t severity;
+    char text[40];
+} ui_msg_alert_t;
+
+typedef struct {
+    uint8_t type;         // ui_msg_type_t
+    union {
+        ui_msg_scan_result_t scan;
+        ui_msg_conn_state_t conn;
+        ui_msg_telemetry_t telemetry;
+        ui_msg_alert_t alert;
+    } u;
+} ui_msg_t;
+
+typedef void (*ui_msg_handler_t)(const ui_msg_t *msg);
+
+typedef struct {
+    uint32_t posted;
+    uint32_t dropped;
+    uint32_t coalesced;
+    uint32_t high_water;
+} ui_msg_queue_stats_t;
+
+// Create the per-frame drain timer (call once from the LVGL thread after lv_init).
+void ui_msg_queue_init(void);
+
+// Handlers run on the LVGL thread.
+void ui_msg_queue_set_handler(ui_msg_type_t type, ui_msg_handler_t cb);
+
+// Safe from any task. Returns false if the message was dropped.
+bool ui_msg_post(const ui_msg_t *msg);
+bool ui_msg_post_scan_result(const char *name, const char *mac, int rssi);
+bool ui_msg_post_conn_state(uint8_t state, uint8_t scan_event);
+void ui_msg_post_telemetry(uint32_t source_bits);
+bool ui_msg_post_alert(uint16_t code, uint8_t severity, const char *text);
+
+// Drain up to max_msgs ordered messages plus all coalesced slots (LVGL thread only).
+void ui_msg_queue_drain(uint32_t max_msgs);
+
+void ui_msg_queue_get_stats(ui_msg_queue_stats_t *out);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
@@ -0,0 +1,117 @@
+#include "ui_numeric.h"
+
+#include <string.h>
+
+struct Numeric {
+    const lv_font_t *font;
+    uint8_t cells;
+    int32_t cell_w;
+    char text[UI_NUMERIC_MAX_CELLS];   // one character per cell, ' ' = blank
+};
+
+static Numeric *numeric_of(lv_obj_t *obj)
+{
+    return obj ? (Numeric *)lv_obj_get_user_data(obj) : nullptr;
+}
+
+static void cell_area(lv_obj_t *obj, const Numeric *n, int i, lv_area_t *out)
+{
+    lv_obj_get_coords(obj, out);
+    out->x1 += i * n->cell_w;
+    out->x2 = out->x1 + n->cell_w - 1;
+}
+
+static void draw_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = (lv_obj_t *)lv_event_get_current_target(e);
+    Numeric *n = numeric_of(obj);
+    lv_layer_t *layer = lv_event_get_layer(e);
+    if (!n || !layer) return;
+
+    lv_draw_letter_dsc_t dsc;
+    lv_draw_letter_dsc_init(&dsc);
+    dsc.font = n->font;
+    dsc.color = lv_obj_get_style_text_color(obj, LV_PART_MAIN);
+    dsc.opa = lv_obj_get_style_opa_recursive(obj, LV_PART_MAIN);
+    dsc.opa = LV_OPA_MIX2(dsc.opa, lv_obj_get_style_text_opa(obj, LV_PART_MAIN));
+    if (dsc.opa <= LV_OPA_MIN) return;
+
+    // Rows are shared by all cells, so only the columns need a clip test.
+    const lv_area_t *clip = &layer->_clip_area;
+    for (int i = 0; i < n->cells; i++) {
+        if (n->text[i] == ' ') continue;
+        lv_area_t cell;
+        cell_area(obj, n, i, &cell);
+        if (cell.x2 < clip->x1 || cell.x1 > clip->x2) continue;
+        dsc.unicode = (uint8_t)n->text[i];
+        const int32_t adv = lv_font_get_glyph_width(n->font, dsc.unicode, 0);
+        const lv_point_t pos = {cell.x1 + (n->cell_w - adv) / 2, cell.y1};
+        lv_draw_letter(layer, &dsc, &pos);
+    }
+}
+
+static void delete_cb(lv_event_t *e)
+{
+    lv_free(lv_event_get_user_data(e));
+}
+
+lv_obj_t *ui_numeric_create(lv_obj_t *parent, const lv_font_t *font, uint8_t cells)
+{
+    if (!font || cells == 0) return NULL;
+    if (cells > UI_NUMERIC_MAX_CELLS) cells = UI_NUMERIC_MAX_CELLS;
+
+    Numeric *n = (Numeric *)lv_malloc_zeroed(sizeof(Numeric));
+    if (!n) return NULL;
+    n->font = font;
+    n->cells = cells;
+    memset(n->text, ' ', sizeof(n->text));
+    // Widest of the characters a value can show.
+    static const char kChars[] = "0123456789-";
+    for (const char *c = kChars; *c; c++) {
+        const int32_t w = lv_font_get_glyph_width(font, (uint8_t)*c, 0);
+        if (w > n->cell_w) n->cell_w = w;
+    }
+
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_remove_flag(obj, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
+    lv_obj_set_size(obj, n->cell_w * cells, lv_font_get_line_height(font));
+    lv_obj_set_user_data(obj, n);
+    lv_obj_add_event_cb(obj, draw_cb, LV_EVENT_DRAW_MAIN, NULL);
+    lv_obj_add_event_cb(obj, delete_cb, LV_EVENT_DELETE, n);
+    return obj;
+}
+
+lv_obj_t *ui_numeric_replace_label(lv_obj_t *label, uint8_t cells)
+{
+    if (!label) return NULL;
+    const lv_font_t *font = lv_obj_get_style_text_font(label, LV_PART_MAIN);
+    lv_obj_t *obj = ui_numeric_create(lv_obj_get_parent(label), font, cells);
+    if (!obj) return NULL;
+
+    lv_obj_set_align(obj, (lv_align_t)lv_obj_get_style_align(label, LV_PART_MAIN));
+    lv_obj_set_pos(obj, lv_obj_get_style_x(label, LV_PART_MAIN), lv_obj_get_style_y(label, LV_PART_MAIN));
+    lv_obj_set_style_text_color(obj, lv_obj_get_style_text_color(label, LV_PART_MAIN), LV_PART_MAIN);
+    lv_obj_set_style_text_opa(obj, lv_obj_get_style_text_opa(label, LV_PART_MAIN), LV_PART_MAIN);
+    ui_numeric_set_text(obj, lv_label_get_text(label));
+    lv_obj_add_flag(label, LV_OBJ_FLAG_HIDDEN);
+    return obj;
+}
+
+void ui_numeric_set_text(lv_obj_t *num, const char *text)
+{
+    Numeric *n = numeric_of(num);
+    if (!n || !text) return;
+
+    const size_t len = strlen(text);
+    const char *src = (len > n->cells) ? text + (len - n->cells) : text;
+    const int pad = (len < n->cells) ? (int)(n->cells - len) : 0;
+    for (int i = 0; i < n->cells; i++) {
+        const char c = (i < pad) ? ' ' : src[i - pad];
+        if (c == n->text[i]) continue;
+        n->text[i] = c;
+        lv_area_t cell;
+        cell_area(num, n, i, &cell);
+        lv_obj_invalidate_area(num, &cell);
+    }
+}
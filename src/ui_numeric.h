@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed-cell text display for values that change often (speed, power,
+// odometer). Every character gets a cell as wide as the font's widest digit,
+// text is right-aligned in the cells, and each glyph is drawn centered in
+// its cell. Setting new text invalidates only the cells whose character
+// changed: no text measurement, kerning or re-layout.
+
+#define UI_NUMERIC_MAX_CELLS 12
+
+// `cells` characters (up to UI_NUMERIC_MAX_CELLS) in `font`, colored by the
+// object's text color and opacity.
+lv_obj_t *ui_numeric_create(lv_obj_t *parent, const lv_font_t *font, uint8_t cells);
+
+// Same, placed where `label` is (parent, alignment, offset) with its font and
+// text style. The label is hidden and keeps existing.
+lv_obj_t *ui_numeric_replace_label(lv_obj_t *label, uint8_t cells);
+
+// Longer text keeps its last `cells` characters; shorter text is padded
+// with blanks on the left.
+void ui_numeric_set_text(lv_obj_t *num, const char *text);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
@@ -0,0 +1,179 @@
+#include "ui_screens.h"
+
+#include "ui.h"
+#include "ui_dash_bridge.h"
+#include "ui_image_variant.h"
+#include "ui_transition.h"
+
+#include <Arduino.h>
+
+// The SquareLine functions, linked with -Wl,--wrap (platformio.ini): every
+// call to them, the generated ones in ui.c and the screen events included,
+// lands in the __wrap_ functions at the end of this file.
+extern "C" {
+void __real_ui_Mainui_screen_init(void);
+void __real_ui_Mainui_screen_destroy(void);
+void __real_ui_Settings_screen_init(void);
+}
+
+struct ScreenDef {
+    lv_obj_t **obj;
+    void (*init)(void);            // generated init plus our hooks
+    void (*destroy)(void);
+    bool boot;                     // the one ui_init() builds and loads
+    bool heavy;                    // may be evicted while inactive
+    void (*save)(void);            // widget-only state, before destroy
+    void (*restore)(void);         // and after the next init
+};
+
+static struct {
+    bool valid;
+    uint32_t tab;
+    int32_t eco_speed;
+    int32_t eco_power;
+} s_settings_state;
+
+static void settings_save(void)
+{
+    if (ui_TabView1) s_settings_state.tab = lv_tabview_get_tab_active(ui_TabView1);
+    if (ui_EcoSpeed) s_settings_state.eco_speed = lv_spinbox_get_value(ui_EcoSpeed);
+    if (ui_EcoPower) s_settings_state.eco_power = lv_spinbox_get_value(ui_EcoPower);
+    s_settings_state.valid = true;
+}
+
+static void settings_restore(void)
+{
+    if (!s_settings_state.valid) return;
+    if (ui_TabView1) lv_tabview_set_active(ui_TabView1, s_settings_state.tab, LV_ANIM_OFF);
+    if (ui_EcoSpeed) lv_spinbox_set_value(ui_EcoSpeed, s_settings_state.eco_speed);
+    if (ui_EcoPower) lv_spinbox_set_value(ui_EcoPower, s_settings_state.eco_power);
+}
+
+static void mainui_init(void)
+{
+    __real_ui_Mainui_screen_init();
+    ui_dash_bridge_init();
+}
+
+static void mainui_destroy(void)
+{
+    ui_dash_bridge_deinit();
+    __real_ui_Mainui_screen_destroy();
+}
+
+static void settings_init(void)
+{
+    __real_ui_Settings_screen_init();
+    ui_image_variant_attach_tree(ui_Settings);
+    ui_transition_attach_tabview(ui_TabView1, UI_TRANSITION_TAB_MS);
+}
+
+static const ScreenDef kScreens[] = {
+    {&ui_Mainui, mainui_init, mainui_destroy, false, false, nullptr, nullptr},
+    {&ui_Settings, settings_init, ui_Settings_screen_destroy, true, true, settings_save, settings_restore},
+};
+
+static ui_screens_stats_t s_stats;
+static lv_timer_t *s_timer;
+static bool s_started;             // ui_screens_init() ran, ui_init() is done
+
+static const ScreenDef *find(lv_obj_t **obj)
+{
+    for (const ScreenDef &d : kScreens) {
+        if (d.obj == obj) return &d;
+    }
+    return nullptr;
+}
+
+static bool heap_low(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    s_stats.heap_free = mon.free_size;
+    return mon.free_size < UI_SCREENS_MIN_FREE_BYTES;
+}
+
+// Not shown, and not on either side of a screen load animation.
+static bool is_inactive(lv_obj_t *scr)
+{
+    lv_display_t *disp = lv_display_get_default();
+    return scr != lv_screen_active() && scr != lv_display_get_screen_prev(disp) &&
+           scr != lv_display_get_screen_loading(disp);
+}
+
+uint32_t ui_screens_evict(bool force)
+{
+    // A running transition still has to load its target.
+    if (ui_transition_is_running()) return 0;
+    if (!heap_low() && !force) return 0;
+    uint32_t n = 0;
+    for (const ScreenDef &d : kScreens) {
+        if (!d.heavy || !*d.obj || !is_inactive(*d.obj)) continue;
+        if (d.save) d.save();
+        d.destroy();
+        s_stats.evictions++;
+        n++;
+    }
+    if (n) heap_low();
+    return n;
+}
+
+void ui_screens_ensure(lv_obj_t **screen, void (*init)(void))
+{
+    if (*screen) return;
+    const ScreenDef *d = find(screen);
+    if (d) init = d->init;
+    if (!init) return;
+    ui_screens_evict(false);
+
+    const uint32_t t0 = micros();
+    init();
+    if (d && d->restore) d->restore();
+    s_stats.last_build_us = micros() - t0;
+    s_stats.builds++;
+}
+
+static void check_timer_cb(lv_timer_t *)
+{
+    ui_screens_evict(false);
+}
+
+void ui_screens_init(void)
+{
+    s_started = true;
+    if (!s_timer) s_timer = lv_timer_create(check_timer_cb, UI_SCREENS_CHECK_MS, nullptr);
+}
+
+void ui_screens_get_stats(ui_screens_stats_t *out)
+{
+    *out = s_stats;
+}
+
+// ui_init() builds every screen; until it is done only the boot one is.
+static void generated_init(lv_obj_t **obj)
+{
+    const ScreenDef *d = find(obj);
+    if (s_started || d->boot) ui_screens_ensure(obj, nullptr);
+}
+
+extern "C" void __wrap_ui_Mainui_screen_init(void)
+{
+    generated_init(&ui_Mainui);
+}
+
+extern "C" void __wrap_ui_Settings_screen_init(void)
+{
+    generated_init(&ui_Settings);
+}
+
+extern "C" void __wrap_ui_Mainui_screen_destroy(void)
+{
+    mainui_destroy();
+}
+
+extern "C" void __wrap__ui_screen_change(lv_obj_t **target, lv_screen_load_anim_t fademode, int spd, int delay,
+                                         void (*target_init)(void))
+{
+    ui_screens_ensure(target, target_init);
+    if (*target) ui_transition_screen(*target, fademode, spd, delay);
+}
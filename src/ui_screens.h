@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Screen lifecycle. Only the first screen is built at boot; the others are
+// built by _ui_screen_change() on first navigation. The SquareLine sources
+// stay as exported: the screen init/destroy functions and _ui_screen_change()
+// are wrapped at link time (-Wl,--wrap in platformio.ini), which is also
+// where the per-screen hooks (dash bridge, image variants, tab transitions)
+// are attached. Heavy screens (Settings)
+// are torn down again through their SquareLine destroy function while
+// inactive when the LVGL heap runs low, and rebuilt on the next visit:
+// bound widgets restore themselves from the telemetry subjects, and what
+// only the widgets hold (active tab, spinbox values) is saved and put back.
+
+// Evict inactive heavy screens when the LVGL heap has less free than this.
+#ifndef UI_SCREENS_MIN_FREE_BYTES
+#define UI_SCREENS_MIN_FREE_BYTES (12 * 1024)
+#endif
+#define UI_SCREENS_CHECK_MS 1000
+
+typedef struct {
+    uint16_t builds;
+    uint16_t evictions;
+    uint32_t last_build_us;
+    uint32_t heap_free;        // LVGL heap free at the last check
+} ui_screens_stats_t;
+
+// Call right after ui_init(), which builds and loads only the boot screen;
+// the others are built on demand from here on.
+void ui_screens_init(void);
+
+// Build `*screen` with `init` if it is not built yet. Evicts first when the
+// heap is already low.
+void ui_screens_ensure(lv_obj_t **screen, void (*init)(void));
+
+// Tear down the inactive heavy screens; without `force` only under memory
+// pressure. Returns the number evicted.
+uint32_t ui_screens_evict(bool force);
+
+void ui_screens_get_stats(ui_screens_stats_t *out);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
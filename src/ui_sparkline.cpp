@@ -0,0 +1,195 @@
+#include "ui_sparkline.h"
+
+#include "esp_heap_caps.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct Spark {
+    lv_draw_buf_t buf;
+    uint16_t *px;
+    uint32_t stride_px;
+    int32_t w;
+    uint8_t strip_h;
+    uint8_t max_strips;
+    uint8_t strips;
+    int16_t lo;
+    int16_t hi;
+    int16_t warn;
+    int16_t *hist;                // [strip][w] ring
+    uint16_t head;                // next column to write
+    uint16_t count;               // samples in the ring, up to w
+};
+
+static uint16_t s_bg[2];
+static uint16_t s_mid;
+static uint16_t s_ok;
+static uint16_t s_warn;
+static uint16_t s_clip;
+
+static void *psram_alloc(size_t n)
+{
+    void *p = heap_caps_malloc(n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return p ? p : malloc(n);
+}
+
+static int y_of(const Spark *s, int16_t v)
+{
+    const int span = s->hi - s->lo;
+    int y = (span > 0) ? ((s->hi - v) * (s->strip_h - 1) + span / 2) / span : s->strip_h / 2;
+    if (y < 0) y = 0;
+    if (y >= s->strip_h) y = s->strip_h - 1;
+    return y;
+}
+
+static int16_t hist_at(const Spark *s, int strip, int age)
+{
+    if (age >= s->count) return UI_SPARK_GAP;
+    int idx = (int)s->head - 1 - age;
+    if (idx < 0) idx += s->w;
+    return s->hist[strip * s->w + idx];
+}
+
+// Column x shows the sample `age` steps old; the line is continued from the
+// one before it with a vertical span, which is exact for a 1 px x step.
+static void draw_column(Spark *s, int32_t x, int age)
+{
+    for (int st = 0; st < s->strips; st++) {
+        uint16_t *col = s->px + (uint32_t)st * s->strip_h * s->stride_px + x;
+        const uint16_t bg = s_bg[st & 1];
+        for (int y = 0; y < s->strip_h; y++) col[y * s->stride_px] = bg;
+        if (s->lo < 0 && s->hi > 0) col[y_of(s, 0) * s->stride_px] = s_mid;
+
+        const int16_t v = hist_at(s, st, age);
+        if (v == UI_SPARK_GAP) continue;
+        const int16_t prev = hist_at(s, st, age + 1);
+        int y0 = y_of(s, v);
+        int y1 = (prev == UI_SPARK_GAP) ? y0 : y_of(s, prev);
+        if (y1 < y0) {
+            int t = y0;
+            y0 = y1;
+            y1 = t;
+        }
+        const int mag = (v < 0) ? -v : v;
+        uint16_t c = s_ok;
+        if (v < s->lo || v > s->hi) c = s_clip;
+        else if (s->warn > 0 && mag >= s->warn) c = s_warn;
+        for (int y = y0; y <= y1; y++) col[y * s->stride_px] = c;
+    }
+}
+
+static void redraw_all(Spark *s)
+{
+    for (int32_t x = 0; x < s->w; x++) draw_column(s, x, (int)(s->w - 1 - x));
+}
+
+static void delete_cb(lv_event_t *e)
+{
+    Spark *s = (Spark *)lv_event_get_user_data(e);
+    heap_caps_free(s->px);
+    heap_caps_free(s->hist);
+    lv_free(s);
+}
+
+static Spark *spark_of(lv_obj_t *obj)
+{
+    return obj ? (Spark *)lv_obj_get_user_data(obj) : nullptr;
+}
+
+static void apply_height(lv_obj_t *obj, Spark *s)
+{
+    const uint32_t h = (uint32_t)s->strips * s->strip_h;
+    lv_draw_buf_init(&s->buf, (uint32_t)s->w, h, LV_COLOR_FORMAT_RGB565, s->stride_px * 2, s->px,
+                     s->stride_px * 2 * (uint32_t)s->max_strips * s->strip_h);
+    lv_canvas_set_draw_buf(obj, &s->buf);
+}
+
+lv_obj_t *ui_sparkline_create(lv_obj_t *parent, int32_t width, uint8_t strip_h, uint8_t max_strips)
+{
+    if (width < 2 || strip_h < 2 || max_strips == 0) return NULL;
+    if (!s_ok) {
+        s_bg[0] = lv_color_to_u16(lv_color_hex(0x101010));
+        s_bg[1] = lv_color_to_u16(lv_color_hex(0x1A1A1A));
+        s_mid = lv_color_to_u16(lv_color_hex(0x3A3A3A));
+        s_ok = lv_color_to_u16(lv_color_hex(0x3AD16A));
+        s_warn = lv_color_to_u16(lv_color_hex(0xD1B93A));
+        s_clip = lv_color_to_u16(lv_color_hex(0xD13A3A));
+    }
+
+    Spark *s = (Spark *)lv_malloc_zeroed(sizeof(Spark));
+    if (!s) return NULL;
+    s->w = width;
+    s->strip_h = strip_h;
+    s->max_strips = max_strips;
+    s->strips = max_strips;
+    s->lo = -100;
+    s->hi = 100;
+    s->stride_px = lv_draw_buf_width_to_stride((uint32_t)width, LV_COLOR_FORMAT_RGB565) / 2;
+    s->px = (uint16_t *)psram_alloc(s->stride_px * 2 * (size_t)max_strips * strip_h);
+    s->hist = (int16_t *)psram_alloc(sizeof(int16_t) * (size_t)max_strips * width);
+    if (!s->px || !s->hist) {
+        heap_caps_free(s->px);
+        heap_caps_free(s->hist);
+        lv_free(s);
+        return NULL;
+    }
+
+    lv_obj_t *obj = lv_canvas_create(parent);
+    lv_obj_set_user_data(obj, s);
+    lv_obj_add_event_cb(obj, delete_cb, LV_EVENT_DELETE, s);
+    apply_height(obj, s);
+    redraw_all(s);
+    return obj;
+}
+
+void ui_sparkline_set_strips(lv_obj_t *spark, uint8_t count)
+{
+    Spark *s = spark_of(spark);
+    if (!s) return;
+    if (count > s->max_strips) count = s->max_strips;
+    if (count == 0) count = 1;
+    if (count == s->strips) return;
+    s->strips = count;
+    apply_height(spark, s);
+    redraw_all(s);
+    lv_obj_invalidate(spark);
+}
+
+void ui_sparkline_set_range(lv_obj_t *spark, int16_t lo, int16_t hi, int16_t warn_abs)
+{
+    Spark *s = spark_of(spark);
+    if (!s || hi <= lo) return;
+    s->lo = lo;
+    s->hi = hi;
+    s->warn = warn_abs;
+    redraw_all(s);
+    lv_obj_invalidate(spark);
+}
+
+void ui_sparkline_push(lv_obj_t *spark, const int16_t *values, uint8_t count)
+{
+    Spark *s = spark_of(spark);
+    if (!s) return;
+    for (int st = 0; st < s->max_strips; st++) {
+        s->hist[st * s->w + s->head] = (values && st < count) ? values[st] : UI_SPARK_GAP;
+    }
+    s->head = (uint16_t)((s->head + 1) % s->w);
+    if (s->count < s->w) s->count++;
+
+    const uint32_t rows = (uint32_t)s->strips * s->strip_h;
+    for (uint32_t y = 0; y < rows; y++) {
+        uint16_t *row = s->px + y * s->stride_px;
+        memmove(row, row + 1, (size_t)(s->w - 1) * sizeof(uint16_t));
+    }
+    draw_column(s, s->w - 1, 0);
+    lv_obj_invalidate(spark);
+}
+
+void ui_sparkline_clear(lv_obj_t *spark)
+{
+    Spark *s = spark_of(spark);
+    if (!s) return;
+    s->head = 0;
+    s->count = 0;
+    redraw_all(s);
+    lv_obj_invalidate(spark);
+}
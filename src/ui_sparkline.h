@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Stack of small sparklines (one strip per series) drawn on one canvas.
+// Each push shifts the image one pixel left and draws only the newest
+// column, so an update costs the same however much history is on screen.
+// Every strip keeps a history ring as wide as the canvas, used for the full
+// redraw after a range or strip-count change. Pixels and history live in
+// PSRAM. The canvas is the only object invalidated on update.
+
+#define UI_SPARK_GAP INT16_MIN    // no sample: leaves a gap in the line
+
+// `width` px of history per strip, `strip_h` px per strip. Returns NULL when
+// the buffers cannot be allocated.
+lv_obj_t *ui_sparkline_create(lv_obj_t *parent, int32_t width, uint8_t strip_h, uint8_t max_strips);
+
+// Visible strips (at least one); the canvas height follows. History is kept.
+void ui_sparkline_set_strips(lv_obj_t *spark, uint8_t count);
+
+// Value range of every strip; |value| >= warn_abs draws in the warning
+// color (0 = never). Redraws the whole canvas.
+void ui_sparkline_set_range(lv_obj_t *spark, int16_t lo, int16_t hi, int16_t warn_abs);
+
+// One value per strip (missing strips get a gap).
+void ui_sparkline_push(lv_obj_t *spark, const int16_t *values, uint8_t count);
+
+void ui_sparkline_clear(lv_obj_t *spark);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
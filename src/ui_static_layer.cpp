@@ -0,0 +1,202 @@
+#include "ui_static_layer.h"
+
+#include "esp_heap_caps.h"
+#include <stdlib.h>
+
+#define UI_STATIC_LAYER_MAX_ENTRIES 16
+
+static const lv_style_prop_t kBoxProps[] = {
+    LV_STYLE_BG_OPA, LV_STYLE_BG_IMAGE_OPA, LV_STYLE_BORDER_OPA, LV_STYLE_OUTLINE_OPA,
+    LV_STYLE_SHADOW_OPA, LV_STYLE_ARC_OPA, LV_STYLE_IMAGE_OPA, LV_STYLE_LINE_OPA,
+};
+static constexpr int kBoxPropCount = sizeof(kBoxProps) / sizeof(kBoxProps[0]);
+static constexpr int kMaxSaved = kBoxPropCount + 1;   // + text_opa
+
+struct Saved {
+    lv_style_prop_t prop;
+    lv_style_value_t value;
+    bool had;                     // the object had a local value before
+};
+
+struct Entry {
+    lv_obj_t *obj;
+    lv_style_selector_t selector;
+    lv_part_t part;
+    bool dynamic;
+    bool suppressed;
+    uint8_t saved_count;
+    Saved saved[kMaxSaved];
+};
+
+struct ui_static_layer {
+    lv_obj_t *screen;
+    lv_obj_t *image;
+    lv_draw_buf_t buf;
+    void *px;
+    uint32_t px_bytes;
+    Entry entries[UI_STATIC_LAYER_MAX_ENTRIES];
+    int count;
+    bool busy;                    // our own style edits must not trigger a rebuild
+    bool pending;
+};
+
+static void save_and_clear(Entry &e, lv_style_prop_t prop)
+{
+    Saved &s = e.saved[e.saved_count++];
+    s.prop = prop;
+    s.had = lv_obj_get_local_style_prop(e.obj, prop, &s.value, e.selector) == LV_STYLE_RES_FOUND;
+    lv_style_value_t zero;
+    zero.num = LV_OPA_TRANSP;
+    lv_obj_set_local_style_prop(e.obj, prop, zero, e.selector);
+}
+
+// Dynamic parts go through the opa style: the whole part, or the subtree
+// for MAIN. A static part only gives up what it draws itself, since opa on
+// MAIN would also hide the object's other parts and its children; text_opa
+// is inherited, so it is only cleared where there are no children.
+static void suppress(Entry &e)
+{
+    if (e.suppressed) return;
+    e.saved_count = 0;
+    if (e.dynamic) {
+        save_and_clear(e, LV_STYLE_OPA);
+    } else {
+        for (int i = 0; i < kBoxPropCount; i++) save_and_clear(e, kBoxProps[i]);
+        if (lv_obj_get_child_count(e.obj) == 0) save_and_clear(e, LV_STYLE_TEXT_OPA);
+    }
+    e.suppressed = true;
+}
+
+static void restore(Entry &e)
+{
+    if (!e.suppressed) return;
+    for (int i = e.saved_count - 1; i >= 0; i--) {
+        const Saved &s = e.saved[i];
+        if (s.had) lv_obj_set_local_style_prop(e.obj, s.prop, s.value, e.selector);
+        else lv_obj_remove_local_style_prop(e.obj, s.prop, e.selector);
+    }
+    e.suppressed = false;
+}
+
+static bool ensure_buffer(ui_static_layer_t *l, int32_t w, int32_t h)
+{
+    const uint32_t stride = lv_draw_buf_width_to_stride((uint32_t)w, LV_COLOR_FORMAT_RGB565);
+    const uint32_t bytes = stride * (uint32_t)h;
+    if (bytes > l->px_bytes) {
+        heap_caps_free(l->px);
+        l->px = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!l->px) l->px = malloc(bytes);
+        l->px_bytes = l->px ? bytes : 0;
+        if (!l->px) return false;
+    }
+    lv_draw_buf_init(&l->buf, (uint32_t)w, (uint32_t)h, LV_COLOR_FORMAT_RGB565, stride, l->px, l->px_bytes);
+    return true;
+}
+
+static void rebuild_async(void *user_data)
+{
+    ui_static_layer_t *l = (ui_static_layer_t *)user_data;
+    l->pending = false;
+    ui_static_layer_build(l);
+}
+
+static void event_cb(lv_event_t *e)
+{
+    ui_static_layer_t *l = (ui_static_layer_t *)lv_event_get_user_data(e);
+    const lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_DELETE) {
+        if (lv_event_get_current_target(e) != l->screen) return;
+        if (l->pending) lv_async_call_cancel(rebuild_async, l);
+        heap_caps_free(l->px);
+        lv_free(l);
+        return;
+    }
+    if (!l->busy) ui_static_layer_invalidate(l);
+}
+
+ui_static_layer_t *ui_static_layer_create(lv_obj_t *screen)
+{
+    if (!screen) return NULL;
+    ui_static_layer_t *l = (ui_static_layer_t *)lv_malloc_zeroed(sizeof(ui_static_layer_t));
+    if (!l) return NULL;
+    l->screen = screen;
+    lv_display_t *disp = lv_obj_get_display(screen);
+    if (!ensure_buffer(l, lv_display_get_horizontal_resolution(disp), lv_display_get_vertical_resolution(disp))) {
+        lv_free(l);
+        return NULL;
+    }
+
+    l->busy = true;
+    l->image = lv_image_create(screen);
+    lv_obj_move_to_index(l->image, 0);
+    lv_obj_remove_flag(l->image, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
+    lv_obj_add_flag(l->image, (lv_obj_flag_t)(LV_OBJ_FLAG_IGNORE_LAYOUT | LV_OBJ_FLAG_HIDDEN));
+    lv_obj_set_pos(l->image, 0, 0);
+    l->busy = false;
+
+    lv_obj_add_event_cb(screen, event_cb, LV_EVENT_SIZE_CHANGED, l);
+    lv_obj_add_event_cb(screen, event_cb, LV_EVENT_STYLE_CHANGED, l);
+    lv_obj_add_event_cb(screen, event_cb, LV_EVENT_DELETE, l);
+    return l;
+}
+
+static bool add(ui_static_layer_t *l, lv_obj_t *obj, lv_part_t part, bool dynamic)
+{
+    if (!l || !obj || l->count >= UI_STATIC_LAYER_MAX_ENTRIES) return false;
+    Entry &e = l->entries[l->count++];
+    e = {};
+    e.obj = obj;
+    e.selector = part | LV_STATE_DEFAULT;
+    e.part = part;
+    e.dynamic = dynamic;
+    // Theme changes restyle the static objects themselves.
+    if (!dynamic && obj != l->screen) lv_obj_add_event_cb(obj, event_cb, LV_EVENT_STYLE_CHANGED, l);
+    return true;
+}
+
+bool ui_static_layer_add_static(ui_static_layer_t *layer, lv_obj_t *obj, lv_part_t part)
+{
+    return add(layer, obj, part, false);
+}
+
+bool ui_static_layer_add_dynamic(ui_static_layer_t *layer, lv_obj_t *obj, lv_part_t part)
+{
+    return add(layer, obj, part, true);
+}
+
+void ui_static_layer_build(ui_static_layer_t *l)
+{
+    if (!l) return;
+    l->busy = true;
+
+    // Capture with the static parts live and the dynamic ones switched off.
+    for (int i = 0; i < l->count; i++) restore(l->entries[i]);
+    lv_obj_add_flag(l->image, LV_OBJ_FLAG_HIDDEN);
+    for (int i = 0; i < l->count; i++) {
+        if (l->entries[i].dynamic) suppress(l->entries[i]);
+    }
+    lv_obj_update_layout(l->screen);
+    bool ok = ensure_buffer(l, lv_obj_get_width(l->screen), lv_obj_get_height(l->screen)) &&
+              lv_snapshot_take_to_draw_buf(l->screen, LV_COLOR_FORMAT_RGB565, &l->buf) == LV_RESULT_OK;
+    for (int i = 0; i < l->count; i++) {
+        if (l->entries[i].dynamic) restore(l->entries[i]);
+    }
+
+    if (ok) {
+        for (int i = 0; i < l->count; i++) {
+            if (!l->entries[i].dynamic) suppress(l->entries[i]);
+        }
+        lv_obj_set_size(l->image, lv_obj_get_width(l->screen), lv_obj_get_height(l->screen));
+        lv_image_set_src(l->image, &l->buf);
+        lv_obj_remove_flag(l->image, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_invalidate(l->image);
+    }
+    l->busy = false;
+}
+
+void ui_static_layer_invalidate(ui_static_layer_t *l)
+{
+    if (!l || l->pending) return;
+    l->pending = true;
+    lv_async_call(rebuild_async, l);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Static layer cache for a screen. The parts that never change (screen
+// background, gauge tracks, icons, fixed text) are rendered once into an
+// RGB565 image that sits at the bottom of the screen and is drawn as a
+// single opaque blit; they are then suppressed in the live tree. Only the
+// dynamic parts (arc indicators, value labels) are drawn per frame.
+//
+//   ui_static_layer_t *l = ui_static_layer_create(ui_Mainui);
+//   ui_static_layer_add_static(l, ui_Speed, LV_PART_MAIN);        // track only
+//   ui_static_layer_add_dynamic(l, ui_Speedlabel, LV_PART_MAIN);  // whole label
+//   ui_static_layer_build(l);
+//
+// Static entries keep their size, position and hit-testing; a static part
+// only gives up its own background, border, outline, shadow, arc, image,
+// line and (without children) text, so the object's other parts and its
+// children still draw. A dynamic MAIN part covers the whole subtree. The cache is rebuilt when the
+// screen is resized or styles are added to or removed from a static object
+// (a theme change). Other edits to static parts, such as a local color or
+// new text, need ui_static_layer_invalidate().
+
+typedef struct ui_static_layer ui_static_layer_t;
+
+// Returns NULL when the layer buffer cannot be allocated; the screen then
+// simply keeps drawing everything live.
+ui_static_layer_t *ui_static_layer_create(lv_obj_t *screen);
+
+bool ui_static_layer_add_static(ui_static_layer_t *layer, lv_obj_t *obj, lv_part_t part);
+bool ui_static_layer_add_dynamic(ui_static_layer_t *layer, lv_obj_t *obj, lv_part_t part);
+
+// Render the cache now and switch the static parts off.
+void ui_static_layer_build(ui_static_layer_t *layer);
+
+// Rebuild on the next timer pass, e.g. after a theme or static text change.
+void ui_static_layer_invalidate(ui_static_layer_t *layer);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
@@ -0,0 +1,320 @@
+#include "ui_transition.h"
+
+#include "esp_heap_caps.h"
+#include "src/core/lv_obj_draw_private.h"
+#include <Arduino.h>
+#include <string.h>
+
+// 0: outgoing view, 1: incoming view.
+static lv_draw_buf_t s_buf[2];
+static void *s_px[2];
+static uint32_t s_px_bytes;
+
+struct Run {
+    lv_obj_t *host;                // transition screen, or overlay in a tabview
+    lv_obj_t *img[2];
+    lv_point_t from[2];
+    lv_point_t to[2];
+    int8_t fade;                   // 1: incoming fades in, -1: outgoing fades out
+    lv_obj_t *target;              // screen to load at the end, NULL for a tab
+    uint32_t t0;
+};
+
+struct TabCtx {
+    lv_obj_t *tv;
+    uint32_t time;
+    bool armed;                    // outgoing page captured by a tab bar click
+    lv_point_t scroll0;
+};
+
+static Run s_run;
+static bool s_running;
+static ui_transition_stats_t s_stats;
+
+// Both buffers hold a full screen, so any view on the display fits.
+static bool buffers_ready(void)
+{
+    lv_display_t *disp = lv_display_get_default();
+    if (!disp) return false;
+    const uint32_t bytes = lv_draw_buf_width_to_stride(lv_display_get_horizontal_resolution(disp),
+                                                       LV_COLOR_FORMAT_RGB565) *
+                           lv_display_get_vertical_resolution(disp);
+    if (s_px[0] && s_px[1] && s_px_bytes >= bytes) return true;
+    for (int i = 0; i < 2; i++) {
+        heap_caps_free(s_px[i]);
+        s_px[i] = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (!s_px[0] || !s_px[1]) {
+        for (int i = 0; i < 2; i++) {
+            heap_caps_free(s_px[i]);
+            s_px[i] = nullptr;
+        }
+        s_px_bytes = 0;
+        return false;
+    }
+    s_px_bytes = bytes;
+    return true;
+}
+
+static bool snap(lv_obj_t *obj, int i)
+{
+    lv_obj_update_layout(obj);
+    const int32_t w = lv_obj_get_width(obj);
+    const int32_t h = lv_obj_get_height(obj);
+    if (lv_draw_buf_init(&s_buf[i], w, h, LV_COLOR_FORMAT_RGB565, 0, s_px[i], s_px_bytes) != LV_RESULT_OK) return false;
+    return lv_snapshot_take_to_draw_buf(obj, LV_COLOR_FORMAT_RGB565, &s_buf[i]) == LV_RESULT_OK;
+}
+
+static int32_t lerp(int32_t a, int32_t b, int32_t v)
+{
+    return a + (b - a) * v / 256;
+}
+
+static void exec_cb(void *, int32_t v)
+{
+    for (int i = 0; i < 2; i++) {
+        lv_obj_set_pos(s_run.img[i], lerp(s_run.from[i].x, s_run.to[i].x, v), lerp(s_run.from[i].y, s_run.to[i].y, v));
+    }
+    if (s_run.fade > 0) lv_obj_set_style_image_opa(s_run.img[1], (lv_opa_t)lerp(0, 255, v), LV_PART_MAIN);
+    else if (s_run.fade < 0) lv_obj_set_style_image_opa(s_run.img[0], (lv_opa_t)lerp(255, 0, v), LV_PART_MAIN);
+    s_stats.frames++;
+}
+
+static void finish(void)
+{
+    if (!s_running) return;
+    s_running = false;
+    s_stats.duration_ms = lv_tick_elaps(s_run.t0);
+    if (s_run.target) lv_screen_load(s_run.target);
+    lv_obj_delete_async(s_run.host);
+    memset(&s_run, 0, sizeof(s_run));
+}
+
+static void completed_cb(lv_anim_t *)
+{
+    finish();
+}
+
+// A transition still running is cut short so the next one starts from a
+// settled view.
+static void finish_now(void)
+{
+    if (!s_running) return;
+    lv_anim_delete(s_run.host, exec_cb);
+    finish();
+}
+
+// The two snapshots as images on `host`, showing the part at `crop` (the
+// host's origin inside the snapshot).
+static void add_images(lv_obj_t *host, lv_point_t crop)
+{
+    for (int i = 0; i < 2; i++) {
+        lv_obj_t *img = lv_image_create(host);
+        lv_obj_remove_flag(img, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
+        lv_image_set_src(img, &s_buf[i]);
+        lv_obj_set_size(img, lv_pct(100), lv_pct(100));
+        lv_image_set_inner_align(img, LV_IMAGE_ALIGN_TOP_LEFT);
+        lv_image_set_offset_x(img, -crop.x);
+        lv_image_set_offset_y(img, -crop.y);
+        s_run.img[i] = img;
+    }
+}
+
+static void start(lv_obj_t *host, uint32_t time, uint32_t delay, lv_anim_path_cb_t path)
+{
+    s_run.host = host;
+    s_running = true;
+    s_stats.frames = 0;
+    s_run.t0 = lv_tick_get();
+    exec_cb(nullptr, 0);
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, host);
+    lv_anim_set_exec_cb(&a, exec_cb);
+    lv_anim_set_values(&a, 0, 256);
+    lv_anim_set_duration(&a, time);
+    lv_anim_set_delay(&a, delay);
+    lv_anim_set_path_cb(&a, path);
+    lv_anim_set_completed_cb(&a, completed_cb);
+    lv_anim_start(&a);
+}
+
+void ui_transition_screen(lv_obj_t *target, lv_screen_load_anim_t anim, uint32_t time, uint32_t delay)
+{
+    finish_now();
+    lv_obj_t *cur = lv_screen_active();
+    if (!target || target == cur || anim == LV_SCREEN_LOAD_ANIM_NONE || time == 0) {
+        lv_screen_load_anim(target, anim, time, delay, false);
+        return;
+    }
+
+    const uint32_t t0 = micros();
+    if (!buffers_ready() || !snap(cur, 0) || !snap(target, 1)) {
+        s_stats.fallbacks++;
+        lv_screen_load_anim(target, anim, time, delay, false);
+        return;
+    }
+    s_stats.snapshot_us = micros() - t0;
+
+    lv_obj_t *host = lv_obj_create(NULL);
+    lv_obj_remove_style_all(host);
+    lv_obj_set_style_bg_color(host, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(host, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_remove_flag(host, LV_OBJ_FLAG_SCROLLABLE);
+    add_images(host, {0, 0});
+
+    // Direction the views move in, as in lv_screen_load_anim().
+    const int32_t w = lv_obj_get_width(host);
+    const int32_t h = lv_obj_get_height(host);
+    lv_point_t d = {0, 0};
+    switch (anim) {
+    case LV_SCREEN_LOAD_ANIM_OVER_LEFT: case LV_SCREEN_LOAD_ANIM_MOVE_LEFT: case LV_SCREEN_LOAD_ANIM_OUT_LEFT:
+        d.x = -w;
+        break;
+    case LV_SCREEN_LOAD_ANIM_OVER_RIGHT: case LV_SCREEN_LOAD_ANIM_MOVE_RIGHT: case LV_SCREEN_LOAD_ANIM_OUT_RIGHT:
+        d.x = w;
+        break;
+    case LV_SCREEN_LOAD_ANIM_OVER_TOP: case LV_SCREEN_LOAD_ANIM_MOVE_TOP: case LV_SCREEN_LOAD_ANIM_OUT_TOP:
+        d.y = -h;
+        break;
+    case LV_SCREEN_LOAD_ANIM_OVER_BOTTOM: case LV_SCREEN_LOAD_ANIM_MOVE_BOTTOM: case LV_SCREEN_LOAD_ANIM_OUT_BOTTOM:
+        d.y = h;
+        break;
+    default:
+        break;
+    }
+    switch (anim) {
+    case LV_SCREEN_LOAD_ANIM_OVER_LEFT: case LV_SCREEN_LOAD_ANIM_OVER_RIGHT:
+    case LV_SCREEN_LOAD_ANIM_OVER_TOP: case LV_SCREEN_LOAD_ANIM_OVER_BOTTOM:
+        s_run.from[1] = {-d.x, -d.y};
+        break;
+    case LV_SCREEN_LOAD_ANIM_MOVE_LEFT: case LV_SCREEN_LOAD_ANIM_MOVE_RIGHT:
+    case LV_SCREEN_LOAD_ANIM_MOVE_TOP: case LV_SCREEN_LOAD_ANIM_MOVE_BOTTOM:
+        s_run.to[0] = d;
+        s_run.from[1] = {-d.x, -d.y};
+        break;
+    case LV_SCREEN_LOAD_ANIM_OUT_LEFT: case LV_SCREEN_LOAD_ANIM_OUT_RIGHT:
+    case LV_SCREEN_LOAD_ANIM_OUT_TOP: case LV_SCREEN_LOAD_ANIM_OUT_BOTTOM:
+        s_run.to[0] = d;
+        lv_obj_move_foreground(s_run.img[0]);
+        break;
+    case LV_SCREEN_LOAD_ANIM_FADE_OUT:
+        s_run.fade = -1;
+        lv_obj_move_foreground(s_run.img[0]);
+        break;
+    default:
+        s_run.fade = 1;
+        break;
+    }
+    s_run.target = target;
+
+    lv_screen_load(host);
+    start(host, time, delay, lv_anim_path_linear);
+}
+
+static void tab_clicked_cb(lv_event_t *e)
+{
+    TabCtx *ctx = (TabCtx *)lv_event_get_user_data(e);
+    lv_obj_t *button = (lv_obj_t *)lv_event_get_current_target(e);
+    const uint32_t idx = lv_obj_get_index_by_type(button, &lv_button_class);
+    ctx->armed = false;
+    if (s_running || idx == lv_tabview_get_tab_active(ctx->tv)) return;
+    lv_obj_t *cont = lv_tabview_get_content(ctx->tv);
+    if (!buffers_ready() || !snap(ctx->tv, 0)) return;
+    ctx->scroll0 = {lv_obj_get_scroll_x(cont), lv_obj_get_scroll_y(cont)};
+    ctx->armed = true;
+}
+
+static void tab_changed_cb(lv_event_t *e)
+{
+    TabCtx *ctx = (TabCtx *)lv_event_get_user_data(e);
+    lv_obj_t *tv = ctx->tv;
+    lv_obj_t *cont = lv_tabview_get_content(tv);
+    const uint32_t t0 = micros();
+    if (s_running) {
+        ctx->armed = false;
+        return;
+    }
+
+    // A click has switched already; a swipe has only started the scroll
+    // animation to the new page, so the outgoing view is what shows now.
+    lv_point_t scroll0 = ctx->scroll0;
+    if (!ctx->armed) {
+        scroll0 = {lv_obj_get_scroll_x(cont), lv_obj_get_scroll_y(cont)};
+        if (!buffers_ready() || !snap(tv, 0)) return;
+        lv_tabview_set_active(tv, lv_tabview_get_tab_active(tv), LV_ANIM_OFF);
+    }
+    ctx->armed = false;
+    if (!snap(tv, 1)) return;
+    s_stats.snapshot_us = micros() - t0;
+
+    // Pages further apart still slide by one page.
+    const int32_t w = lv_obj_get_width(cont);
+    const int32_t h = lv_obj_get_height(cont);
+    lv_point_t d = {scroll0.x - lv_obj_get_scroll_x(cont), scroll0.y - lv_obj_get_scroll_y(cont)};
+    d.x = LV_CLAMP(-w, d.x, w);
+    d.y = LV_CLAMP(-h, d.y, h);
+    if (d.x == 0 && d.y == 0) return;
+
+    // Overlay over the content area, opaque so the pages below are skipped.
+    lv_obj_t *host = lv_obj_create(tv);
+    lv_obj_remove_style_all(host);
+    lv_obj_add_flag(host, (lv_obj_flag_t)(LV_OBJ_FLAG_IGNORE_LAYOUT | LV_OBJ_FLAG_FLOATING));
+    lv_obj_remove_flag(host, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_bg_color(host, lv_obj_get_style_bg_color(tv, LV_PART_MAIN), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(host, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_pos(host, lv_obj_get_x(cont), lv_obj_get_y(cont));
+    lv_obj_set_size(host, w, h);
+    lv_area_t tv_area, cont_area;
+    lv_obj_get_coords(tv, &tv_area);
+    lv_obj_get_coords(cont, &cont_area);
+    const int32_t ext = lv_obj_get_ext_draw_size(tv);
+    add_images(host, {cont_area.x1 - tv_area.x1 + ext, cont_area.y1 - tv_area.y1 + ext});
+
+    s_run.to[0] = d;
+    s_run.from[1] = {-d.x, -d.y};
+    start(host, ctx->time, 0, lv_anim_path_ease_out);
+}
+
+static void tab_delete_cb(lv_event_t *e)
+{
+    TabCtx *ctx = (TabCtx *)lv_event_get_user_data(e);
+    if (s_running && s_run.host && lv_obj_get_parent(s_run.host) == ctx->tv) {
+        lv_anim_delete(s_run.host, exec_cb);
+        s_running = false;
+        memset(&s_run, 0, sizeof(s_run));
+    }
+    lv_free(ctx);
+}
+
+void ui_transition_attach_tabview(lv_obj_t *tabview, uint32_t time)
+{
+    if (!tabview || !lv_obj_check_type(tabview, &lv_tabview_class) || time == 0) return;
+    TabCtx *ctx = (TabCtx *)lv_malloc_zeroed(sizeof(TabCtx));
+    if (!ctx) return;
+    ctx->tv = tabview;
+    ctx->time = time;
+
+    // Runs before the tab bar's own handler switches the page.
+    lv_obj_t *bar = lv_tabview_get_tab_bar(tabview);
+    const uint32_t n = lv_obj_get_child_count(bar);
+    for (uint32_t i = 0; i < n; i++) {
+        lv_obj_t *button = lv_obj_get_child(bar, i);
+        if (lv_obj_check_type(button, &lv_button_class)) {
+            lv_obj_add_event_cb(button, tab_clicked_cb, (lv_event_code_t)(LV_EVENT_CLICKED | LV_EVENT_PREPROCESS), ctx);
+        }
+    }
+    lv_obj_add_event_cb(tabview, tab_changed_cb, LV_EVENT_VALUE_CHANGED, ctx);
+    lv_obj_add_event_cb(tabview, tab_delete_cb, LV_EVENT_DELETE, ctx);
+}
+
+bool ui_transition_is_running(void)
+{
+    return s_running;
+}
+
+void ui_transition_get_stats(ui_transition_stats_t *out)
+{
+    *out = s_stats;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Screen and tab transitions from snapshots. The outgoing and incoming views
+// are rendered once into two RGB565 buffers (PSRAM, allocated on first use
+// and kept), and the animation only moves or blends those two images on a
+// bare host object, so each frame is two blits instead of two live trees
+// drawn through a layer. The real view takes over when the animation ends;
+// data that changed meanwhile shows from then on.
+
+#ifndef UI_TRANSITION_TAB_MS
+#define UI_TRANSITION_TAB_MS 250
+#endif
+
+typedef struct {
+    uint32_t snapshot_us;      // rendering both views, last transition
+    uint32_t frames;           // frames drawn during the last transition
+    uint32_t duration_ms;
+    uint16_t fallbacks;        // ran as a plain LVGL animation instead
+} ui_transition_stats_t;
+
+// Drop-in for lv_screen_load_anim() (the old screen is never auto-deleted).
+// Falls back to it when the buffers can't be allocated or a snapshot fails.
+void ui_transition_screen(lv_obj_t *target, lv_screen_load_anim_t anim, uint32_t time, uint32_t delay);
+
+// Slide tab changes of `tabview` (tab bar clicks and swipes that settle on
+// another page) over `time` ms instead of scrolling the live pages.
+void ui_transition_attach_tabview(lv_obj_t *tabview, uint32_t time);
+
+bool ui_transition_is_running(void);
+
+void ui_transition_get_stats(ui_transition_stats_t *out);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
@@ -0,0 +1,151 @@
+#include "ui_update_sched.h"
+#include "ui_msg_queue.h"
+#include "usb_stream.h"
+
+#include <Arduino.h>
+
+struct Channel {
+    const char *name;
+    ui_sched_apply_cb_t cb;
+    void *user_data;
+    uint32_t min_interval_ms;
+    uint32_t last_apply_ms;
+    uint32_t sources;
+    ui_sched_cost_t cost;
+    bool dirty;
+    ui_sched_channel_stats_t stats;
+};
+
+static Channel s_channels[UI_SCHED_MAX_CHANNELS];
+static int s_channel_count = 0;
+static int s_next_channel = 0;      // round-robin start so no channel starves under budget
+static uint32_t s_budget_us = 4000;
+static lv_display_t *s_disp = nullptr;
+static uint16_t s_trace_pass;
+
+static void keep_refreshing()
+{
+    // The refresh timer pauses itself when nothing is invalid; wake it so the
+    // pending channels get their REFR_START pass.
+    lv_timer_t *t = s_disp ? lv_display_get_refr_timer(s_disp) : nullptr;
+    if (t) lv_timer_resume(t);
+}
+
+static void refr_start_cb(lv_event_t *e)
+{
+    (void)e;
+    if (s_channel_count == 0) return;
+
+    const uint32_t start_us = micros();
+    const uint32_t now_ms = lv_tick_get();
+    const bool scrolling = ui_sched_is_scrolling();
+    bool pending = false;
+    bool applied_any = false;
+    bool budget_hit = false;
+
+    for (int n = 0; n < s_channel_count; n++) {
+        int idx = (s_next_channel + n) % s_channel_count;
+        Channel &c = s_channels[idx];
+        if (!c.dirty) continue;
+
+        if (c.last_apply_ms != 0 && (now_ms - c.last_apply_ms) < c.min_interval_ms) {
+            c.stats.deferred_rate++;
+            pending = true;
+            continue;
+        }
+        if (scrolling && c.cost == UI_SCHED_EXPENSIVE) {
+            c.stats.deferred_scroll++;
+            pending = true;
+            continue;
+        }
+        // Always apply at least one channel per frame so a slow one can't block forever.
+        if (applied_any && (micros() - start_us) >= s_budget_us) {
+            c.stats.deferred_budget++;
+            pending = true;
+            // Resume at the first channel the budget cut off, not the last.
+            if (!budget_hit) s_next_channel = idx;
+            budget_hit = true;
+            continue;
+        }
+
+        uint32_t t0 = micros();
+        c.dirty = false;
+        c.last_apply_ms = now_ms ? now_ms : 1;
+        c.cb(c.user_data);
+        c.stats.applied++;
+        c.stats.last_cost_us = micros() - t0;
+        applied_any = true;
+    }
+
+    if (applied_any) usb_trace(s_trace_pass, start_us, micros() - start_us);
+    if (pending) keep_refreshing();
+}
+
+static void on_telemetry_msg(const ui_msg_t *msg)
+{
+    ui_sched_mark_sources(msg->u.telemetry.sources);
+}
+
+void ui_sched_init(lv_display_t *disp, uint32_t frame_budget_us)
+{
+    if (!disp || s_disp) return;
+    s_disp = disp;
+    s_budget_us = frame_budget_us;
+    s_trace_pass = usb_trace_register("ui_sched");
+    lv_display_add_event_cb(disp, refr_start_cb, LV_EVENT_REFR_START, nullptr);
+    ui_msg_queue_set_handler(UI_MSG_TELEMETRY, on_telemetry_msg);
+}
+
+void ui_sched_set_frame_budget_us(uint32_t us)
+{
+    s_budget_us = us;
+}
+
+int ui_sched_add_channel(const char *name, ui_sched_apply_cb_t cb, void *user_data,
+                         uint16_t max_hz, ui_sched_cost_t cost)
+{
+    if (!cb || s_channel_count >= UI_SCHED_MAX_CHANNELS) return -1;
+    Channel &c = s_channels[s_channel_count];
+    c = {};
+    c.name = name;
+    c.cb = cb;
+    c.user_data = user_data;
+    c.min_interval_ms = (max_hz > 0) ? (1000u / max_hz) : 0;
+    c.cost = cost;
+    return s_channel_count++;
+}
+
+void ui_sched_mark(int ch)
+{
+    if (ch < 0 || ch >= s_channel_count) return;
+    if (s_channels[ch].dirty) return;
+    s_channels[ch].dirty = true;
+    keep_refreshing();
+}
+
+void ui_sched_set_channel_sources(int ch, uint32_t source_bits)
+{
+    if (ch < 0 || ch >= s_channel_count) return;
+    s_channels[ch].sources = source_bits;
+}
+
+void ui_sched_mark_sources(uint32_t source_bits)
+{
+    for (int i = 0; i < s_channel_count; i++) {
+        if (s_channels[i].sources & source_bits) ui_sched_mark(i);
+    }
+}
+
+bool ui_sched_is_scrolling(void)
+{
+    for (lv_indev_t *indev = lv_indev_get_next(NULL); indev; indev = lv_indev_get_next(indev)) {
+        if (lv_indev_get_scroll_obj(indev) != NULL) return true;
+    }
+    return false;
+}
+
+void ui_sched_get_stats(int ch, ui_sched_channel_stats_t *out)
+{
+    if (!out || ch < 0 || ch >= s_channel_count) return;
+    *out = s_channels[ch].stats;
+}
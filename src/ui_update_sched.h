@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frame-aligned UI update coalescer. Producers mark a channel dirty as often
+// as they like; pending channels are applied once per display refresh from
+// LV_EVENT_REFR_START, right before LVGL lays out and renders the frame.
+// Each channel has a maximum apply rate, the whole pass has a time budget,
+// and expensive channels are deferred while the user is scrolling.
+
+#define UI_SCHED_MAX_CHANNELS 16
+
+typedef enum {
+    UI_SCHED_CHEAP = 0,       // a few label/style updates
+    UI_SCHED_EXPENSIVE,       // relayout or many widgets; deferred while scrolling
+} ui_sched_cost_t;
+
+typedef void (*ui_sched_apply_cb_t)(void *user_data);
+
+typedef struct {
+    uint32_t applied;
+    uint32_t deferred_rate;
+    uint32_t deferred_scroll;
+    uint32_t deferred_budget;
+    uint32_t last_cost_us;
+} ui_sched_channel_stats_t;
+
+void ui_sched_init(lv_display_t *disp, uint32_t frame_budget_us);
+void ui_sched_set_frame_budget_us(uint32_t us);
+
+// Returns the channel id, or -1 when the table is full.
+int ui_sched_add_channel(const char *name, ui_sched_apply_cb_t cb, void *user_data,
+                         uint16_t max_hz, ui_sched_cost_t cost);
+
+// LVGL thread only (other tasks go through ui_msg_post_telemetry).
+void ui_sched_mark(int ch);
+
+// Mark `ch` whenever a UI_MSG_TELEMETRY with any of `source_bits` is drained.
+void ui_sched_set_channel_sources(int ch, uint32_t source_bits);
+void ui_sched_mark_sources(uint32_t source_bits);
+
+bool ui_sched_is_scrolling(void);
+void ui_sched_get_stats(int ch, ui_sched_channel_stats_t *out);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
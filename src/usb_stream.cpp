@@ -0,0 +1,517 @@
+#include "usb_stream.h"
+#include "ant_bms_ble_module.h"
+#include "vesc_module.h"
+
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static constexpr uint32_t kPeriodMs = 5;
+static constexpr uint32_t kStatsPeriodMs = 1000;
+static constexpr size_t kTxBytes = 2048;
+// Worst case for a full payload: type + seq + crc, one COBS code byte per
+// 254 data bytes plus the leading one, and the delimiter.
+static constexpr size_t kMaxFrameBytes = (USB_STREAM_MAX_PAYLOAD + 4) + (USB_STREAM_MAX_PAYLOAD + 4) / 254 + 2;
+static constexpr uint32_t kTraceCapacity = 256;
+static constexpr size_t kTracesPerFrame = USB_STREAM_MAX_PAYLOAD / sizeof(usb_trace_event_t);
+static constexpr size_t kMaxNameLen = 31;
+
+static_assert((kTraceCapacity & (kTraceCapacity - 1)) == 0, "capacity must be a power of two");
+static_assert(kTxBytes >= 2 * kMaxFrameBytes, "tx buffer must hold a few frames");
+
+struct TypeDesc {
+    uint8_t type;
+    uint16_t size;
+    const char *name;
+    const usb_field_t *fields;
+    uint8_t field_count;
+};
+
+struct HubStream {
+    bool used;
+    uint8_t type;
+    bool latest_only;
+    uint16_t size;
+    hub_reader_t reader;
+};
+
+struct Source {
+    usb_stream_source_cb_t cb;
+    void *user_data;
+};
+
+// Trace ring: bounded MPSC (Vyukov), same scheme as ui_msg_queue. The sender
+// encodes events straight out of the cells.
+struct TraceCell {
+    std::atomic<uint32_t> seq;
+    usb_trace_event_t ev;
+};
+
+static TraceCell s_trace[kTraceCapacity];
+static std::atomic<uint32_t> s_trace_head{0};
+static std::atomic<uint32_t> s_trace_tail{0};
+
+static struct TraceInit {
+    TraceInit()
+    {
+        for (uint32_t i = 0; i < kTraceCapacity; i++) s_trace[i].seq.store(i, std::memory_order_relaxed);
+    }
+} s_trace_init;
+
+static TypeDesc s_types[USB_STREAM_MAX_TYPES];
+static int s_type_count = 0;
+static const char *s_trace_names[USB_TRACE_MAX_NAMES];
+static std::atomic<uint16_t> s_trace_name_count{0};
+static HubStream s_hubs[HUB_CH_COUNT];
+static Source s_sources[USB_STREAM_MAX_SOURCES];
+static int s_source_count = 0;
+
+static TaskHandle_t s_task = nullptr;
+static std::atomic<bool> s_open{false};
+static std::atomic<uint32_t> s_session{0};
+static usb_stream_stats_t s_stats;
+static std::atomic<uint32_t> s_trace_dropped{0};
+
+// Sender-task state.
+static uint8_t s_tx[kTxBytes];
+static size_t s_tx_len = 0;
+static size_t s_tx_sent = 0;
+static uint8_t s_seq = 0;
+static int s_desc_next = 0;       // descriptors still to send after an open
+static uint8_t s_payload[USB_STREAM_MAX_PAYLOAD];
+
+static uint16_t crc16_ccitt(uint16_t crc, uint8_t b)
+{
+    crc ^= (uint16_t)b << 8;
+    for (int i = 0; i < 8; i++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    return crc;
+}
+
+// Streaming COBS encoder appending one frame to s_tx. A frame that does not
+// fit is rolled back as a whole.
+class FrameWriter {
+ public:
+  explicit FrameWriter(uint8_t type) : start_(s_tx_len), pos_(s_tx_len)
+  {
+    code_pos_ = pos_++;
+    ok_ = pos_ <= kTxBytes;
+    u8(type);
+    u8(s_seq);
+  }
+
+  void u8(uint8_t b)
+  {
+    crc_ = crc16_ccitt(crc_, b);
+    raw_(b);
+  }
+
+  void u16(uint16_t v)
+  {
+    u8((uint8_t)v);
+    u8((uint8_t)(v >> 8));
+  }
+
+  void bytes(const void *data, size_t len)
+  {
+    const uint8_t *p = (const uint8_t *)data;
+    while (len--) u8(*p++);
+  }
+
+  void str(const char *s)
+  {
+    size_t n = s ? strnlen(s, kMaxNameLen) : 0;
+    u8((uint8_t)n);
+    bytes(s, n);
+  }
+
+  bool finish()
+  {
+    const uint16_t crc = crc_;
+    raw_((uint8_t)crc);
+    raw_((uint8_t)(crc >> 8));
+    if (ok_ && pos_ < kTxBytes) {
+      s_tx[code_pos_] = code_;
+      s_tx[pos_++] = 0x00;
+      s_tx_len = pos_;
+      s_seq++;
+      s_stats.frames++;
+      return true;
+    }
+    s_tx_len = start_;
+    return false;
+  }
+
+ private:
+  size_t start_;
+  size_t pos_;
+  size_t code_pos_;
+  uint8_t code_ = 1;
+  uint16_t crc_ = 0xFFFF;
+  bool ok_;
+
+  void raw_(uint8_t b)
+  {
+    if (!ok_) return;
+    if (b == 0) {
+      close_block_();
+      return;
+    }
+    if (pos_ >= kTxBytes) {
+      ok_ = false;
+      return;
+    }
+    s_tx[pos_++] = b;
+    if (++code_ == 0xFF) close_block_();
+  }
+
+  void close_block_()
+  {
+    if (pos_ >= kTxBytes) {
+      ok_ = false;
+      return;
+    }
+    s_tx[code_pos_] = code_;
+    code_pos_ = pos_++;
+    code_ = 1;
+  }
+};
+
+static bool tx_has_room()
+{
+    return kTxBytes - s_tx_len >= kMaxFrameBytes;
+}
+
+// Push as much of s_tx as the CDC FIFO takes; the rest goes next cycle.
+// Returns true once the buffer is drained.
+static bool tx_flush()
+{
+    while (s_tx_sent < s_tx_len) {
+        int room = Serial.availableForWrite();
+        if (room <= 0) return false;
+        size_t n = s_tx_len - s_tx_sent;
+        if (n > (size_t)room) n = (size_t)room;
+        size_t w = Serial.write(s_tx + s_tx_sent, n);
+        if (w == 0) return false;
+        s_tx_sent += w;
+        s_stats.bytes += w;
+    }
+    s_tx_len = s_tx_sent = 0;
+    return true;
+}
+
+static void poll_control()
+{
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c == 'B' && !s_open.load()) {
+            s_desc_next = 0;
+            s_session.fetch_add(1);
+            s_open.store(true);
+        } else if (c == 'T') {
+            s_open.store(false);
+        }
+    }
+}
+
+static bool send_type_desc(const TypeDesc &d)
+{
+    FrameWriter f(USB_FT_TYPE_DESC);
+    f.u8(d.type);
+    f.u16(d.size);
+    f.str(d.name);
+    f.u8(d.field_count);
+    for (uint8_t i = 0; i < d.field_count; i++) {
+        const usb_field_t &fd = d.fields[i];
+        f.u8(fd.kind);
+        f.u8(fd.count);
+        f.u16(fd.offset);
+        f.str(fd.name);
+    }
+    return f.finish();
+}
+
+static bool send_trace_name(uint16_t id)
+{
+    FrameWriter f(USB_FT_TRACE_NAME);
+    f.u16(id);
+    f.str(s_trace_names[id]);
+    return f.finish();
+}
+
+// Descriptors go out first after every open, a few frames per cycle.
+static bool send_descriptors()
+{
+    const int names = s_trace_name_count.load(std::memory_order_acquire);
+    while (s_desc_next < s_type_count + names) {
+        if (!tx_has_room()) return false;
+        bool ok = (s_desc_next < s_type_count) ? send_type_desc(s_types[s_desc_next])
+                                               : send_trace_name((uint16_t)(s_desc_next - s_type_count));
+        if (!ok && s_tx_len == 0) {
+            s_desc_next++;         // cannot fit even into an empty buffer; skip it
+            continue;
+        }
+        if (!ok) return false;
+        s_desc_next++;
+    }
+    return true;
+}
+
+static bool send_traces()
+{
+    uint32_t pos = s_trace_tail.load(std::memory_order_relaxed);
+    if (s_trace[pos & (kTraceCapacity - 1)].seq.load(std::memory_order_acquire) != pos + 1) return false;
+
+    FrameWriter f(USB_FT_TRACE);
+    size_t n = 0;
+    while (n < kTracesPerFrame) {
+        TraceCell &cell = s_trace[pos & (kTraceCapacity - 1)];
+        if (cell.seq.load(std::memory_order_acquire) != pos + 1) break;
+        f.bytes(&cell.ev, sizeof(cell.ev));
+        cell.seq.store(pos + kTraceCapacity, std::memory_order_release);
+        pos++;
+        n++;
+    }
+    s_trace_tail.store(pos, std::memory_order_relaxed);
+    return f.finish();
+}
+
+static bool send_hub(HubStream &h)
+{
+    uint32_t t_ms = 0;
+    const uint32_t missed = h.reader.missed;
+    bool got = h.latest_only ? hub_read_latest(&h.reader, s_payload + 4, &t_ms)
+                             : hub_read_next(&h.reader, s_payload + 4, &t_ms);
+    s_stats.hub_missed += h.reader.missed - missed;
+    if (!got) return false;
+    memcpy(s_payload, &t_ms, 4);
+    FrameWriter f(h.type);
+    f.bytes(s_payload, 4 + h.size);
+    return f.finish();
+}
+
+static bool send_source(const Source &s)
+{
+    uint8_t type = 0;
+    size_t len = s.cb(&type, s_payload, sizeof(s_payload), s.user_data);
+    if (len == 0) return false;
+    FrameWriter f(type);
+    f.bytes(s_payload, len);
+    return f.finish();
+}
+
+static void send_stats()
+{
+    usb_stream_stats_t st = s_stats;
+    st.trace_dropped = s_trace_dropped.load(std::memory_order_relaxed);
+    FrameWriter f(USB_FT_STATS);
+    f.bytes(&st, sizeof(st));
+    f.finish();
+}
+
+// Round-robin over the sources until the buffer is full or all are idle.
+static void fill()
+{
+    bool any = true;
+    while (any && tx_has_room()) {
+        any = false;
+        if (send_traces()) any = true;
+        for (auto &h : s_hubs) {
+            if (h.used && tx_has_room() && send_hub(h)) any = true;
+        }
+        for (int i = 0; i < s_source_count; i++) {
+            if (tx_has_room() && send_source(s_sources[i])) any = true;
+        }
+    }
+}
+
+static void sender_task(void *arg)
+{
+    (void)arg;
+    TickType_t wake = xTaskGetTickCount();
+    uint32_t last_stats_ms = 0;
+    for (;;) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(kPeriodMs));
+        poll_control();
+        if (s_open.load() && !Serial) s_open.store(false);
+        if (!s_open.load()) {
+            s_tx_len = s_tx_sent = 0;
+            continue;
+        }
+        if (!tx_flush()) {
+            s_stats.backpressure++;
+            continue;
+        }
+        if (!send_descriptors()) {
+            tx_flush();
+            continue;
+        }
+        fill();
+        const uint32_t now = millis();
+        if (now - last_stats_ms >= kStatsPeriodMs && tx_has_room()) {
+            last_stats_ms = now;
+            send_stats();
+        }
+        tx_flush();
+    }
+}
+
+bool usb_stream_register_type(uint8_t type, const char *name, uint16_t size,
+                              const usb_field_t *fields, uint8_t field_count)
+{
+    if (size > USB_STREAM_MAX_PAYLOAD || field_count > USB_STREAM_MAX_FIELDS) return false;
+    for (int i = 0; i < s_type_count; i++) {
+        if (s_types[i].type == type) return false;
+    }
+    if (s_type_count >= USB_STREAM_MAX_TYPES) return false;
+    s_types[s_type_count++] = {type, size, name, fields, field_count};
+    return true;
+}
+
+bool usb_stream_add_hub(hub_channel_t ch, uint8_t type, uint16_t max_hz)
+{
+    if ((int)ch < 0 || ch >= HUB_CH_COUNT || s_hubs[ch].used) return false;
+    uint16_t size = 0;
+    for (int i = 0; i < s_type_count; i++) {
+        if (s_types[i].type == type) size = s_types[i].size;
+    }
+    // The frame carries t_ms in front of the sample.
+    if (size < 4) return false;
+    HubStream &h = s_hubs[ch];
+    h.type = type;
+    h.size = (uint16_t)(size - 4);
+    h.latest_only = max_hz > 0;
+    hub_reader_init(&h.reader, ch, max_hz > 0 ? 1000u / max_hz : 0);
+    h.used = true;
+    return true;
+}
+
+bool usb_stream_add_source(usb_stream_source_cb_t cb, void *user_data)
+{
+    if (!cb || s_source_count >= USB_STREAM_MAX_SOURCES) return false;
+    s_sources[s_source_count++] = {cb, user_data};
+    return true;
+}
+
+// Payload layouts of the built-in types: t_ms:u32 followed by the sample.
+// Offsets are shifted by 4 to skip the timestamp.
+struct BmsFrame {
+    uint32_t t_ms;
+    ant_bms_sample_t s;
+};
+
+struct VescFrame {
+    uint32_t t_ms;
+    vesc_snapshot_t s;
+};
+
+static const usb_field_t kBmsFields[] = {
+    USB_FIELD(BmsFrame, t_ms, USB_FIELD_U32),
+    USB_FIELD(BmsFrame, s.pack_mv, USB_FIELD_I32),
+    USB_FIELD(BmsFrame, s.current_ma, USB_FIELD_I32),
+    USB_FIELD(BmsFrame, s.power_w, USB_FIELD_I32),
+    USB_FIELD(BmsFrame, s.soc_dpct, USB_FIELD_U16),
+    USB_FIELD(BmsFrame, s.cell_count, USB_FIELD_U8),
+    USB_FIELD(BmsFrame, s.temp_count, USB_FIELD_U8),
+    USB_FIELD(BmsFrame, s.charge_on, USB_FIELD_U8),
+    USB_FIELD(BmsFrame, s.discharge_on, USB_FIELD_U8),
+    USB_FIELD(BmsFrame, s.min_cell_mv, USB_FIELD_U16),
+    USB_FIELD(BmsFrame, s.max_cell_mv, USB_FIELD_U16),
+    USB_FIELD(BmsFrame, s.delta_cell_mv, USB_FIELD_U16),
+    USB_FIELD_ARRAY(BmsFrame, s.temp_dc, USB_FIELD_I16, ANT_BMS_MAX_TEMPS),
+    USB_FIELD_ARRAY(BmsFrame, s.cell_mv, USB_FIELD_U16, ANT_BMS_MAX_CELLS),
+};
+
+// Per-node data is left out of the descriptor; the host sees the aggregates.
+static const usb_field_t kVescFields[] = {
+    USB_FIELD(VescFrame, t_ms, USB_FIELD_U32),
+    USB_FIELD(VescFrame, s.connected, USB_FIELD_BOOL),
+    USB_FIELD(VescFrame, s.round_ms, USB_FIELD_U32),
+    USB_FIELD(VescFrame, s.speed_dkmh, USB_FIELD_I32),
+    USB_FIELD(VescFrame, s.power_w, USB_FIELD_I32),
+    USB_FIELD(VescFrame, s.temp_motor_dc, USB_FIELD_I16),
+    USB_FIELD(VescFrame, s.temp_fet_dc, USB_FIELD_I16),
+    USB_FIELD(VescFrame, s.v_in_dv, USB_FIELD_I16),
+    USB_FIELD(VescFrame, s.current_in_ca, USB_FIELD_I32),
+    USB_FIELD(VescFrame, s.duty_pm, USB_FIELD_I16),
+    USB_FIELD(VescFrame, s.fault, USB_FIELD_U8),
+    USB_FIELD(VescFrame, s.odometer_m, USB_FIELD_U32),
+    USB_FIELD(VescFrame, s.node_count, USB_FIELD_U8),
+};
+
+static_assert(offsetof(BmsFrame, s) == 4 && offsetof(VescFrame, s) == 4, "sample must follow t_ms");
+static_assert(sizeof(BmsFrame) <= USB_STREAM_MAX_PAYLOAD, "BMS sample does not fit a frame");
+static_assert(sizeof(VescFrame) <= USB_STREAM_MAX_PAYLOAD, "VESC snapshot does not fit a frame");
+
+void usb_stream_init(uint8_t core)
+{
+    if (s_task) return;
+    usb_stream_register_type(USB_FT_BMS, "bms", sizeof(BmsFrame), kBmsFields,
+                             sizeof(kBmsFields) / sizeof(kBmsFields[0]));
+    usb_stream_register_type(USB_FT_VESC, "vesc", sizeof(VescFrame), kVescFields,
+                             sizeof(kVescFields) / sizeof(kVescFields[0]));
+    usb_stream_add_hub(HUB_CH_BMS, USB_FT_BMS, 0);
+    usb_stream_add_hub(HUB_CH_VESC, USB_FT_VESC, 0);
+    xTaskCreatePinnedToCore(sender_task, "usb_stream", 4096, nullptr, 1, &s_task, core);
+}
+
+bool usb_stream_is_open(void)
+{
+    return s_open.load();
+}
+
+uint32_t usb_stream_session(void)
+{
+    return s_session.load();
+}
+
+void usb_stream_get_stats(usb_stream_stats_t *out)
+{
+    if (!out) return;
+    *out = s_stats;
+    out->trace_dropped = s_trace_dropped.load(std::memory_order_relaxed);
+}
+
+uint16_t usb_trace_register(const char *name)
+{
+    uint16_t id = s_trace_name_count.load(std::memory_order_relaxed);
+    if (id >= USB_TRACE_MAX_NAMES) return USB_TRACE_UNNAMED;
+    s_trace_names[id] = name;
+    s_trace_name_count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+void usb_trace(uint16_t id, uint32_t start_us, uint32_t dur_us)
+{
+    if (!s_open.load(std::memory_order_relaxed)) return;
+    uint32_t pos = s_trace_head.load(std::memory_order_relaxed);
+    for (;;) {
+        TraceCell &cell = s_trace[pos & (kTraceCapacity - 1)];
+        uint32_t seq = cell.seq.load(std::memory_order_acquire);
+        int32_t dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            if (s_trace_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.ev.id = id;
+                cell.ev.core = (uint8_t)xPortGetCoreID();
+                cell.ev.reserved = 0;
+                cell.ev.start_us = start_us;
+                cell.ev.dur_us = dur_us;
+                cell.seq.store(pos + 1, std::memory_order_release);
+                return;
+            }
+        } else if (dif < 0) {
+            s_trace_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = s_trace_head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+UsbTraceScope::UsbTraceScope(uint16_t id) : id_(id), start_us_(micros()) {}
+
+UsbTraceScope::~UsbTraceScope()
+{
+    usb_trace(id_, start_us_, micros() - start_us_);
+}
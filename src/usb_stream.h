@@ -0,0 +1,130 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "telemetry_hub.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binary telemetry / trace stream on the USB CDC port (the same port as
+// Serial). Frames are COBS-encoded and 0x00-delimited:
+//
+//   type:u8  seq:u8  payload  crc16:u16le
+//
+// with CRC-16/CCITT-FALSE over type..payload. Nothing binary is written until
+// the host sends 'B'; 'T' returns the port to plain text, so a serial monitor
+// still works. Text printed while the stream is open shows up as frames with
+// a bad CRC and is skipped by the host.
+//
+// Frame types below USB_FT_USER belong to the protocol. Producers register
+// their types with a field layout (sent to the host when the stream opens),
+// so extras/usb_stream.py decodes them without hard-coded structs.
+
+#define USB_STREAM_MAX_PAYLOAD 512
+#define USB_STREAM_MAX_TYPES 16
+#define USB_STREAM_MAX_FIELDS 24
+#define USB_STREAM_MAX_SOURCES 4
+#define USB_TRACE_MAX_NAMES 32
+#define USB_TRACE_UNNAMED 0xFFFF
+
+typedef enum {
+    USB_FT_TYPE_DESC = 0x01,      // see usb_stream_register_type
+    USB_FT_TRACE_NAME = 0x02,     // id:u16 name
+    USB_FT_TRACE = 0x03,          // usb_trace_event_t[]
+    USB_FT_STATS = 0x04,          // usb_stream_stats_t
+    USB_FT_LOG_SITE = 0x05,       // dlog call site, see dlog.cpp
+    USB_FT_LOG = 0x06,            // dlog record
+    USB_FT_USER = 0x10,
+    USB_FT_BMS = 0x10,            // t_ms:u32 ant_bms_sample_t
+    USB_FT_VESC = 0x11,           // t_ms:u32 vesc_snapshot_t
+} usb_frame_type_t;
+
+typedef enum {
+    USB_FIELD_U8 = 0,
+    USB_FIELD_I8,
+    USB_FIELD_U16,
+    USB_FIELD_I16,
+    USB_FIELD_U32,
+    USB_FIELD_I32,
+    USB_FIELD_F32,
+    USB_FIELD_BOOL,
+} usb_field_kind_t;
+
+typedef struct {
+    const char *name;
+    uint8_t kind;                 // usb_field_kind_t
+    uint8_t count;                // array length, 1 for scalars
+    uint16_t offset;              // into the payload
+} usb_field_t;
+
+#define USB_FIELD(T, f, kind) { #f, (uint8_t)(kind), 1, (uint16_t)offsetof(T, f) }
+#define USB_FIELD_ARRAY(T, f, kind, n) { #f, (uint8_t)(kind), (uint8_t)(n), (uint16_t)offsetof(T, f) }
+
+typedef struct __attribute__((packed)) {
+    uint16_t id;                  // from usb_trace_register
+    uint8_t core;
+    uint8_t reserved;
+    uint32_t start_us;
+    uint32_t dur_us;
+} usb_trace_event_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t backpressure;        // sender cycles skipped because the CDC FIFO was full
+    uint32_t trace_dropped;       // trace ring full
+    uint32_t hub_missed;          // hub history overwritten before it was sent
+    uint32_t crc_errors;          // unused on the device; the host fills it in
+} usb_stream_stats_t;
+
+// Describe a frame type. `fields` must outlive the stream; `size` is the
+// payload size (fields may leave gaps the host ignores). Call before
+// usb_stream_init() or from the LVGL thread.
+bool usb_stream_register_type(uint8_t type, const char *name, uint16_t size,
+                              const usb_field_t *fields, uint8_t field_count);
+
+// Send every sample of a hub channel (max_hz = 0) or the newest one at most
+// max_hz times a second, as frames of `type` carrying t_ms:u32 + sample.
+bool usb_stream_add_hub(hub_channel_t ch, uint8_t type, uint16_t max_hz);
+
+// Pull source, called from the sender task while the stream is open. Writes
+// at most one frame payload into `buf`, sets *type and returns its length,
+// or 0 when nothing is pending.
+typedef size_t (*usb_stream_source_cb_t)(uint8_t *type, uint8_t *buf, size_t cap, void *user_data);
+bool usb_stream_add_source(usb_stream_source_cb_t cb, void *user_data);
+
+// Start the sender task; the BMS and VESC channels are registered here.
+void usb_stream_init(uint8_t core);
+
+bool usb_stream_is_open(void);
+
+// Incremented every time the host opens the stream; sources that send
+// their own descriptors resend them when it changes.
+uint32_t usb_stream_session(void);
+void usb_stream_get_stats(usb_stream_stats_t *out);
+
+// Profiler events. Register names once at init from the setup task (ids
+// past the table come back as USB_TRACE_UNNAMED). usb_trace() is lock-free,
+// safe from any task and drops the event when the ring is full or the
+// stream is closed.
+uint16_t usb_trace_register(const char *name);
+void usb_trace(uint16_t id, uint32_t start_us, uint32_t dur_us);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+
+// Times the enclosing scope.
+class UsbTraceScope {
+ public:
+  explicit UsbTraceScope(uint16_t id);
+  ~UsbTraceScope();
+
+ private:
+  uint16_t id_;
+  uint32_t start_us_;
+};
+#endif
@@ -0,0 +1,101 @@
+#include "vesc_ble_transport.h"
+#include "ble_links.h"
+
+namespace vesc {
+
+bool BleNusTransport::connect(const NimBLEAddress &addr) {
+  disconnect();
+
+  client_ = NimBLEDevice::createClient();
+  if (!client_) return false;
+  if (!ble_link_connect(BLE_LINK_VESC, client_, addr)) {
+    disconnect();
+    return false;
+  }
+
+  NimBLERemoteService *svc = client_->getService(NimBLEUUID(kNusServiceUuid));
+  NimBLERemoteCharacteristic *tx = svc ? svc->getCharacteristic(NimBLEUUID(kNusTxCharUuid)) : nullptr;
+  rx_chr_ = svc ? svc->getCharacteristic(NimBLEUUID(kNusRxCharUuid)) : nullptr;
+  if (!tx || !rx_chr_ || !tx->canNotify()) {
+    disconnect();
+    return false;
+  }
+  write_no_rsp_ = rx_chr_->canWriteNoResponse();
+
+  discard_input();
+  auto cb = [this](NimBLERemoteCharacteristic *, uint8_t *data, size_t len, bool) { on_notify_(data, len); };
+  if (!tx->subscribe(true, cb)) {
+    disconnect();
+    return false;
+  }
+  return true;
+}
+
+void BleNusTransport::disconnect() {
+  rx_chr_ = nullptr;
+  if (client_) {
+    ble_link_disconnected(BLE_LINK_VESC);
+    if (client_->isConnected()) client_->disconnect();
+    NimBLEDevice::deleteClient(client_);
+    client_ = nullptr;
+  }
+}
+
+bool BleNusTransport::is_connected() const {
+  return client_ && rx_chr_ && client_->isConnected();
+}
+
+void BleNusTransport::on_notify_(const uint8_t *data, size_t len) {
+  ble_link_note_rx(BLE_LINK_VESC, len);
+  uint32_t head = head_.load(std::memory_order_relaxed);
+  const uint32_t tail = tail_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < len; i++) {
+    if (head - tail >= kRingSize) {
+      // Reader fell behind; the decoder resyncs on the next start byte.
+      dropped_ += len - i;
+      break;
+    }
+    ring_[head & (kRingSize - 1)] = data[i];
+    head++;
+  }
+  head_.store(head, std::memory_order_release);
+  TaskHandle_t reader = reader_.load(std::memory_order_acquire);
+  if (reader) xTaskNotifyGive(reader);
+}
+
+size_t BleNusTransport::write(const uint8_t *data, size_t len) {
+  if (!is_connected() || !data) return 0;
+  // One ATT write carries at most MTU - 3 bytes.
+  const size_t chunk = (client_->getMTU() > 3) ? client_->getMTU() - 3 : 20;
+  size_t sent = 0;
+  while (sent < len) {
+    size_t n = (len - sent < chunk) ? (len - sent) : chunk;
+    bool ok = rx_chr_->writeValue(data + sent, n, !write_no_rsp_);
+    ble_link_note_tx(BLE_LINK_VESC, ok);
+    if (!ok) break;
+    sent += n;
+  }
+  return sent;
+}
+
+size_t BleNusTransport::read(uint8_t *data, size_t cap, uint32_t timeout_ms) {
+  reader_.store(xTaskGetCurrentTaskHandle(), std::memory_order_release);
+  uint32_t tail = tail_.load(std::memory_order_relaxed);
+  if (head_.load(std::memory_order_acquire) == tail) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms));
+  }
+  const uint32_t head = head_.load(std::memory_order_acquire);
+  size_t n = 0;
+  while (n < cap && tail != head) {
+    data[n++] = ring_[tail & (kRingSize - 1)];
+    tail++;
+  }
+  tail_.store(tail, std::memory_order_release);
+  return n;
+}
+
+void BleNusTransport::discard_input() {
+  tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+}  // namespace vesc
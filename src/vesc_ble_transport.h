@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+#include <NimBLEDevice.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "vesc_uart_client.h"
+
+namespace vesc {
+
+// Nordic UART service as exposed by the VESC BLE module / VESC Express.
+static constexpr const char *kNusServiceUuid = "6e400001-b5a3-f393-e0a9-e50e24dcca9e";
+static constexpr const char *kNusRxCharUuid = "6e400002-b5a3-f393-e0a9-e50e24dcca9e";  // we write
+static constexpr const char *kNusTxCharUuid = "6e400003-b5a3-f393-e0a9-e50e24dcca9e";  // notifies
+
+// vesc::Transport over a NUS link, so the same poller runs over UART or BLE.
+// Notifications land in a single-producer/single-consumer ring (NimBLE host
+// task -> poll task) and wake the reader with a task notification.
+class BleNusTransport : public Transport {
+ public:
+  bool connect(const NimBLEAddress &addr);
+  void disconnect();
+  bool is_connected() const;
+
+  size_t write(const uint8_t *data, size_t len) override;
+  size_t read(uint8_t *data, size_t cap, uint32_t timeout_ms) override;
+  void discard_input() override;
+  uint32_t now_ms() override { return millis(); }
+
+ private:
+  static constexpr size_t kRingSize = 512;  // power of two
+
+  NimBLEClient *client_ = nullptr;
+  NimBLERemoteCharacteristic *rx_chr_ = nullptr;
+  bool write_no_rsp_ = true;
+  std::atomic<uint32_t> head_{0};  // written by the host task
+  std::atomic<uint32_t> tail_{0};  // written by the reader
+  std::atomic<TaskHandle_t> reader_{nullptr};
+  uint32_t dropped_ = 0;
+  uint8_t ring_[kRingSize];
+
+  void on_notify_(const uint8_t *data, size_t len);
+};
+
+}  // namespace vesc
@@ -0,0 +1,302 @@
+#include "vesc_module.h"
+#include "vesc_uart_client.h"
+#include "vesc_ble_transport.h"
+#include "ble_links.h"
+#include "telemetry_hub.h"
+#include "telemetry_model.h"
+#include "ui_msg_queue.h"
+#include "ui_update_sched.h"
+#include "usb_stream.h"
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <Preferences.h>
+#include <math.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static constexpr uint32_t kLinkTimeoutMs = 1000;   // no reply for this long = disconnected / stale
+static constexpr uint32_t kOdoSaveStepM = 1000;    // NVS write granularity
+static constexpr uint32_t kBleRetryMs = 2000;
+static_assert(VESC_MAX_CAN_NODES == vesc::kMaxCanNodes, "node tables out of sync");
+
+// HardwareSerial as a vesc::Transport. Waits in 1-tick sleeps so the poll
+// task yields while the reply is on the wire.
+class SerialTransport : public vesc::Transport {
+ public:
+  explicit SerialTransport(HardwareSerial &s) : s_(s) {}
+
+  size_t write(const uint8_t *data, size_t len) override { return s_.write(data, len); }
+
+  size_t read(uint8_t *data, size_t cap, uint32_t timeout_ms) override {
+    const uint32_t start = millis();
+    while (s_.available() <= 0) {
+      if (millis() - start >= timeout_ms) return 0;
+      vTaskDelay(1);
+    }
+    size_t n = 0;
+    while (n < cap && s_.available() > 0) data[n++] = (uint8_t)s_.read();
+    return n;
+  }
+
+  void discard_input() override {
+    while (s_.available() > 0) s_.read();
+  }
+
+  uint32_t now_ms() override { return millis(); }
+
+ private:
+  HardwareSerial &s_;
+};
+
+static vesc_module_config_t s_cfg;
+static bool s_inited = false;
+static SerialTransport s_serial(Serial1);
+static vesc::BleNusTransport s_ble;
+static vesc::VescUartClient *s_client = nullptr;
+static TaskHandle_t s_task = nullptr;
+static int s_ch_dash = -1;
+static uint16_t s_trace_round;
+
+// Last reply per node, kept across rounds so a missed reply only ages it.
+static vesc::Values s_node_values[VESC_MAX_NODES];
+static uint32_t s_node_ok_ms[VESC_MAX_NODES];
+
+// Odometer: persisted total + distance since the controller's tach_abs baseline.
+static uint32_t s_odo_base_m = 0;
+static uint32_t s_odo_saved_m = 0;
+static int32_t s_tach_base = 0;
+static int32_t s_tach_last = 0;
+static bool s_tach_valid = false;
+
+static uint32_t load_odometer()
+{
+    Preferences prefs;
+    if (!prefs.begin("vesc", true)) return 0;
+    uint32_t m = prefs.getUInt("odo_m", 0);
+    prefs.end();
+    return m;
+}
+
+static void save_odometer(uint32_t m)
+{
+    Preferences prefs;
+    if (!prefs.begin("vesc", false)) return;
+    prefs.putUInt("odo_m", m);
+    prefs.end();
+}
+
+// erpm -> km/h: / pole pairs = motor rpm, / gear = wheel rpm, * circumference.
+static int32_t speed_dkmh(int32_t erpm)
+{
+    float pole_pairs = s_cfg.motor_poles / 2.0f;
+    float wheel_rpm = erpm / pole_pairs / s_cfg.gear_ratio;
+    float kmh = wheel_rpm * (float)M_PI * s_cfg.wheel_diameter_mm * 60.0f / 1e6f;
+    return (int32_t)lroundf(fabsf(kmh) * 10.0f);
+}
+
+// The controller counts 6 tach steps per electrical turn, i.e. 3 * poles per motor turn.
+static uint32_t tach_to_m(uint32_t steps)
+{
+    float motor_turns = steps / (3.0f * s_cfg.motor_poles);
+    float wheel_turns = motor_turns / s_cfg.gear_ratio;
+    return (uint32_t)(wheel_turns * (float)M_PI * s_cfg.wheel_diameter_mm / 1000.0f);
+}
+
+static uint32_t update_odometer(int32_t tach_abs)
+{
+    // tach_abs restarts at 0 when the controller reboots: fold the distance
+    // up to the last reading into the base (the saved value lags it by up to
+    // kOdoSaveStepM), persist it and start over from the new value.
+    if (!s_tach_valid || tach_abs < s_tach_base) {
+        if (s_tach_valid) {
+            s_odo_base_m += tach_to_m((uint32_t)(s_tach_last - s_tach_base));
+            if (s_odo_base_m != s_odo_saved_m) {
+                s_odo_saved_m = s_odo_base_m;
+                save_odometer(s_odo_base_m);
+            }
+        }
+        s_tach_base = tach_abs;
+        s_tach_valid = true;
+    }
+    s_tach_last = tach_abs;
+    uint32_t total = s_odo_base_m + tach_to_m((uint32_t)(tach_abs - s_tach_base));
+    if (total >= s_odo_saved_m + kOdoSaveStepM) {
+        s_odo_saved_m = total;
+        save_odometer(total);
+    }
+    return total;
+}
+
+static vesc_snapshot_t build_snapshot(uint32_t now, uint32_t got)
+{
+    vesc_snapshot_t snap = {};
+    snap.connected = true;
+    snap.sample_ms = now;
+    snap.round_ms = s_client->stats().last_round_ms;
+    snap.node_count = 1 + s_cfg.can_count;
+    snap.temp_motor_dc = INT16_MIN;
+    snap.temp_fet_dc = INT16_MIN;
+
+    for (int i = 0; i < snap.node_count; i++) {
+        const vesc::Values &v = s_node_values[i];
+        vesc_node_t &n = snap.nodes[i];
+        n.controller_id = (i == 0) ? v.controller_id : s_cfg.can_ids[i - 1];
+        n.fresh = (got & (1u << i)) != 0;
+        n.age_ms = (s_node_ok_ms[i] != 0) ? now - s_node_ok_ms[i] : UINT32_MAX;
+        n.speed_dkmh = speed_dkmh(v.erpm);
+        // dV * cA = mW
+        n.power_w = (int32_t)(((int64_t)v.v_in_dv * v.current_in_ca) / 1000);
+        n.current_motor_ca = v.current_motor_ca;
+        n.current_in_ca = v.current_in_ca;
+        n.temp_motor_dc = v.temp_motor_dc;
+        n.temp_fet_dc = v.temp_fet_dc;
+        n.duty_pm = v.duty_pm;
+        n.fault = v.fault;
+        if (n.age_ms >= kLinkTimeoutMs) continue;
+
+        // Each controller measures its own input current, so pack power is the sum.
+        snap.power_w += n.power_w;
+        snap.current_in_ca += n.current_in_ca;
+        if (n.temp_motor_dc > snap.temp_motor_dc) snap.temp_motor_dc = n.temp_motor_dc;
+        if (n.temp_fet_dc > snap.temp_fet_dc) snap.temp_fet_dc = n.temp_fet_dc;
+        if (snap.fault == 0) snap.fault = n.fault;
+    }
+
+    const vesc::Values &local = s_node_values[0];
+    snap.speed_dkmh = snap.nodes[0].speed_dkmh;
+    snap.v_in_dv = local.v_in_dv;
+    snap.duty_pm = local.duty_pm;
+    snap.odometer_m = (local.mask & vesc::kMaskTachAbs) ? update_odometer(local.tachometer_abs) : s_odo_saved_m;
+    return snap;
+}
+
+static void publish_disconnected()
+{
+    vesc_snapshot_t snap = {};
+    hub_peek(HUB_CH_VESC, &snap, nullptr);
+    snap.connected = false;
+    hub_publish(HUB_CH_VESC, &snap, millis());
+}
+
+static void poll_task(void *)
+{
+    const TickType_t period = pdMS_TO_TICKS(1000 / s_cfg.poll_hz);
+    const uint32_t reply_timeout_ms = (1000 / s_cfg.poll_hz) * 3 / 4;
+    TickType_t wake = xTaskGetTickCount();
+    uint32_t last_ok_ms = 0;
+    uint32_t last_ble_try_ms = 0;
+    bool connected = false;
+    const bool ble = s_cfg.link == VESC_LINK_BLE;
+    const NimBLEAddress ble_addr(std::string(s_cfg.ble_mac));
+
+    for (;;) {
+        vTaskDelayUntil(&wake, period > 0 ? period : 1);
+
+        if (ble && !s_ble.is_connected()) {
+            if (connected) {
+                connected = false;
+                publish_disconnected();
+            }
+            // Connecting blocks this task only; the BMS link keeps running.
+            const uint32_t t = millis();
+            if (last_ble_try_ms != 0 && t - last_ble_try_ms < kBleRetryMs) continue;
+            last_ble_try_ms = t;
+            if (!s_ble.connect(ble_addr)) continue;
+            wake = xTaskGetTickCount();
+        }
+
+        vesc::Values round[VESC_MAX_NODES];
+        const uint32_t now = millis();
+        const uint32_t t0_us = micros();
+        const uint32_t got = s_client->poll_round(s_cfg.can_ids, s_cfg.can_count, round,
+                                                  reply_timeout_ms > 0 ? reply_timeout_ms : 1);
+        usb_trace(s_trace_round, t0_us, micros() - t0_us);
+        for (int i = 0; i <= s_cfg.can_count; i++) {
+            if (got & (1u << i)) {
+                s_node_values[i] = round[i];
+                s_node_ok_ms[i] = now;
+            }
+        }
+        if (got & 1u) {
+            if (ble) ble_link_note_rtt(BLE_LINK_VESC, s_client->stats().last_rtt_ms * 1000);
+            last_ok_ms = now;
+            connected = true;
+            vesc_snapshot_t snap = build_snapshot(now, got);
+            hub_publish(HUB_CH_VESC, &snap, now);
+        } else if (connected && now - last_ok_ms >= kLinkTimeoutMs) {
+            connected = false;
+            publish_disconnected();
+        }
+    }
+}
+
+// Scheduler channel (LVGL thread): quantize the latest snapshot into subjects.
+static void apply_dash(void *)
+{
+    vesc_snapshot_t snap;
+    if (!hub_peek(HUB_CH_VESC, &snap, nullptr)) return;
+    telem_publish_int(TELEM_ODO_KM, (int32_t)(snap.odometer_m / 1000));
+    if (!snap.connected) {
+        telem_reset_vesc();
+        return;
+    }
+    telem_publish_int(TELEM_SPEED_DKMH, snap.speed_dkmh);
+    telem_publish_int(TELEM_POWER_W, snap.power_w);
+    telem_publish_int(TELEM_MOTOR_TEMP_DC, snap.temp_motor_dc);
+    telem_publish_int(TELEM_FET_TEMP_DC, snap.temp_fet_dc);
+}
+
+void vesc_module_default_config(vesc_module_config_t *cfg)
+{
+    if (!cfg) return;
+    cfg->link = VESC_LINK_UART;
+    cfg->ble_mac[0] = '\0';
+    cfg->rx_pin = -1;
+    cfg->tx_pin = -1;
+    cfg->baud = 115200;
+    cfg->poll_hz = 50;
+    cfg->core = 0;
+    cfg->motor_poles = 14;
+    cfg->wheel_diameter_mm = 254.0f;
+    cfg->gear_ratio = 1.0f;
+    cfg->can_count = 0;
+}
+
+void vesc_module_init(const vesc_module_config_t *cfg)
+{
+    if (s_inited || !cfg) return;
+    s_inited = true;
+    s_cfg = *cfg;
+    if (s_cfg.poll_hz < 1) s_cfg.poll_hz = 1;
+    if (s_cfg.poll_hz > 50) s_cfg.poll_hz = 50;
+    if (s_cfg.motor_poles < 2) s_cfg.motor_poles = 2;
+    if (!(s_cfg.gear_ratio > 0.0f)) s_cfg.gear_ratio = 1.0f;
+    if (s_cfg.can_count > VESC_MAX_CAN_NODES) s_cfg.can_count = VESC_MAX_CAN_NODES;
+
+    telem_init();
+    s_odo_base_m = s_odo_saved_m = load_odometer();
+    telem_publish_int(TELEM_ODO_KM, (int32_t)(s_odo_base_m / 1000));
+
+    hub_channel_init(HUB_CH_VESC, sizeof(vesc_snapshot_t), 16, UI_TELEM_SRC_VESC);
+    s_trace_round = usb_trace_register("vesc_round");
+    s_ch_dash = ui_sched_add_channel("vesc_dash", apply_dash, nullptr, 25, UI_SCHED_CHEAP);
+    ui_sched_set_channel_sources(s_ch_dash, UI_TELEM_SRC_VESC);
+
+    if (s_cfg.link == VESC_LINK_BLE) {
+        static vesc::VescUartClient ble_client(s_ble);
+        s_client = &ble_client;
+    } else {
+        static vesc::VescUartClient uart_client(s_serial);
+        s_client = &uart_client;
+        Serial1.setRxBufferSize(256);
+        Serial1.begin(s_cfg.baud, SERIAL_8N1, s_cfg.rx_pin, s_cfg.tx_pin);
+    }
+    xTaskCreatePinnedToCore(poll_task, "vesc_poll", 4096, nullptr, 2, &s_task, s_cfg.core);
+}
+
+bool vesc_module_get_snapshot(vesc_snapshot_t *out)
+{
+    if (!out) return false;
+    return hub_peek(HUB_CH_VESC, out, nullptr);
+}
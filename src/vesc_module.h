@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    VESC_LINK_UART = 0,
+    VESC_LINK_BLE,                // Nordic UART service, alongside the BMS link
+} vesc_link_t;
+
+#define VESC_MAX_CAN_NODES 3
+#define VESC_MAX_NODES (1 + VESC_MAX_CAN_NODES)
+
+typedef struct {
+    vesc_link_t link;
+    char ble_mac[24];             // "AA:BB:CC:DD:EE:FF" for VESC_LINK_BLE
+    int8_t rx_pin;
+    int8_t tx_pin;
+    uint32_t baud;
+    uint16_t poll_hz;             // clamped to 1..50
+    uint8_t core;                 // core the poll task is pinned to
+    uint8_t motor_poles;          // magnets, not pole pairs
+    float wheel_diameter_mm;
+    float gear_ratio;             // motor turns per wheel turn
+    uint8_t can_ids[VESC_MAX_CAN_NODES];  // controllers behind COMM_FORWARD_CAN
+    uint8_t can_count;
+} vesc_module_config_t;
+
+// One controller. Node 0 is the one on our end of the link.
+typedef struct {
+    uint8_t controller_id;
+    bool fresh;                   // answered in the latest round
+    uint32_t age_ms;              // since its last reply, at sample time
+    int32_t speed_dkmh;
+    int32_t power_w;
+    int32_t current_motor_ca;     // 0.01 A
+    int32_t current_in_ca;
+    int16_t temp_motor_dc;
+    int16_t temp_fet_dc;
+    int16_t duty_pm;
+    uint8_t fault;
+} vesc_node_t;
+
+// Latest converted sample, as published to the UI. Aggregates cover every
+// node that answered within the staleness limit.
+typedef struct {
+    bool connected;
+    uint32_t sample_ms;
+    uint32_t round_ms;            // request burst -> last reply
+    int32_t speed_dkmh;           // 0.1 km/h, from node 0
+    int32_t power_w;              // sum over nodes
+    int16_t temp_motor_dc;        // 0.1 degC, hottest motor
+    int16_t temp_fet_dc;          // hottest controller
+    int16_t v_in_dv;              // 0.1 V
+    int32_t current_in_ca;        // 0.01 A, sum over nodes
+    int16_t duty_pm;              // 0.1 %, node 0
+    uint8_t fault;                // first non-zero fault code
+    uint32_t odometer_m;
+    uint8_t node_count;
+    vesc_node_t nodes[VESC_MAX_NODES];
+} vesc_snapshot_t;
+
+void vesc_module_default_config(vesc_module_config_t *cfg);
+
+// Open the link and start the poll task. Call from the LVGL thread after
+// ui_sched_init() (and NimBLEDevice::init() for VESC_LINK_BLE); UI updates
+// go through the telemetry message queue.
+void vesc_module_init(const vesc_module_config_t *cfg);
+
+// Safe from any task; false until the first sample arrives.
+bool vesc_module_get_snapshot(vesc_snapshot_t *out);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
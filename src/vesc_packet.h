@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace vesc {
+
+// VESC framing: short packets 0x02 <len:1> payload <crc16:2> 0x03,
+// long packets 0x03 <len:2> payload <crc16:2> 0x03. CRC16-XMODEM over the
+// payload, big-endian. No heap: the decoder owns a fixed payload buffer.
+
+static constexpr uint8_t kStartShort = 0x02;
+static constexpr uint8_t kStartLong = 0x03;
+static constexpr uint8_t kStop = 0x03;
+static constexpr size_t kMaxPayload = 512;
+static constexpr size_t kFrameOverhead = 6;  // long header + crc + stop
+
+uint16_t crc16(const uint8_t *data, size_t len);
+
+// Frame `payload` into `out`. Returns the frame length, 0 if it does not fit.
+size_t encode_packet(const uint8_t *payload, size_t len, uint8_t *out, size_t out_cap);
+
+class PacketDecoder {
+ public:
+  enum class Result : uint8_t {
+    NEED_MORE = 0,
+    PACKET,        // payload() / payload_len() valid until the next push()
+    BAD_CRC,
+    BAD_FRAME,
+  };
+
+  // Feed one byte. On PACKET the payload stays valid until the next push().
+  Result push(uint8_t b);
+  void reset();
+
+  const uint8_t *payload() const { return buf_; }
+  size_t payload_len() const { return len_; }
+
+  uint32_t packets() const { return packets_; }
+  uint32_t crc_errors() const { return crc_errors_; }
+  uint32_t frame_errors() const { return frame_errors_; }
+
+ private:
+  enum class State : uint8_t { START, LEN_HI, LEN_LO, PAYLOAD, CRC_HI, CRC_LO, STOP };
+
+  State state_ = State::START;
+  bool long_ = false;
+  uint16_t len_ = 0;
+  uint16_t pos_ = 0;
+  uint16_t crc_ = 0;
+  uint8_t buf_[kMaxPayload];
+
+  uint32_t packets_ = 0;
+  uint32_t crc_errors_ = 0;
+  uint32_t frame_errors_ = 0;
+};
+
+// Big-endian payload reader with bounds checking; reads past the end
+// return 0 and latch ok() to false.
+class BufferReader {
+ public:
+  BufferReader(const uint8_t *data, size_t len) : data_(data), len_(len) {}
+
+  uint8_t u8();
+  int16_t i16();
+  uint16_t u16();
+  int32_t i32();
+  uint32_t u32();
+
+  size_t remaining() const { return (pos_ < len_) ? (len_ - pos_) : 0; }
+  bool ok() const { return ok_; }
+
+ private:
+  const uint8_t *data_;
+  size_t len_;
+  size_t pos_ = 0;
+  bool ok_ = true;
+
+  bool need_(size_t n);
+};
+
+class BufferWriter {
+ public:
+  BufferWriter(uint8_t *data, size_t cap) : data_(data), cap_(cap) {}
+
+  void u8(uint8_t v);
+  void u16(uint16_t v);
+  void u32(uint32_t v);
+
+  size_t len() const { return pos_; }
+  bool ok() const { return ok_; }
+
+ private:
+  uint8_t *data_;
+  size_t cap_;
+  size_t pos_ = 0;
+  bool ok_ = true;
+};
+
+}  // namespace vesc
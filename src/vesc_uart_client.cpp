@@ -0,0 +1,177 @@
+#include "vesc_uart_client.h"
+
+namespace vesc {
+
+// Firmware older than 3.x ignores COMM_GET_VALUES_SELECTIVE; after this many
+// unanswered selective polls in a row fall back to the full reply.
+static constexpr uint8_t kSelectiveMissLimit = 3;
+// The misses may also have been a controller that wasn't up yet or a link
+// drop, so selective is probed again once the link comes back, and every
+// this many answered full polls (a single miss falls back again).
+static constexpr uint16_t kSelectiveRetryPolls = 500;
+
+bool VescUartClient::send_(const uint8_t *payload, size_t len) {
+  size_t n = encode_packet(payload, len, tx_, sizeof(tx_));
+  if (n == 0) return false;
+  return io_.write(tx_, n) == n;
+}
+
+bool VescUartClient::wait_reply_(uint8_t cmd, uint32_t timeout_ms) {
+  const uint32_t start = io_.now_ms();
+  for (;;) {
+    // Bytes after a completed packet stay in rx_ for the next call: in a
+    // pipelined round they are the start of the next reply.
+    while (rx_pos_ < rx_len_) {
+      switch (dec_.push(rx_[rx_pos_++])) {
+        case PacketDecoder::Result::PACKET:
+          // Anything else is a stale reply to an earlier request.
+          if (dec_.payload_len() > 0 && dec_.payload()[0] == cmd) return true;
+          break;
+        case PacketDecoder::Result::BAD_CRC:
+          stats_.crc_errors++;
+          break;
+        case PacketDecoder::Result::BAD_FRAME:
+          stats_.frame_errors++;
+          break;
+        case PacketDecoder::Result::NEED_MORE:
+          break;
+      }
+    }
+    uint32_t elapsed = io_.now_ms() - start;
+    if (elapsed >= timeout_ms) return false;
+    rx_len_ = io_.read(rx_, sizeof(rx_), timeout_ms - elapsed);
+    rx_pos_ = 0;
+  }
+}
+
+bool VescUartClient::use_selective_() const {
+  return mask_ != 0 && selective_misses_ < kSelectiveMissLimit;
+}
+
+void VescUartClient::note_reply_(bool selective, bool answered) {
+  if (selective) {
+    selective_misses_ = answered ? 0 : selective_misses_ + 1;
+    full_replies_ = 0;
+    link_lost_ = false;
+    return;
+  }
+  if (!answered) {
+    link_lost_ = true;
+    return;
+  }
+  if (link_lost_) {
+    link_lost_ = false;
+    selective_misses_ = 0;
+  } else if (++full_replies_ >= kSelectiveRetryPolls) {
+    full_replies_ = 0;
+    selective_misses_ = kSelectiveMissLimit - 1;
+  }
+}
+
+void VescUartClient::reset_rx_() {
+  io_.discard_input();
+  dec_.reset();
+  rx_pos_ = rx_len_ = 0;
+}
+
+uint32_t VescUartClient::poll_round(const uint8_t *can_ids, int can_count, Values *out, uint32_t timeout_ms) {
+  if (!out) return 0;
+  if (can_count < 0 || !can_ids) can_count = 0;
+  if (can_count > kMaxCanNodes) can_count = kMaxCanNodes;
+
+  // Replies only identify themselves through controller_id, so a round
+  // always asks for it.
+  const bool selective = use_selective_();
+  const uint8_t cmd = selective ? kCommGetValuesSelective : kCommGetValues;
+
+  reset_rx_();
+
+  // All requests go out in a single write.
+  size_t pos = 0;
+  for (int node = 0; node <= can_count; node++) {
+    uint8_t req[12];
+    size_t len = selective ? build_get_values_selective(mask_ | kMaskControllerId, req + 2, sizeof(req) - 2)
+                           : build_get_values(req + 2, sizeof(req) - 2);
+    const uint8_t *payload = req + 2;
+    if (node > 0) {
+      len = wrap_forward_can(can_ids[node - 1], req + 2, len, req, sizeof(req));
+      payload = req;
+    }
+    size_t n = encode_packet(payload, len, tx_ + pos, sizeof(tx_) - pos);
+    if (n == 0) return 0;
+    pos += n;
+  }
+
+  const uint32_t t0 = io_.now_ms();
+  const uint32_t all = (1u << (can_count + 1)) - 1;
+  uint32_t got = 0;
+  stats_.requests += can_count + 1;
+  if (io_.write(tx_, pos) != pos) return 0;
+
+  while (got != all) {
+    uint32_t elapsed = io_.now_ms() - t0;
+    if (elapsed >= timeout_ms || !wait_reply_(cmd, timeout_ms - elapsed)) break;
+    Values v;
+    if (!decode_values(dec_.payload(), dec_.payload_len(), &v)) {
+      stats_.frame_errors++;
+      continue;
+    }
+    int node = 0;
+    if (v.mask & kMaskControllerId) {
+      node = -1;
+      for (int i = 0; i < can_count; i++) {
+        if (can_ids[i] == v.controller_id) node = 1 + i;
+      }
+      if (node < 0) {
+        // Not a forwarded id, so it's the controller on our end of the wire.
+        if (local_id_ < 0) local_id_ = v.controller_id;
+        node = (v.controller_id == local_id_) ? 0 : -1;
+      }
+    }
+    if (node < 0) continue;
+    if (node == 0) stats_.last_rtt_ms = io_.now_ms() - t0;
+    out[node] = v;
+    got |= 1u << node;
+  }
+
+  stats_.timeouts += __builtin_popcount(all & ~got);
+  stats_.replies += __builtin_popcount(got);
+  note_reply_(selective, got != 0);
+  if (got == all) stats_.last_round_ms = io_.now_ms() - t0;
+  dec_.reset();
+  return got;
+}
+
+bool VescUartClient::poll_values(Values *out, uint32_t timeout_ms) {
+  if (!out) return false;
+
+  const bool selective = use_selective_();
+  uint8_t req[8];
+  size_t req_len = selective ? build_get_values_selective(mask_, req, sizeof(req))
+                             : build_get_values(req, sizeof(req));
+  const uint8_t cmd = selective ? kCommGetValuesSelective : kCommGetValues;
+
+  // Start every exchange from a clean line so a late reply can't be
+  // mistaken for this one.
+  reset_rx_();
+
+  const uint32_t t0 = io_.now_ms();
+  stats_.requests++;
+  if (!send_(req, req_len) || !wait_reply_(cmd, timeout_ms)) {
+    stats_.timeouts++;
+    note_reply_(selective, false);
+    dec_.reset();
+    return false;
+  }
+  stats_.last_rtt_ms = io_.now_ms() - t0;
+
+  if (!decode_values(dec_.payload(), dec_.payload_len(), out)) {
+    stats_.frame_errors++;
+    return false;
+  }
+  note_reply_(selective, true);
+  stats_.replies++;
+  return true;
+}
+
+}  // namespace vesc
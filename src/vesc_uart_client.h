@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vesc_packet.h"
+#include "vesc_values.h"
+
+namespace vesc {
+
+// Byte pipe to the controller. The firmware wraps a HardwareSerial; a host
+// build can wrap a pseudo-terminal with a scripted controller on the other end.
+class Transport {
+ public:
+  virtual ~Transport() = default;
+  virtual size_t write(const uint8_t *data, size_t len) = 0;
+  // Read up to `cap` bytes, waiting at most `timeout_ms` for the first one.
+  virtual size_t read(uint8_t *data, size_t cap, uint32_t timeout_ms) = 0;
+  virtual void discard_input() = 0;
+  virtual uint32_t now_ms() = 0;
+};
+
+struct ClientStats {
+  uint32_t requests = 0;
+  uint32_t replies = 0;
+  uint32_t timeouts = 0;
+  uint32_t crc_errors = 0;
+  uint32_t frame_errors = 0;
+  uint32_t last_rtt_ms = 0;
+  uint32_t last_round_ms = 0;   // first request -> last reply of a round
+};
+
+// Local controller plus up to this many CAN-forwarded ones per round.
+static constexpr int kMaxCanNodes = 3;
+
+// Request/response poller for COMM_GET_VALUES(_SELECTIVE). Not thread-safe;
+// owned by one task. No heap: frames are built and parsed in member buffers.
+class VescUartClient {
+ public:
+  explicit VescUartClient(Transport &transport) : io_(transport) {}
+
+  // 0 selects the full COMM_GET_VALUES reply.
+  void set_selective_mask(uint32_t mask) { mask_ = mask; }
+  uint32_t selective_mask() const { return mask_; }
+
+  bool poll_values(Values *out, uint32_t timeout_ms);
+
+  // Pipelined round: one request for the local controller and one
+  // COMM_FORWARD_CAN request per id, written back to back. Replies are
+  // matched to nodes by their controller_id field as they arrive, so the
+  // round costs one round trip, not one per node. out[0] is the local
+  // controller, out[1 + i] is can_ids[i]. Returns a bitmask of the nodes
+  // that answered (bit 0 = local).
+  uint32_t poll_round(const uint8_t *can_ids, int can_count, Values *out, uint32_t timeout_ms);
+
+  const ClientStats &stats() const { return stats_; }
+
+ private:
+  bool send_(const uint8_t *payload, size_t len);
+  bool wait_reply_(uint8_t cmd, uint32_t timeout_ms);
+  void reset_rx_();
+  bool use_selective_() const;
+  void note_reply_(bool selective, bool answered);
+
+  Transport &io_;
+  PacketDecoder dec_;
+  uint32_t mask_ = kMaskDashboard;
+  uint8_t selective_misses_ = 0;
+  uint16_t full_replies_ = 0;  // answered full polls since falling back
+  bool link_lost_ = false;     // a full poll went unanswered too
+  int16_t local_id_ = -1;      // learned from the first unforwarded reply
+  ClientStats stats_;
+  uint8_t tx_[16 * (1 + kMaxCanNodes)];
+  uint8_t rx_[64];
+  size_t rx_pos_ = 0;
+  size_t rx_len_ = 0;
+};
+
+}  // namespace vesc
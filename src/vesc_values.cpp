@@ -0,0 +1,92 @@
+#include "vesc_values.h"
+#include "vesc_packet.h"
+
+#include <string.h>
+
+namespace vesc {
+
+namespace {
+
+// Fields are laid out in mask-bit order in both replies; the full reply
+// simply has every bit up to vq set.
+void read_fields(BufferReader &r, uint32_t mask, Values *v) {
+  if (mask & kMaskTempFet) v->temp_fet_dc = r.i16();
+  if (mask & kMaskTempMotor) v->temp_motor_dc = r.i16();
+  if (mask & kMaskCurrentMotor) v->current_motor_ca = r.i32();
+  if (mask & kMaskCurrentIn) v->current_in_ca = r.i32();
+  if (mask & kMaskId) v->id_ca = r.i32();
+  if (mask & kMaskIq) v->iq_ca = r.i32();
+  if (mask & kMaskDuty) v->duty_pm = r.i16();
+  if (mask & kMaskRpm) v->erpm = r.i32();
+  if (mask & kMaskVIn) v->v_in_dv = r.i16();
+  if (mask & kMaskAh) v->amp_hours_e4 = r.i32();
+  if (mask & kMaskAhCharged) v->amp_hours_charged_e4 = r.i32();
+  if (mask & kMaskWh) v->watt_hours_e4 = r.i32();
+  if (mask & kMaskWhCharged) v->watt_hours_charged_e4 = r.i32();
+  if (mask & kMaskTach) v->tachometer = r.i32();
+  if (mask & kMaskTachAbs) v->tachometer_abs = r.i32();
+  if (mask & kMaskFault) v->fault = r.u8();
+  if (mask & kMaskPidPos) v->pid_pos_e6 = r.i32();
+  if (mask & kMaskControllerId) v->controller_id = r.u8();
+  if (mask & kMaskTempMos) {
+    for (int i = 0; i < 3; i++) v->temp_mos_dc[i] = r.i16();
+  }
+  if (mask & kMaskVd) v->vd_mv = r.i32();
+  if (mask & kMaskVq) v->vq_mv = r.i32();
+}
+
+}  // namespace
+
+bool decode_values(const uint8_t *payload, size_t len, Values *out) {
+  if (!payload || !out || len < 1) return false;
+  BufferReader r(payload + 1, len - 1);
+  uint32_t mask;
+  if (payload[0] == kCommGetValues) {
+    // Older firmware stops early; take what is there, field by field.
+    mask = 0;
+    Values v;
+    for (uint32_t bit = 1; bit <= kMaskVq; bit <<= 1) {
+      BufferReader probe = r;
+      read_fields(probe, bit, &v);
+      if (!probe.ok()) break;
+      r = probe;
+      mask |= bit;
+    }
+    if (mask == 0) return false;
+    v.mask = mask;
+    *out = v;
+    return true;
+  }
+  if (payload[0] != kCommGetValuesSelective) return false;
+
+  mask = r.u32();
+  Values v;
+  read_fields(r, mask, &v);
+  if (!r.ok()) return false;
+  v.mask = mask;
+  *out = v;
+  return true;
+}
+
+size_t build_get_values(uint8_t *out, size_t cap) {
+  BufferWriter w(out, cap);
+  w.u8(kCommGetValues);
+  return w.ok() ? w.len() : 0;
+}
+
+size_t build_get_values_selective(uint32_t mask, uint8_t *out, size_t cap) {
+  BufferWriter w(out, cap);
+  w.u8(kCommGetValuesSelective);
+  w.u32(mask);
+  return w.ok() ? w.len() : 0;
+}
+
+size_t wrap_forward_can(uint8_t can_id, const uint8_t *inner, size_t len, uint8_t *out, size_t cap) {
+  if (!inner || !out || len + 2 > cap) return 0;
+  memmove(out + 2, inner, len);
+  out[0] = kCommForwardCan;
+  out[1] = can_id;
+  return len + 2;
+}
+
+}  // namespace vesc
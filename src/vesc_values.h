@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace vesc {
+
+static constexpr uint8_t kCommGetValues = 4;
+static constexpr uint8_t kCommForwardCan = 34;
+static constexpr uint8_t kCommGetValuesSelective = 50;
+
+// COMM_GET_VALUES_SELECTIVE field mask, in wire order.
+enum ValuesMask : uint32_t {
+  kMaskTempFet = 1u << 0,
+  kMaskTempMotor = 1u << 1,
+  kMaskCurrentMotor = 1u << 2,
+  kMaskCurrentIn = 1u << 3,
+  kMaskId = 1u << 4,
+  kMaskIq = 1u << 5,
+  kMaskDuty = 1u << 6,
+  kMaskRpm = 1u << 7,
+  kMaskVIn = 1u << 8,
+  kMaskAh = 1u << 9,
+  kMaskAhCharged = 1u << 10,
+  kMaskWh = 1u << 11,
+  kMaskWhCharged = 1u << 12,
+  kMaskTach = 1u << 13,
+  kMaskTachAbs = 1u << 14,
+  kMaskFault = 1u << 15,
+  kMaskPidPos = 1u << 16,
+  kMaskControllerId = 1u << 17,
+  kMaskTempMos = 1u << 18,
+  kMaskVd = 1u << 19,
+  kMaskVq = 1u << 20,
+};
+
+// What the dashboard needs at full rate.
+static constexpr uint32_t kMaskDashboard = kMaskTempFet | kMaskTempMotor | kMaskCurrentMotor |
+                                           kMaskCurrentIn | kMaskDuty | kMaskRpm | kMaskVIn |
+                                           kMaskTachAbs | kMaskFault;
+
+// Values exactly as the controller sends them (fixed point, no floats).
+struct Values {
+  uint32_t mask = 0;            // fields present in this sample
+  int16_t temp_fet_dc = 0;      // 0.1 degC
+  int16_t temp_motor_dc = 0;    // 0.1 degC
+  int32_t current_motor_ca = 0; // 0.01 A
+  int32_t current_in_ca = 0;    // 0.01 A
+  int32_t id_ca = 0;            // 0.01 A
+  int32_t iq_ca = 0;            // 0.01 A
+  int16_t duty_pm = 0;          // 0.1 %
+  int32_t erpm = 0;
+  int16_t v_in_dv = 0;          // 0.1 V
+  int32_t amp_hours_e4 = 0;     // 0.0001 Ah
+  int32_t amp_hours_charged_e4 = 0;
+  int32_t watt_hours_e4 = 0;    // 0.0001 Wh
+  int32_t watt_hours_charged_e4 = 0;
+  int32_t tachometer = 0;       // electrical steps (6 per e-rev)
+  int32_t tachometer_abs = 0;
+  uint8_t fault = 0;
+  int32_t pid_pos_e6 = 0;
+  uint8_t controller_id = 0;
+  int16_t temp_mos_dc[3] = {0, 0, 0};
+  int32_t vd_mv = 0;
+  int32_t vq_mv = 0;
+};
+
+// Decode a COMM_GET_VALUES or COMM_GET_VALUES_SELECTIVE reply (payload
+// including the command byte). Returns false on a short or foreign packet.
+bool decode_values(const uint8_t *payload, size_t len, Values *out);
+
+// Build the request payload. Returns its length, 0 if `cap` is too small.
+size_t build_get_values(uint8_t *out, size_t cap);
+size_t build_get_values_selective(uint32_t mask, uint8_t *out, size_t cap);
+
+// Wrap `len` bytes at `inner` as COMM_FORWARD_CAN to `can_id`. `inner` may
+// alias `out`; the command is shifted in place.
+size_t wrap_forward_can(uint8_t can_id, const uint8_t *inner, size_t len, uint8_t *out, size_t cap);
+
+}  // namespace vesc
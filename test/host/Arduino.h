@@ -0,0 +1,15 @@
+#pragma once
+
+// Host stand-in for the bits of the Arduino core the tested modules use.
+// Time is a counter the test advances, so runs are repeatable.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+inline uint32_t g_host_ms = 0;
+
+static inline uint32_t millis(void) { return g_host_ms; }
+static inline uint32_t micros(void) { return g_host_ms * 1000u; }
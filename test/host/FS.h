@@ -0,0 +1,153 @@
+#pragma once
+
+// Host stand-in for the Arduino FS API over an in-memory file system.
+// Sizes are counted in 4 KB blocks like LittleFS. Writes come up short
+// once total_bytes is used, or earlier with write_budget to simulate a
+// failing flash.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+struct RamFsState {
+    std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+    size_t total_bytes = 1024 * 1024;
+    size_t block_bytes = 4096;
+    long write_budget = -1;    // bytes the next writes may store, -1 = unlimited
+    uint32_t flushes = 0;
+};
+
+inline RamFsState g_ramfs;
+
+inline size_t ram_blocks(size_t bytes)
+{
+    return (bytes + g_ramfs.block_bytes - 1) / g_ramfs.block_bytes * g_ramfs.block_bytes;
+}
+
+inline size_t ram_used_bytes()
+{
+    size_t used = 0;
+    for (auto &f : g_ramfs.files) used += ram_blocks(f.second->size());
+    return used;
+}
+
+class File {
+public:
+    File() = default;
+
+    size_t write(const uint8_t *data, size_t len)
+    {
+        if (!data_ || dir_) return 0;
+        size_t n = len;
+        if (g_ramfs.write_budget >= 0 && (long)n > g_ramfs.write_budget) n = (size_t)g_ramfs.write_budget;
+        if (g_ramfs.write_budget >= 0) g_ramfs.write_budget -= (long)n;
+        // Whatever the other files leave free.
+        const size_t room = g_ramfs.total_bytes - (ram_used_bytes() - ram_blocks(data_->size()));
+        if (pos_ + n > room) n = pos_ < room ? room - pos_ : 0;
+        if (data_->size() < pos_ + n) data_->resize(pos_ + n);
+        memcpy(data_->data() + pos_, data, n);
+        pos_ += n;
+        return n;
+    }
+
+    size_t read(uint8_t *out, size_t len)
+    {
+        if (!data_ || pos_ >= data_->size()) return 0;
+        size_t n = data_->size() - pos_ < len ? data_->size() - pos_ : len;
+        memcpy(out, data_->data() + pos_, n);
+        pos_ += n;
+        return n;
+    }
+
+    bool seek(uint32_t pos)
+    {
+        if (!data_ || pos > data_->size()) return false;
+        pos_ = pos;
+        return true;
+    }
+
+    size_t position() const { return pos_; }
+    size_t size() const { return data_ ? data_->size() : 0; }
+    void flush() { g_ramfs.flushes++; }
+    void close() { data_.reset(); dir_ = false; }
+    bool isDirectory() { return dir_; }
+    operator bool() const { return data_ != nullptr; }
+
+    // Base name, as the ESP32 core returns it.
+    const char *name() const
+    {
+        const char *slash = strrchr(path_.c_str(), '/');
+        return slash ? slash + 1 : path_.c_str();
+    }
+    const char *path() const { return path_.c_str(); }
+
+    File openNextFile(const char * = FILE_READ)
+    {
+        if (!dir_) return File();
+        const std::string prefix = path_ + "/";
+        auto it = g_ramfs.files.upper_bound(last_);
+        for (; it != g_ramfs.files.end(); ++it) {
+            if (it->first.compare(0, prefix.size(), prefix) != 0) continue;
+            if (it->first.find('/', prefix.size()) != std::string::npos) continue;
+            last_ = it->first;
+            return File(it->first, it->second);
+        }
+        last_ = "\xff";
+        return File();
+    }
+
+private:
+    friend class FS;
+    File(const std::string &path, std::shared_ptr<std::vector<uint8_t>> data) : path_(path), data_(data) {}
+
+    std::string path_;
+    std::shared_ptr<std::vector<uint8_t>> data_;
+    size_t pos_ = 0;
+    bool dir_ = false;
+    std::string last_;
+};
+
+class FS {
+public:
+    File open(const char *path, const char *mode = FILE_READ, bool = false)
+    {
+        auto it = g_ramfs.files.find(path);
+        if (mode[0] == 'r') {
+            if (it != g_ramfs.files.end()) return File(path, it->second);
+            // Directories exist implicitly.
+            File dir(path, std::make_shared<std::vector<uint8_t>>());
+            dir.dir_ = true;
+            return dir;
+        }
+        if (it == g_ramfs.files.end() || mode[0] == 'w') {
+            g_ramfs.files[path] = std::make_shared<std::vector<uint8_t>>();
+            it = g_ramfs.files.find(path);
+        }
+        File f(path, it->second);
+        if (mode[0] == 'a') f.pos_ = it->second->size();
+        return f;
+    }
+
+    bool exists(const char *path) { return g_ramfs.files.count(path) != 0; }
+    bool remove(const char *path) { return g_ramfs.files.erase(path) != 0; }
+    bool mkdir(const char *) { return true; }
+
+    size_t totalBytes() { return g_ramfs.total_bytes; }
+    size_t usedBytes() { return ram_used_bytes(); }
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
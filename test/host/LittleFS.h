@@ -0,0 +1,15 @@
+#pragma once
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    bool begin(bool = false, const char * = "/littlefs", uint8_t = 10, const char * = "spiffs") { return true; }
+    void end() {}
+};
+
+}  // namespace fs
+
+inline fs::LittleFSFS LittleFS;
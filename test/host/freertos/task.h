@@ -0,0 +1,12 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+static inline TickType_t xTaskGetTickCount(void) { return 0; }
+static inline void vTaskDelayUntil(TickType_t *, TickType_t) {}
+static inline void vTaskDelete(TaskHandle_t) {}
+static inline BaseType_t xTaskCreatePinnedToCore(void (*)(void *), const char *, uint32_t, void *, int,
+                                                 TaskHandle_t *, int)
+{
+    return pdPASS;
+}
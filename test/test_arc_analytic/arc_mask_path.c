@@ -0,0 +1,11 @@
+/* The stock mask-based arc renderer, built next to the analytic one as the
+ * reference for test_main.cpp. lv_conf.h is pulled in first so the flag
+ * can be turned off for this copy only. */
+
+#include "lv_conf.h"
+
+#undef LV_DRAW_SW_ARC_ANALYTIC
+#define LV_DRAW_SW_ARC_ANALYTIC 0
+#define lv_draw_sw_arc lv_draw_sw_arc_mask_path
+
+#include "src/draw/sw/lv_draw_sw_arc.c"
@@ -0,0 +1,134 @@
+// LV_DRAW_SW_ARC_ANALYTIC against the stock mask-based arc renderer
+// (arc_mask_path.c), pixel by pixel on an ARGB8888 layer.
+//   pio test -e native -f test_arc_analytic
+//
+// Tolerance: the two paths anti-alias edges differently, and both snap
+// the cap circles to the pixel grid the same way (get_rounded_area()).
+//  - Covered area (sum of alpha) matches within 4 px + 3 %; the slack is
+//    for radius 5-12 arcs and caps that overlap on 1-2 degree arcs.
+//  - Over 2 degrees of arc and of gap: at most kMaxBigDiffs pixels differ
+//    by more than kBigDiff, none by more than kMaxDiff.
+//  - Thinner slivers are where the mask path's angle mask drops coverage,
+//    so there the analytic arc is held to the exact sector area instead
+//    (flat ends, within 1 px + 0.5 %).
+
+#include <unity.h>
+
+#include <lvgl.h>
+#include "src/draw/lv_draw_private.h"
+#include "src/draw/sw/lv_draw_sw.h"
+
+#include <math.h>
+
+extern "C" void lv_draw_sw_arc_mask_path(lv_draw_task_t *t, const lv_draw_arc_dsc_t *dsc, const lv_area_t *coords);
+
+static constexpr int kSize = 260;
+static constexpr int kBigDiff = 64;
+static constexpr int kMaxBigDiffs = 8;
+static constexpr int kMaxDiff = 160;
+
+typedef void (*arc_fn_t)(lv_draw_task_t *, const lv_draw_arc_dsc_t *, const lv_area_t *);
+
+// Static: the LVGL heap in lv_conf.h is too small for it.
+LV_DRAW_BUF_DEFINE_STATIC(s_draw_buf, kSize, kSize, LV_COLOR_FORMAT_ARGB8888);
+static uint8_t s_ref[kSize * kSize];
+static uint8_t s_ana[kSize * kSize];
+
+// Alpha of `dsc` drawn by `fn` into an empty layer.
+static void render(arc_fn_t fn, const lv_draw_arc_dsc_t *dsc, uint8_t *alpha)
+{
+    lv_draw_buf_clear(&s_draw_buf, NULL);
+    lv_layer_t layer = {};
+    layer.draw_buf = &s_draw_buf;
+    layer.color_format = LV_COLOR_FORMAT_ARGB8888;
+    lv_area_set(&layer.buf_area, 0, 0, kSize - 1, kSize - 1);
+
+    lv_draw_task_t t = {};
+    t.type = LV_DRAW_TASK_TYPE_ARC;
+    t.target_layer = &layer;
+    t.clip_area = layer.buf_area;
+    t.draw_dsc = (void *)dsc;
+    lv_area_t coords;
+    lv_area_set(&coords, dsc->center.x - dsc->radius, dsc->center.y - dsc->radius,
+                dsc->center.x + dsc->radius - 1, dsc->center.y + dsc->radius - 1);
+    fn(&t, dsc, &coords);
+
+    for (int y = 0; y < kSize; y++) {
+        const uint8_t *row = (const uint8_t *)lv_draw_buf_goto_xy(&s_draw_buf, 0, y);
+        for (int x = 0; x < kSize; x++) alpha[y * kSize + x] = row[x * 4 + 3];
+    }
+}
+
+static float area_px(const uint8_t *alpha)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < kSize * kSize; i++) sum += alpha[i];
+    return sum / 255.0f;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_matches_mask_path(void)
+{
+    static const int radii[] = {5, 12, 30, 64, 100, 127};
+    static const int widths[] = {1, 3, 8, 20, 200};
+    static const int angles[][2] = {{0, 90}, {10, 20}, {135, 45}, {270, 269}, {300, 60},
+                                    {0, 181}, {45, 225}, {90, 91}, {359, 1}, {200, 340}};
+    int cases = 0;
+    for (int r : radii) {
+        for (int w : widths) {
+            for (const auto &a : angles) {
+                for (int rounded = 0; rounded < 2; rounded++) {
+                    lv_draw_arc_dsc_t dsc;
+                    lv_draw_arc_dsc_init(&dsc);
+                    dsc.color = lv_color_white();
+                    dsc.center.x = kSize / 2;
+                    dsc.center.y = kSize / 2;
+                    dsc.radius = r;
+                    dsc.width = w;
+                    dsc.start_angle = a[0];
+                    dsc.end_angle = a[1];
+                    dsc.rounded = rounded;
+                    render(lv_draw_sw_arc_mask_path, &dsc, s_ref);
+                    render(lv_draw_sw_arc, &dsc, s_ana);
+                    cases++;
+
+                    char msg[96];
+                    snprintf(msg, sizeof(msg), "r %d w %d %d..%d%s", r, w, a[0], a[1], rounded ? " rounded" : "");
+                    const int span = (a[1] - a[0] + 360) % 360;
+                    const float area = area_px(s_ana);
+                    const bool sliver = span <= 2 || span >= 358;
+                    if (sliver && !rounded) {
+                        const float r_in = (float)(w >= r ? 0 : r - w);
+                        const float exact = (float)M_PI * ((float)r * r - r_in * r_in) * span / 360.0f;
+                        TEST_ASSERT_TRUE_MESSAGE(fabsf(area - exact) <= 1.0f + 0.005f * exact, msg);
+                        continue;
+                    }
+                    const float ref_area = area_px(s_ref);
+                    TEST_ASSERT_TRUE_MESSAGE(fabsf(area - ref_area) <= 4.0f + 0.03f * ref_area, msg);
+                    if (sliver) continue;
+
+                    int big = 0, worst = 0;
+                    for (int i = 0; i < kSize * kSize; i++) {
+                        int d = abs((int)s_ref[i] - (int)s_ana[i]);
+                        if (d > kBigDiff) big++;
+                        if (d > worst) worst = d;
+                    }
+                    TEST_ASSERT_TRUE_MESSAGE(big <= kMaxBigDiffs, msg);
+                    TEST_ASSERT_TRUE_MESSAGE(worst <= kMaxDiff, msg);
+                }
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(600, cases);
+}
+
+int main(void)
+{
+    lv_init();
+    LV_DRAW_BUF_INIT_STATIC(s_draw_buf);
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_mask_path);
+    return UNITY_END();
+}
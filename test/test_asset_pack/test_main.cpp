@@ -0,0 +1,247 @@
+// Host test for the asset pack loader: a pack written to a temp file and
+// mmap()ed stands in for the memory-mapped "assets" partition.
+//   pio test -e native -f test_asset_pack
+
+#include <unity.h>
+
+#include "asset_pack.cpp"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+static constexpr int kGlyphW = 8;
+static constexpr int kGlyphH = 8;
+
+// Builds a pack the way extras/asset_pack.py lays it out.
+struct PackBuilder {
+    std::vector<asset_pack_entry_t> entries;
+    std::vector<std::vector<uint8_t>> blobs;
+
+    asset_pack_entry_t &add(const char *name, uint8_t type, std::vector<uint8_t> blob)
+    {
+        asset_pack_entry_t e = {};
+        snprintf(e.name, sizeof(e.name), "%s", name);
+        e.type = type;
+        blob.resize((blob.size() + ASSET_PACK_ALIGN - 1) & ~(size_t)(ASSET_PACK_ALIGN - 1));
+        entries.push_back(e);
+        blobs.push_back(std::move(blob));
+        return entries.back();
+    }
+
+    void image(const char *name, uint16_t w, uint16_t h, uint8_t fill)
+    {
+        asset_pack_entry_t &e = add(name, ASSET_IMAGE, std::vector<uint8_t>((size_t)w * h * 2, fill));
+        e.u.image.w = w;
+        e.u.image.h = h;
+        e.u.image.stride = w * 2;
+        e.u.image.cf = LV_COLOR_FORMAT_RGB565;
+    }
+
+    // One 8x8 1 bpp glyph for 'A', a filled box.
+    void font(const char *name)
+    {
+        asset_font_header_t fh = {};
+        fh.glyph_count = 2;
+        fh.cmap_num = 1;
+        fh.glyph_dsc_ofs = sizeof(fh);
+        fh.cmaps_ofs = fh.glyph_dsc_ofs + 2 * sizeof(lv_font_fmt_txt_glyph_dsc_t);
+        fh.bitmap_ofs = fh.cmaps_ofs + sizeof(asset_font_cmap_t);
+
+        lv_font_fmt_txt_glyph_dsc_t g[2] = {};
+        g[1].bitmap_index = 0;
+        g[1].adv_w = (kGlyphW + 1) * 16;
+        g[1].box_w = kGlyphW;
+        g[1].box_h = kGlyphH;
+        asset_font_cmap_t c = {};
+        c.range_start = 'A';
+        c.range_length = 1;
+        c.glyph_id_start = 1;
+        c.type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY;
+
+        std::vector<uint8_t> blob(fh.bitmap_ofs + kGlyphH, 0xFF);
+        memcpy(blob.data(), &fh, sizeof(fh));
+        memcpy(blob.data() + fh.glyph_dsc_ofs, g, sizeof(g));
+        memcpy(blob.data() + fh.cmaps_ofs, &c, sizeof(c));
+        asset_pack_entry_t &e = add(name, ASSET_FONT, blob);
+        e.u.font.line_height = kGlyphH;
+        e.u.font.bpp = 1;
+        e.u.font.bitmap_format = LV_FONT_FMT_TXT_PLAIN;
+    }
+
+    std::vector<uint8_t> build()
+    {
+        asset_pack_header_t h = {};
+        h.magic = ASSET_PACK_MAGIC;
+        h.version = ASSET_PACK_VERSION;
+        h.count = (uint16_t)entries.size();
+        uint32_t ofs = sizeof(h) + entries.size() * sizeof(asset_pack_entry_t);
+        for (size_t i = 0; i < entries.size(); i++) {
+            entries[i].offset = ofs;
+            entries[i].size = (uint32_t)blobs[i].size();
+            entries[i].crc32 = crc32_update(0, blobs[i].data(), blobs[i].size());
+            ofs += entries[i].size;
+        }
+        h.total_bytes = ofs;
+        h.crc32 = crc32_update(0, (const uint8_t *)entries.data(), entries.size() * sizeof(asset_pack_entry_t));
+
+        std::vector<uint8_t> out((const uint8_t *)&h, (const uint8_t *)(&h + 1));
+        out.insert(out.end(), (const uint8_t *)entries.data(), (const uint8_t *)(entries.data() + entries.size()));
+        for (const auto &b : blobs) out.insert(out.end(), b.begin(), b.end());
+        return out;
+    }
+};
+
+static const uint8_t *s_map;
+static size_t s_map_len;
+
+// Writes `pack` to a temp file and maps it read-only, like the partition.
+static const uint8_t *map_pack(const std::vector<uint8_t> &pack)
+{
+    char path[] = "/tmp/asset_pack_XXXXXX";
+    int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    unlink(path);
+    TEST_ASSERT_EQUAL((ssize_t)pack.size(), write(fd, pack.data(), pack.size()));
+    void *p = mmap(NULL, pack.size(), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    TEST_ASSERT_TRUE(p != MAP_FAILED);
+    s_map = (const uint8_t *)p;
+    s_map_len = pack.size();
+    return s_map;
+}
+
+static bool in_map(const void *p)
+{
+    return (const uint8_t *)p >= s_map && (const uint8_t *)p < s_map + s_map_len;
+}
+
+void setUp(void) {}
+
+void tearDown(void)
+{
+    if (s_map) munmap((void *)s_map, s_map_len);
+    s_map = nullptr;
+}
+
+static void test_assets_are_used_in_place(void)
+{
+    PackBuilder b;
+    b.font("Euro60");
+    b.image("settings", 4, 3, 0x5A);
+    const std::vector<uint8_t> pack = b.build();
+    TEST_ASSERT_TRUE(asset_pack_open(map_pack(pack), pack.size()));
+
+    const lv_image_dsc_t *img = asset_pack_image("settings");
+    TEST_ASSERT_NOT_NULL(img);
+    TEST_ASSERT_EQUAL(4, img->header.w);
+    TEST_ASSERT_EQUAL(3, img->header.h);
+    TEST_ASSERT_EQUAL(LV_COLOR_FORMAT_RGB565, img->header.cf);
+    TEST_ASSERT_TRUE(in_map(img->data));
+    TEST_ASSERT_EQUAL_HEX8(0x5A, img->data[0]);
+    TEST_ASSERT_EQUAL_PTR(img, asset_pack_image("settings"));
+
+    const lv_font_t *font = asset_pack_font("Euro60");
+    TEST_ASSERT_NOT_NULL(font);
+    TEST_ASSERT_EQUAL_PTR(font, asset_pack_font("Euro60"));
+    TEST_ASSERT_EQUAL(kGlyphH, font->line_height);
+    lv_font_glyph_dsc_t g;
+    TEST_ASSERT_TRUE(lv_font_get_glyph_dsc(font, &g, 'A', 0));
+    TEST_ASSERT_EQUAL(kGlyphW, g.box_w);
+    TEST_ASSERT_EQUAL(kGlyphH, g.box_h);
+    TEST_ASSERT_EQUAL(kGlyphW + 1, g.adv_w);
+    TEST_ASSERT_FALSE(lv_font_get_glyph_dsc(font, &g, 'B', 0));
+    const lv_font_fmt_txt_dsc_t *d = (const lv_font_fmt_txt_dsc_t *)font->dsc;
+    TEST_ASSERT_TRUE(in_map(d->glyph_bitmap));
+    TEST_ASSERT_TRUE(in_map(d->glyph_dsc));
+
+    // Wrong type or name.
+    TEST_ASSERT_NULL(asset_pack_font("settings"));
+    TEST_ASSERT_NULL(asset_pack_image("missing"));
+
+    asset_pack_stats_t st;
+    asset_pack_get_stats(&st);
+    TEST_ASSERT_EQUAL(pack.size(), st.pack_bytes);
+    TEST_ASSERT_EQUAL(2, st.entries);
+    TEST_ASSERT_EQUAL(1, st.fonts);
+    TEST_ASSERT_EQUAL(1, st.images);
+    TEST_ASSERT_EQUAL(0, st.bad);
+}
+
+static void test_full_pool_returns_null(void)
+{
+    PackBuilder b;
+    for (int i = 0; i <= ASSET_PACK_MAX_IMAGES; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "img%d", i);
+        b.image(name, 1, 1, (uint8_t)i);
+    }
+    const std::vector<uint8_t> pack = b.build();
+    TEST_ASSERT_TRUE(asset_pack_open(map_pack(pack), pack.size()));
+
+    for (int i = 0; i < ASSET_PACK_MAX_IMAGES; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "img%d", i);
+        const lv_image_dsc_t *img = asset_pack_image(name);
+        TEST_ASSERT_NOT_NULL(img);
+        TEST_ASSERT_EQUAL_HEX8(i, img->data[0]);
+    }
+    // The blob is fine, there is just no descriptor left for it, however
+    // often it is asked for.
+    char last[16];
+    snprintf(last, sizeof(last), "img%d", ASSET_PACK_MAX_IMAGES);
+    TEST_ASSERT_NULL(asset_pack_image(last));
+    TEST_ASSERT_NULL(asset_pack_image(last));
+    TEST_ASSERT_EQUAL_HEX8(0, asset_pack_image("img0")->data[0]);
+
+    asset_pack_stats_t st;
+    asset_pack_get_stats(&st);
+    TEST_ASSERT_EQUAL(ASSET_PACK_MAX_IMAGES, st.images);
+    TEST_ASSERT_EQUAL(0, st.bad);
+}
+
+static void test_corrupt_blob_is_rejected(void)
+{
+    PackBuilder b;
+    b.image("good", 2, 2, 0x11);
+    b.image("bad", 2, 2, 0x22);
+    std::vector<uint8_t> pack = b.build();
+    pack[b.entries[1].offset] ^= 0xFF;
+    TEST_ASSERT_TRUE(asset_pack_open(map_pack(pack), pack.size()));
+
+    TEST_ASSERT_NOT_NULL(asset_pack_image("good"));
+    TEST_ASSERT_NULL(asset_pack_image("bad"));
+    TEST_ASSERT_NULL(asset_pack_image("bad"));
+    asset_pack_stats_t st;
+    asset_pack_get_stats(&st);
+    TEST_ASSERT_EQUAL(1, st.bad);
+}
+
+static void test_bad_entry_table_mounts_nothing(void)
+{
+    PackBuilder b;
+    b.image("settings", 2, 2, 0x33);
+    std::vector<uint8_t> pack = b.build();
+    pack[sizeof(asset_pack_header_t)] ^= 1;   // first byte of the entry table
+    TEST_ASSERT_FALSE(asset_pack_open(map_pack(pack), pack.size()));
+    TEST_ASSERT_NULL(asset_pack_image("settings"));
+
+    asset_pack_stats_t st;
+    asset_pack_get_stats(&st);
+    TEST_ASSERT_EQUAL(0, st.pack_bytes);
+}
+
+int main(void)
+{
+    lv_init();
+    UNITY_BEGIN();
+    RUN_TEST(test_assets_are_used_in_place);
+    RUN_TEST(test_full_pool_returns_null);
+    RUN_TEST(test_corrupt_blob_is_rejected);
+    RUN_TEST(test_bad_entry_table_mounts_nothing);
+    return UNITY_END();
+}
@@ -0,0 +1,172 @@
+// Host test for the ride logger's block writer over a RAM-backed file
+// system (test/host/FS.h). The task-owned functions are driven directly.
+//   pio test -e native -f test_ride_log
+
+#include <unity.h>
+
+#include "ride_log.cpp"
+
+// The logger task isn't run; the hub is only linked against.
+extern "C" void hub_reader_init(hub_reader_t *, hub_channel_t, uint32_t) {}
+extern "C" bool hub_read_next(hub_reader_t *, void *, uint32_t *) { return false; }
+
+static const std::vector<uint8_t> &file_data(const char *path)
+{
+    return *fs::g_ramfs.files.at(path);
+}
+
+// Checks the file the way extras/ride_log.py reads it and returns the
+// number of blocks before the first bad one.
+static int valid_blocks(const char *path)
+{
+    const std::vector<uint8_t> &d = file_data(path);
+    ride_log_file_header_t fh;
+    TEST_ASSERT_TRUE(d.size() >= sizeof(fh));
+    memcpy(&fh, d.data(), sizeof(fh));
+    TEST_ASSERT_EQUAL_HEX32(RIDE_LOG_MAGIC, fh.magic);
+    TEST_ASSERT_EQUAL(RIDE_LOG_BLOCK_BYTES, fh.block_bytes);
+
+    int n = 0;
+    for (size_t off = sizeof(fh); off + RIDE_LOG_BLOCK_BYTES <= d.size(); off += RIDE_LOG_BLOCK_BYTES, n++) {
+        ride_log_block_header_t h;
+        memcpy(&h, d.data() + off, sizeof(h));
+        if (h.magic != RIDE_LOG_BLOCK_MAGIC || h.seq != (uint32_t)n) break;
+        uint8_t blk[RIDE_LOG_BLOCK_BYTES];
+        memcpy(blk, d.data() + off, sizeof(blk));
+        ride_log_block_header_t z = h;
+        z.crc32 = 0;
+        memcpy(blk, &z, sizeof(z));
+        if (crc32_update(0, blk, sizeof(h) + h.payload_bytes) != h.crc32) break;
+    }
+    return n;
+}
+
+static void log_samples(int count)
+{
+    vesc_snapshot_t v = {};
+    v.connected = true;
+    for (int i = 0; i < count; i++) {
+        g_host_ms += 20;
+        v.speed_dkmh = i;
+        log_vesc(v, g_host_ms);
+    }
+}
+
+static void create_ride(int idx, size_t bytes)
+{
+    char path[24];
+    snprintf(path, sizeof(path), "%s/%04d.rlg", kDir, idx);
+    LittleFS.open(path, FILE_WRITE).write(std::vector<uint8_t>(bytes, 0xAA).data(), bytes);
+}
+
+void setUp(void)
+{
+    fs::g_ramfs = fs::RamFsState();
+    s_stats = {};
+    s_block_records = 0;
+    g_host_ms = 1000;
+}
+
+void tearDown(void)
+{
+    if (s_file) s_file.close();
+}
+
+static void test_blocks_follow_the_header(void)
+{
+    TEST_ASSERT_TRUE(open_file());
+    TEST_ASSERT_EQUAL_STRING("/rides/0000.rlg", s_stats.path);
+    log_samples(500);
+    close_file();
+
+    const size_t blocks = s_stats.blocks_written;
+    TEST_ASSERT_TRUE(blocks >= 4);
+    TEST_ASSERT_EQUAL(500, s_stats.records);
+    TEST_ASSERT_EQUAL(sizeof(ride_log_file_header_t) + blocks * RIDE_LOG_BLOCK_BYTES, file_data(s_stats.path).size());
+    TEST_ASSERT_EQUAL((int)blocks, valid_blocks(s_stats.path));
+    TEST_ASSERT_EQUAL(blocks, fs::g_ramfs.flushes);
+}
+
+static void test_short_write_rewinds_to_the_block_boundary(void)
+{
+    TEST_ASSERT_TRUE(open_file());
+    log_samples(250);
+    const uint32_t before = s_stats.blocks_written;
+    TEST_ASSERT_TRUE(before >= 1);
+
+    // The next block only half lands.
+    fs::g_ramfs.write_budget = RIDE_LOG_BLOCK_BYTES / 2;
+    while (s_stats.write_errors == 0) log_samples(1);
+    fs::g_ramfs.write_budget = -1;
+    TEST_ASSERT_EQUAL(before, s_stats.blocks_written);
+    TEST_ASSERT_EQUAL(sizeof(ride_log_file_header_t) + before * RIDE_LOG_BLOCK_BYTES, s_file.position());
+
+    log_samples(250);
+    close_file();
+    TEST_ASSERT_TRUE(s_stats.blocks_written > before);
+    TEST_ASSERT_EQUAL((int)s_stats.blocks_written, valid_blocks(s_stats.path));
+    TEST_ASSERT_EQUAL(sizeof(ride_log_file_header_t) + s_stats.blocks_written * RIDE_LOG_BLOCK_BYTES,
+                      file_data(s_stats.path).size());
+}
+
+static void test_open_prunes_oldest_rides(void)
+{
+    for (int i = 3; i < 3 + kMaxFiles; i++) create_ride(i, 100);
+    TEST_ASSERT_TRUE(open_file());
+    TEST_ASSERT_EQUAL_STRING("/rides/0053.rlg", s_stats.path);
+    TEST_ASSERT_FALSE(LittleFS.exists("/rides/0003.rlg"));
+    TEST_ASSERT_TRUE(LittleFS.exists("/rides/0004.rlg"));
+    TEST_ASSERT_EQUAL(kMaxFiles, fs::g_ramfs.files.size());
+}
+
+static void test_long_ride_prunes_while_logging(void)
+{
+    // 64 blocks of space, half of it taken by two older rides.
+    fs::g_ramfs.total_bytes = 64 * 4096;
+    create_ride(1, 16 * 4096);
+    create_ride(2, 16 * 4096);
+    TEST_ASSERT_TRUE(open_file());
+    TEST_ASSERT_EQUAL_STRING("/rides/0003.rlg", s_stats.path);
+
+    // Well past what fits next to the old rides.
+    while (s_stats.blocks_written < 40) log_samples(100);
+    TEST_ASSERT_EQUAL(0, s_stats.write_errors);
+    TEST_ASSERT_FALSE(LittleFS.exists("/rides/0001.rlg"));
+    TEST_ASSERT_FALSE(LittleFS.exists("/rides/0002.rlg"));
+    TEST_ASSERT_TRUE(LittleFS.exists("/rides/0003.rlg"));
+
+    // Once it's the only ride left, it is never pruned itself.
+    while (s_stats.blocks_written < 60) log_samples(100);
+    TEST_ASSERT_TRUE(LittleFS.exists("/rides/0003.rlg"));
+    close_file();
+    TEST_ASSERT_EQUAL((int)s_stats.blocks_written, valid_blocks("/rides/0003.rlg"));
+}
+
+static void test_full_fs_between_checks_prunes_on_failure(void)
+{
+    // 32 blocks, 26 taken: not over the prune level when the ride opens,
+    // and full a few blocks in, before the next periodic fill check.
+    fs::g_ramfs.total_bytes = 32 * 4096;
+    create_ride(1, 13 * 4096);
+    create_ride(2, 13 * 4096);
+    TEST_ASSERT_TRUE(open_file());
+    TEST_ASSERT_EQUAL_STRING("/rides/0003.rlg", s_stats.path);
+
+    for (int i = 0; i < 100 && s_stats.blocks_written < 12; i++) log_samples(100);
+    TEST_ASSERT_EQUAL(12, s_stats.blocks_written);
+    TEST_ASSERT_EQUAL(0, s_stats.write_errors);
+    TEST_ASSERT_FALSE(LittleFS.exists("/rides/0001.rlg"));
+    close_file();
+    TEST_ASSERT_EQUAL((int)s_stats.blocks_written, valid_blocks("/rides/0003.rlg"));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_blocks_follow_the_header);
+    RUN_TEST(test_short_write_rewinds_to_the_block_boundary);
+    RUN_TEST(test_open_prunes_oldest_rides);
+    RUN_TEST(test_long_ride_prunes_while_logging);
+    RUN_TEST(test_full_fs_between_checks_prunes_on_failure);
+    return UNITY_END();
+}
@@ -0,0 +1,284 @@
+// Host test for the VESC UART client: the client talks through a real
+// pseudo-terminal to a scripted controller on the master side.
+//   pio test -e native -f test_vesc_uart
+
+#include <unity.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+
+#include "vesc_packet.cpp"
+#include "vesc_values.cpp"
+#include "vesc_uart_client.cpp"
+
+using namespace vesc;
+
+static uint32_t mono_ms() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+// The firmware's Transport wraps a HardwareSerial; this one the pty slave.
+class PtyTransport : public Transport {
+ public:
+  explicit PtyTransport(int fd) : fd_(fd) {}
+
+  size_t write(const uint8_t *data, size_t len) override {
+    ssize_t n = ::write(fd_, data, len);
+    return n < 0 ? 0 : (size_t)n;
+  }
+
+  size_t read(uint8_t *data, size_t cap, uint32_t timeout_ms) override {
+    pollfd p = {fd_, POLLIN, 0};
+    if (poll(&p, 1, (int)timeout_ms) <= 0) return 0;
+    ssize_t n = ::read(fd_, data, cap);
+    return n < 0 ? 0 : (size_t)n;
+  }
+
+  void discard_input() override { tcflush(fd_, TCIFLUSH); }
+  uint32_t now_ms() override { return mono_ms(); }
+
+ private:
+  int fd_;
+};
+
+enum class Mode : uint8_t {
+  SELECTIVE,  // current firmware
+  FULL_ONLY,  // firmware that ignores COMM_GET_VALUES_SELECTIVE
+  SILENT,     // link down
+};
+
+// Controller side. Node 0 is the local controller, nodes 1.. answer
+// COMM_FORWARD_CAN to their id. Replies to a pipelined round go out in
+// reverse order so the client has to match them by controller_id.
+struct Controller {
+  static constexpr uint8_t kLocalId = 7;
+  static constexpr uint8_t kCanIds[2] = {20, 21};
+
+  int fd = -1;
+  std::atomic<Mode> mode{Mode::SELECTIVE};
+  std::atomic<bool> stop{false};
+  std::atomic<uint32_t> selective_requests{0};
+  std::atomic<uint32_t> full_requests{0};
+  std::thread thread;
+
+  void start(int master_fd) {
+    fd = master_fd;
+    thread = std::thread([this] { run(); });
+  }
+
+  void join() {
+    stop = true;
+    thread.join();
+  }
+
+  static void put_fields(BufferWriter &w, uint32_t mask, uint8_t id) {
+    auto i16 = [&](int16_t v) { w.u16((uint16_t)v); };
+    auto i32 = [&](int32_t v) { w.u32((uint32_t)v); };
+    if (mask & kMaskTempFet) i16(315);
+    if (mask & kMaskTempMotor) i16(402);
+    if (mask & kMaskCurrentMotor) i32(-1250);
+    if (mask & kMaskCurrentIn) i32(830);
+    if (mask & kMaskId) i32(0);
+    if (mask & kMaskIq) i32(0);
+    if (mask & kMaskDuty) i16(455);
+    if (mask & kMaskRpm) i32(12000 + id);
+    if (mask & kMaskVIn) i16(504);
+    if (mask & kMaskAh) i32(0);
+    if (mask & kMaskAhCharged) i32(0);
+    if (mask & kMaskWh) i32(0);
+    if (mask & kMaskWhCharged) i32(0);
+    if (mask & kMaskTach) i32(0);
+    if (mask & kMaskTachAbs) i32(98765);
+    if (mask & kMaskFault) w.u8(0);
+    if (mask & kMaskPidPos) i32(0);
+    if (mask & kMaskControllerId) w.u8(id);
+    if (mask & kMaskTempMos) {
+      for (int i = 0; i < 3; i++) i16(300);
+    }
+    if (mask & kMaskVd) i32(0);
+    if (mask & kMaskVq) i32(0);
+  }
+
+  // Reply payload for one request, 0 if this controller stays quiet.
+  size_t answer(const uint8_t *req, size_t len, uint8_t *out, size_t cap) {
+    uint8_t id = kLocalId;
+    if (len >= 2 && req[0] == kCommForwardCan) {
+      id = req[1];
+      req += 2;
+      len -= 2;
+    }
+    if (len < 1) return 0;
+    BufferWriter w(out, cap);
+    if (req[0] == kCommGetValuesSelective && len >= 5) {
+      selective_requests++;
+      if (mode != Mode::SELECTIVE) return 0;
+      uint32_t mask = (uint32_t)req[1] << 24 | (uint32_t)req[2] << 16 | (uint32_t)req[3] << 8 | req[4];
+      w.u8(kCommGetValuesSelective);
+      w.u32(mask);
+      put_fields(w, mask, id);
+    } else if (req[0] == kCommGetValues) {
+      full_requests++;
+      if (mode == Mode::SILENT) return 0;
+      w.u8(kCommGetValues);
+      put_fields(w, 0x1fffffu, id);
+    } else {
+      return 0;
+    }
+    return w.ok() ? w.len() : 0;
+  }
+
+  void run() {
+    PacketDecoder dec;
+    uint8_t frames[4][128];
+    size_t frame_len[4];
+    int pending = 0;
+    while (!stop) {
+      pollfd p = {fd, POLLIN, 0};
+      int r = poll(&p, 1, 2);
+      if (r > 0) {
+        uint8_t buf[256];
+        ssize_t n = ::read(fd, buf, sizeof(buf));
+        for (ssize_t i = 0; i < n; i++) {
+          if (dec.push(buf[i]) != PacketDecoder::Result::PACKET) continue;
+          uint8_t reply[128];
+          size_t len = answer(dec.payload(), dec.payload_len(), reply, sizeof(reply));
+          if (len == 0 || pending == 4) continue;
+          frame_len[pending] = encode_packet(reply, len, frames[pending], sizeof(frames[pending]));
+          pending++;
+        }
+        if (n > 0) continue;  // collect the rest of a pipelined round
+      }
+      while (pending > 0) {
+        pending--;
+        (void)!::write(fd, frames[pending], frame_len[pending]);
+      }
+    }
+  }
+};
+
+constexpr uint8_t Controller::kCanIds[2];
+
+static int s_master = -1;
+static int s_slave = -1;
+static Controller *s_ctl;
+static PtyTransport *s_io;
+static VescUartClient *s_client;
+
+void setUp(void) {
+  s_master = posix_openpt(O_RDWR | O_NOCTTY);
+  TEST_ASSERT_TRUE(s_master >= 0);
+  TEST_ASSERT_EQUAL(0, grantpt(s_master));
+  TEST_ASSERT_EQUAL(0, unlockpt(s_master));
+  s_slave = open(ptsname(s_master), O_RDWR | O_NOCTTY);
+  TEST_ASSERT_TRUE(s_slave >= 0);
+
+  // Binary link, as the UART is.
+  termios t;
+  tcgetattr(s_slave, &t);
+  cfmakeraw(&t);
+  tcsetattr(s_slave, TCSANOW, &t);
+  tcgetattr(s_master, &t);
+  cfmakeraw(&t);
+  tcsetattr(s_master, TCSANOW, &t);
+
+  s_ctl = new Controller();
+  s_ctl->start(s_master);
+  s_io = new PtyTransport(s_slave);
+  s_client = new VescUartClient(*s_io);
+}
+
+void tearDown(void) {
+  s_ctl->join();
+  delete s_client;
+  delete s_io;
+  delete s_ctl;
+  close(s_slave);
+  close(s_master);
+}
+
+static void test_selective_poll(void) {
+  Values v;
+  TEST_ASSERT_TRUE(s_client->poll_values(&v, 200));
+  TEST_ASSERT_EQUAL_UINT32(kMaskDashboard, v.mask);
+  TEST_ASSERT_EQUAL_INT16(315, v.temp_fet_dc);
+  TEST_ASSERT_EQUAL_INT32(-1250, v.current_motor_ca);
+  TEST_ASSERT_EQUAL_INT16(455, v.duty_pm);
+  TEST_ASSERT_EQUAL_INT32(12000 + Controller::kLocalId, v.erpm);
+  TEST_ASSERT_EQUAL_INT16(504, v.v_in_dv);
+  TEST_ASSERT_EQUAL_INT32(98765, v.tachometer_abs);
+  TEST_ASSERT_EQUAL_UINT32(1, s_ctl->selective_requests.load());
+  TEST_ASSERT_EQUAL_UINT32(0, s_ctl->full_requests.load());
+  TEST_ASSERT_EQUAL_UINT32(1, s_client->stats().replies);
+}
+
+static void test_round_matches_nodes_by_id(void) {
+  Values out[3];
+  uint32_t got = s_client->poll_round(Controller::kCanIds, 2, out, 200);
+  TEST_ASSERT_EQUAL_HEX32(0x7, got);
+  TEST_ASSERT_EQUAL_UINT8(Controller::kLocalId, out[0].controller_id);
+  TEST_ASSERT_EQUAL_INT32(12000 + Controller::kLocalId, out[0].erpm);
+  for (int i = 0; i < 2; i++) {
+    TEST_ASSERT_EQUAL_UINT8(Controller::kCanIds[i], out[1 + i].controller_id);
+    TEST_ASSERT_EQUAL_INT32(12000 + Controller::kCanIds[i], out[1 + i].erpm);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, s_client->stats().timeouts);
+}
+
+static void test_old_firmware_falls_back_to_full(void) {
+  s_ctl->mode = Mode::FULL_ONLY;
+  Values v;
+  for (int i = 0; i < 3; i++) TEST_ASSERT_FALSE(s_client->poll_values(&v, 30));
+  TEST_ASSERT_TRUE(s_client->poll_values(&v, 200));
+  TEST_ASSERT_TRUE(v.mask & kMaskVq);
+  TEST_ASSERT_EQUAL_INT32(98765, v.tachometer_abs);
+  TEST_ASSERT_EQUAL_UINT32(3, s_ctl->selective_requests.load());
+  TEST_ASSERT_EQUAL_UINT32(1, s_ctl->full_requests.load());
+}
+
+static void test_selective_resumes_after_link_recovery(void) {
+  // A dead link looks like old firmware until the controller answers again.
+  s_ctl->mode = Mode::SILENT;
+  Values v;
+  for (int i = 0; i < 5; i++) TEST_ASSERT_FALSE(s_client->poll_values(&v, 30));
+  TEST_ASSERT_EQUAL_UINT32(2, s_ctl->full_requests.load());
+
+  s_ctl->mode = Mode::SELECTIVE;
+  TEST_ASSERT_TRUE(s_client->poll_values(&v, 200));
+  TEST_ASSERT_TRUE(v.mask & kMaskVq);  // still the full reply
+  TEST_ASSERT_TRUE(s_client->poll_values(&v, 200));
+  TEST_ASSERT_EQUAL_UINT32(kMaskDashboard, v.mask);
+  TEST_ASSERT_EQUAL_UINT32(4, s_ctl->selective_requests.load());
+}
+
+static void test_selective_is_probed_again(void) {
+  s_ctl->mode = Mode::FULL_ONLY;
+  Values v;
+  for (int i = 0; i < 3; i++) TEST_ASSERT_FALSE(s_client->poll_values(&v, 30));
+  for (int i = 0; i < 500; i++) TEST_ASSERT_TRUE(s_client->poll_values(&v, 200));
+  TEST_ASSERT_EQUAL_UINT32(3, s_ctl->selective_requests.load());
+
+  // One probe, and a single miss goes straight back to full replies.
+  TEST_ASSERT_FALSE(s_client->poll_values(&v, 30));
+  TEST_ASSERT_EQUAL_UINT32(4, s_ctl->selective_requests.load());
+  TEST_ASSERT_TRUE(s_client->poll_values(&v, 200));
+  TEST_ASSERT_EQUAL_UINT32(4, s_ctl->selective_requests.load());
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_selective_poll);
+  RUN_TEST(test_round_matches_nodes_by_id);
+  RUN_TEST(test_old_firmware_falls_back_to_full);
+  RUN_TEST(test_selective_resumes_after_link_recovery);
+  RUN_TEST(test_selective_is_probed_again);
+  return UNITY_END();
+}